@@ -0,0 +1,251 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#include "corpus.h"
+#include <cstdio>
+using namespace ByteDance;
+
+//-----------------------------------------------------------------
+// xorshift64*: small, fast and identical on every platform
+class _BenchRandom {
+public:
+    explicit _BenchRandom(uint64_t a_iSeed) : _iState(a_iSeed ? a_iSeed : 0x9E3779B97F4A7C15ULL) {}
+    uint64_t next() {
+        _iState ^= _iState >> 12;
+        _iState ^= _iState << 25;
+        _iState ^= _iState >> 27;
+        return _iState * 2685821657736338717ULL;
+    }
+    uint32_t below(uint32_t a_iLimit) { return static_cast<uint32_t>(next() % a_iLimit); }
+private:
+    uint64_t _iState;
+};
+//-----------------------------------------------------------------
+static void _AppendInt(std::string& a_rOut, _BenchRandom& a_rRandom, int a_iRange) {
+    char buf[16];
+    int64_t iSpan = 2 * static_cast<int64_t>(a_iRange);
+    int iValue = static_cast<int>(static_cast<int64_t>(a_rRandom.next() % iSpan) - a_iRange);
+    snprintf(buf, sizeof(buf), "%d", iValue);
+    a_rOut += buf;
+}
+//-----------------------------------------------------------------
+static void _AppendFloat(std::string& a_rOut, _BenchRandom& a_rRandom) {
+    char buf[32];
+    double fValue = (static_cast<double>(a_rRandom.below(2000000)) - 1000000.0) / 1000.0;
+    snprintf(buf, sizeof(buf), "%.3f", fValue);
+    a_rOut += buf;
+}
+//-----------------------------------------------------------------
+static void _AppendWord(std::string& a_rOut, _BenchRandom& a_rRandom, size_t a_iMin, size_t a_iMax) {
+    static const char kAlphabet[] = "abcdefghijklmnopqrstuvwxyzABCDEFGHIJKLMNOPQRSTUVWXYZ0123456789";
+    size_t iLength = a_iMin + a_rRandom.below(static_cast<uint32_t>(a_iMax - a_iMin + 1));
+    for(size_t i = 0; i < iLength; ++i) {
+        a_rOut += kAlphabet[a_rRandom.below(sizeof(kAlphabet) - 1)];
+    }
+}
+//-----------------------------------------------------------------
+static void _AppendText(std::string& a_rOut, _BenchRandom& a_rRandom, size_t a_iWords) {
+    a_rOut += '\"';
+    for(size_t i = 0; i < a_iWords; ++i) {
+        if(i) {
+            a_rOut += ' ';
+        }
+        _AppendWord(a_rOut, a_rRandom, 2, 10);
+        if(0 == a_rRandom.below(16)) {
+            a_rOut += "\\n"; // a few escapes, kept raw by the parser
+        }
+    }
+    a_rOut += '\"';
+}
+//-----------------------------------------------------------------
+static void _AppendKey(std::string& a_rOut, const char* aKey) {
+    a_rOut += '\"';
+    a_rOut += aKey;
+    a_rOut += "\":";
+}
+//-----------------------------------------------------------------
+// [1,-2.5,3,...]
+static void _FlatNumbers(std::string& a_rOut, _BenchRandom& a_rRandom, size_t a_iTargetBytes) {
+    a_rOut += '[';
+    for(size_t i = 0; a_rOut.size() < a_iTargetBytes; ++i) {
+        if(i) {
+            a_rOut += ',';
+        }
+        if(a_rRandom.below(2)) {
+            _AppendInt(a_rOut, a_rRandom, 1000000);
+        } else {
+            _AppendFloat(a_rOut, a_rRandom);
+        }
+    }
+    a_rOut += ']';
+}
+//-----------------------------------------------------------------
+// Repeated chains of objects/arrays nested kDepth levels deep
+static void _DeepNesting(std::string& a_rOut, _BenchRandom& a_rRandom, size_t a_iTargetBytes) {
+    const int kDepth = 64;
+    a_rOut += '[';
+    for(size_t i = 0; a_rOut.size() < a_iTargetBytes; ++i) {
+        if(i) {
+            a_rOut += ',';
+        }
+        std::string sClose;
+        for(int d = 0; d < kDepth; ++d) {
+            if(d % 2) {
+                a_rOut += '[';
+                sClose += ']';
+            } else {
+                a_rOut += "{\"n\":";
+                sClose += '}';
+            }
+        }
+        _AppendInt(a_rOut, a_rRandom, 1000);
+        a_rOut.append(sClose.rbegin(), sClose.rend());
+    }
+    a_rOut += ']';
+}
+//-----------------------------------------------------------------
+// Long string values
+static void _StringHeavy(std::string& a_rOut, _BenchRandom& a_rRandom, size_t a_iTargetBytes) {
+    a_rOut += '[';
+    for(size_t i = 0; a_rOut.size() < a_iTargetBytes; ++i) {
+        if(i) {
+            a_rOut += ',';
+        }
+        _AppendText(a_rOut, a_rRandom, 8 + a_rRandom.below(64));
+    }
+    a_rOut += ']';
+}
+//-----------------------------------------------------------------
+// One object with many scalar members
+static void _WideObject(std::string& a_rOut, _BenchRandom& a_rRandom, size_t a_iTargetBytes) {
+    char aKey[32];
+    a_rOut += '{';
+    for(size_t i = 0; a_rOut.size() < a_iTargetBytes; ++i) {
+        if(i) {
+            a_rOut += ',';
+        }
+        snprintf(aKey, sizeof(aKey), "field_%zu", i);
+        _AppendKey(a_rOut, aKey);
+        switch(i % 4) {
+            case 0: _AppendInt(a_rOut, a_rRandom, 100000); break;
+            case 1: _AppendFloat(a_rOut, a_rRandom); break;
+            case 2: a_rOut += a_rRandom.below(2) ? "true" : "false"; break;
+            default: a_rOut += '\"'; _AppendWord(a_rOut, a_rRandom, 4, 16); a_rOut += '\"'; break;
+        }
+    }
+    a_rOut += '}';
+}
+//-----------------------------------------------------------------
+// Timeline of status objects with nested user/entities
+static void _Twitter(std::string& a_rOut, _BenchRandom& a_rRandom, size_t a_iTargetBytes) {
+    a_rOut += "{\"statuses\":[";
+    for(size_t i = 0; a_rOut.size() < a_iTargetBytes; ++i) {
+        if(i) {
+            a_rOut += ',';
+        }
+        a_rOut += '{';
+        _AppendKey(a_rOut, "id"); _AppendInt(a_rOut, a_rRandom, 2000000000); a_rOut += ',';
+        _AppendKey(a_rOut, "text"); _AppendText(a_rOut, a_rRandom, 6 + a_rRandom.below(20)); a_rOut += ',';
+        _AppendKey(a_rOut, "truncated"); a_rOut += "false,";
+        _AppendKey(a_rOut, "in_reply_to"); a_rOut += "null,";
+        _AppendKey(a_rOut, "user"); a_rOut += '{';
+        _AppendKey(a_rOut, "id"); _AppendInt(a_rOut, a_rRandom, 2000000000); a_rOut += ',';
+        _AppendKey(a_rOut, "screen_name"); a_rOut += '\"'; _AppendWord(a_rOut, a_rRandom, 4, 15); a_rOut += "\",";
+        _AppendKey(a_rOut, "followers_count"); _AppendInt(a_rOut, a_rRandom, 100000); a_rOut += ',';
+        _AppendKey(a_rOut, "verified"); a_rOut += a_rRandom.below(8) ? "false" : "true";
+        a_rOut += "},";
+        _AppendKey(a_rOut, "entities"); a_rOut += '{';
+        _AppendKey(a_rOut, "hashtags"); a_rOut += '[';
+        for(uint32_t h = 0, n = a_rRandom.below(4); h < n; ++h) {
+            a_rOut += h ? ",\"" : "\"";
+            _AppendWord(a_rOut, a_rRandom, 3, 12);
+            a_rOut += '\"';
+        }
+        a_rOut += "]},";
+        _AppendKey(a_rOut, "retweet_count"); _AppendInt(a_rOut, a_rRandom, 5000); a_rOut += ',';
+        _AppendKey(a_rOut, "score"); _AppendFloat(a_rOut, a_rRandom);
+        a_rOut += '}';
+    }
+    a_rOut += "],\"search_metadata\":{\"count\":100,\"completed_in\":0.087}}";
+}
+//-----------------------------------------------------------------
+// Product catalog: objects with price arrays and attribute maps
+static void _Catalog(std::string& a_rOut, _BenchRandom& a_rRandom, size_t a_iTargetBytes) {
+    a_rOut += "{\"products\":[";
+    for(size_t i = 0; a_rOut.size() < a_iTargetBytes; ++i) {
+        if(i) {
+            a_rOut += ',';
+        }
+        a_rOut += '{';
+        _AppendKey(a_rOut, "sku"); a_rOut += '\"'; _AppendWord(a_rOut, a_rRandom, 10, 10); a_rOut += "\",";
+        _AppendKey(a_rOut, "name"); _AppendText(a_rOut, a_rRandom, 2 + a_rRandom.below(5)); a_rOut += ',';
+        _AppendKey(a_rOut, "stock"); _AppendInt(a_rOut, a_rRandom, 1000); a_rOut += ',';
+        _AppendKey(a_rOut, "available"); a_rOut += a_rRandom.below(2) ? "true," : "false,";
+        _AppendKey(a_rOut, "prices"); a_rOut += '[';
+        for(uint32_t p = 0, n = 1 + a_rRandom.below(6); p < n; ++p) {
+            if(p) {
+                a_rOut += ',';
+            }
+            _AppendFloat(a_rOut, a_rRandom);
+        }
+        a_rOut += "],";
+        _AppendKey(a_rOut, "attributes"); a_rOut += '{';
+        for(uint32_t a = 0, n = 1 + a_rRandom.below(5); a < n; ++a) {
+            a_rOut += a ? ",\"" : "\"";
+            _AppendWord(a_rOut, a_rRandom, 3, 8);
+            a_rOut += "\":\"";
+            _AppendWord(a_rOut, a_rRandom, 1, 12);
+            a_rOut += '\"';
+        }
+        a_rOut += "}}";
+    }
+    a_rOut += "]}";
+}
+//-----------------------------------------------------------------
+/*static*/
+const std::vector<std::string>& BenchCorpus::Shapes() {
+    static const std::vector<std::string> vShapes = {
+        "flat_numbers", "deep_nesting", "string_heavy", "wide_object", "twitter", "catalog"
+    };
+    return vShapes;
+}
+//-----------------------------------------------------------------
+/*static*/
+bool BenchCorpus::Generate(const std::string& aShape, size_t a_iTargetBytes, uint64_t a_iSeed, BenchDocument& a_rDoc) {
+    _BenchRandom oRandom(a_iSeed);
+    a_rDoc.sShape = aShape;
+    a_rDoc.sText.clear();
+    a_rDoc.sText.reserve(a_iTargetBytes + 1024);
+    if("flat_numbers" == aShape) {
+        _FlatNumbers(a_rDoc.sText, oRandom, a_iTargetBytes);
+    } else if("deep_nesting" == aShape) {
+        _DeepNesting(a_rDoc.sText, oRandom, a_iTargetBytes);
+    } else if("string_heavy" == aShape) {
+        _StringHeavy(a_rDoc.sText, oRandom, a_iTargetBytes);
+    } else if("wide_object" == aShape) {
+        _WideObject(a_rDoc.sText, oRandom, a_iTargetBytes);
+    } else if("twitter" == aShape) {
+        _Twitter(a_rDoc.sText, oRandom, a_iTargetBytes);
+    } else if("catalog" == aShape) {
+        _Catalog(a_rDoc.sText, oRandom, a_iTargetBytes);
+    } else {
+        return false;
+    }
+    return true;
+}
+//-----------------------------------------------------------------
@@ -0,0 +1,47 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#ifndef PRAVEENJSON_BENCH_CORPUS_H
+#define PRAVEENJSON_BENCH_CORPUS_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+//
+// Deterministic benchmark corpus: the same seed and size always produce the
+// same documents, so runs on different builds are directly comparable.
+// Generated text is compact, valid JSON that the pjson parser accepts
+// (no empty strings, integers within int range).
+//
+namespace ByteDance {
+//==[Interface]============================================================
+    struct BenchDocument {
+        std::string sShape;
+        std::string sText;
+    };
+
+    class BenchCorpus {
+    public:
+        static const std::vector<std::string>& Shapes();
+        // Builds one document of the given shape, roughly a_iTargetBytes long
+        static bool Generate(const std::string& aShape, size_t a_iTargetBytes, uint64_t a_iSeed, BenchDocument& a_rDoc);
+    };
+//========================================================================
+};// end namespace ByteDance
+#endif /* !PRAVEENJSON_BENCH_CORPUS_H */
@@ -0,0 +1,385 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <new>
+#include "pjson.h"
+#include "pjson_cache.h"
+#include "pjson_cpu.h"
+#include "pjson_projection.h"
+#include "pjson_reformat.h"
+#include "pjson_validate.h"
+#include "corpus.h"
+using namespace ByteDance;
+
+//
+// pjsonbench: times the core pjson operations over a generated corpus.
+//
+//   pjsonbench [--size=BYTES] [--seed=N] [--min-time=SECONDS]
+//              [--shape=NAME[,NAME...]] [--format=json|csv]
+//
+// One op is one document, except for lookup where it is one keyed read and
+// array_read where it is one array element. pjsonbench_inline runs the same
+// ops against the PJSON_INLINE build of the library.
+// Allocations are counted through the global operator new below.
+//
+
+//-----------------------------------------------------------------
+static size_t g_iAllocations = 0;
+
+// Every form goes through one allocate / release pair, kept out of line so
+// the compiler never sees free() paired with an inlined operator new
+#if defined(_MSC_VER)
+#define PJSONBENCH_NOINLINE __declspec(noinline)
+#else
+#define PJSONBENCH_NOINLINE __attribute__((noinline))
+#endif
+PJSONBENCH_NOINLINE static void* _Allocate(size_t a_iSize) {
+    ++g_iAllocations;
+    void* p = malloc(a_iSize ? a_iSize : 1);
+    if(nullptr == p) {
+        throw std::bad_alloc();
+    }
+    return p;
+}
+PJSONBENCH_NOINLINE static void _Release(void* p) noexcept {
+    free(p);
+}
+
+void* operator new(size_t a_iSize) {
+    return _Allocate(a_iSize);
+}
+void* operator new[](size_t a_iSize) {
+    return _Allocate(a_iSize);
+}
+void operator delete(void* p) noexcept {
+    _Release(p);
+}
+void operator delete[](void* p) noexcept {
+    _Release(p);
+}
+void operator delete(void* p, size_t) noexcept {
+    _Release(p);
+}
+void operator delete[](void* p, size_t) noexcept {
+    _Release(p);
+}
+
+//-----------------------------------------------------------------
+struct BenchOptions {
+    size_t iSize = 64 * 1024;
+    uint64_t iSeed = 1;
+    double dMinTime = 0.5;
+    std::vector<std::string> vShapes;
+    bool bCsv = false;
+};
+
+struct BenchResult {
+    std::string sShape;
+    std::string sOp;
+    size_t iBytes = 0; // processed per op, 0 when throughput does not apply
+    uint64_t iOps = 0;
+    double dSeconds = 0.0;
+    size_t iAllocations = 0;
+};
+
+typedef std::chrono::steady_clock BenchClock;
+static volatile size_t g_iSink = 0; // keeps results observable
+
+//-----------------------------------------------------------------
+static double _Seconds(BenchClock::time_point aFrom, BenchClock::time_point aTo) {
+    return std::chrono::duration<double>(aTo - aFrom).count();
+}
+//-----------------------------------------------------------------
+// Runs fnOp (which performs a_iOpsPerCall ops) until dMinTime has elapsed
+template<typename F>
+static BenchResult _Measure(const BenchOptions& aOptions, const std::string& aShape, const char* aOp,
+                            size_t a_iBytes, uint64_t a_iOpsPerCall, F fnOp) {
+    fnOp(); // warm up
+    BenchResult oResult;
+    oResult.sShape = aShape;
+    oResult.sOp = aOp;
+    oResult.iBytes = a_iBytes;
+    size_t iAllocations = g_iAllocations;
+    BenchClock::time_point tStart = BenchClock::now();
+    do {
+        fnOp();
+        oResult.iOps += a_iOpsPerCall;
+        oResult.dSeconds = _Seconds(tStart, BenchClock::now());
+    } while(oResult.dSeconds < aOptions.dMinTime);
+    oResult.iAllocations = g_iAllocations - iAllocations;
+    return oResult;
+}
+//-----------------------------------------------------------------
+// Destruction needs a fresh tree per op; only the delete is timed
+static BenchResult _MeasureDestroy(const BenchOptions& aOptions, const BenchDocument& aDoc) {
+    BenchResult oResult;
+    oResult.sShape = aDoc.sShape;
+    oResult.sOp = "destroy";
+    oResult.iBytes = aDoc.sText.size();
+    BenchClock::time_point tBegin = BenchClock::now();
+    do {
+        pjson* pDoc = pjson::CreateFromString(aDoc.sText);
+        BenchClock::time_point tStart = BenchClock::now();
+        delete pDoc;
+        oResult.dSeconds += _Seconds(tStart, BenchClock::now());
+        ++oResult.iOps;
+    } while(oResult.dSeconds < aOptions.dMinTime && _Seconds(tBegin, BenchClock::now()) < 20 * aOptions.dMinTime);
+    return oResult;
+}
+//-----------------------------------------------------------------
+struct BenchLookup {
+    pjson* pMap;
+    std::string sKey;
+};
+
+// Collects up to a_iMax (map, key) pairs, breadth first
+static void _CollectLookups(pjson* aRoot, size_t a_iMax, std::vector<BenchLookup>& a_rLookups) {
+    std::vector<pjson*> vLevel(1, aRoot);
+    while(!vLevel.empty() && a_rLookups.size() < a_iMax) {
+        std::vector<pjson*> vNext;
+        for(pjson* pNode : vLevel) {
+            if(pjson::jsonMap == pNode->getType()) {
+                for(auto const& it : *pNode->getMap()) {
+                    if(a_rLookups.size() < a_iMax) {
+                        a_rLookups.push_back(BenchLookup{pNode, it.first});
+                    }
+                    vNext.push_back(it.second);
+                }
+            } else if(pjson::jsonArray == pNode->getType()) {
+                vNext.insert(vNext.end(), pNode->getArray()->begin(), pNode->getArray()->end());
+            }
+        }
+        vLevel.swap(vNext);
+    }
+}
+//-----------------------------------------------------------------
+// Collects every array in the tree and counts their elements
+static size_t _CollectArrays(const pjson* aRoot, std::vector<const pjson::PJSONARRAY*>& a_rArrays) {
+    size_t iElements = 0;
+    std::vector<const pjson*> vPending(1, aRoot);
+    while(!vPending.empty()) {
+        const pjson* pNode = vPending.back();
+        vPending.pop_back();
+        if(const pjson::PJSONARRAY* pArray = pNode->getArray()) {
+            a_rArrays.push_back(pArray);
+            iElements += pArray->size();
+            vPending.insert(vPending.end(), pArray->begin(), pArray->end());
+        } else if(const pjson::PJSONMAP* pMap = pNode->getMap()) {
+            for(auto const& it : *pMap) {
+                vPending.push_back(it.second);
+            }
+        }
+    }
+    return iElements;
+}
+//-----------------------------------------------------------------
+// One keyed lookup, then a typed read of the node it found
+static size_t _Lookup(const BenchLookup& aLookup) {
+    const pjson& rValue = static_cast<const pjson&>(*aLookup.pMap)[aLookup.sKey];
+    switch(rValue.getType()) {
+        case pjson::jsonNumberInt:   { return size_t(rValue.getInt()); }
+        case pjson::jsonNumberFloat: { return size_t(rValue.getFloat()); }
+        case pjson::jsonBoolean:     { return size_t(rValue.getBool()); }
+        case pjson::jsonString:      { return rValue.getString().size(); }
+        default:                     { return 1; }
+    }
+}
+//-----------------------------------------------------------------
+static void _RunShape(const BenchOptions& aOptions, const BenchDocument& aDoc, std::vector<BenchResult>& a_rResults) {
+    const std::string& sText = aDoc.sText;
+    pjson* pTree = pjson::CreateFromString(sText);
+    if(nullptr == pTree) {
+        std::cerr << "pjsonbench: generated " << aDoc.sShape << " document does not parse" << std::endl;
+        return;
+    }
+    const std::string sCompact = pTree->toString(false);
+    const std::string sPretty = pTree->toString(true);
+
+    a_rResults.push_back(_Measure(aOptions, aDoc.sShape, "parse", sText.size(), 1, [&]() {
+        pjson* pDoc = pjson::CreateFromString(sText);
+        g_iSink += (pDoc != nullptr);
+        delete pDoc;
+    }));
+    // a projection that keeps no field: the cost of skipping the whole input
+    const pjson::Projection oNoFields({"pjsonbench_none"});
+    a_rResults.push_back(_Measure(aOptions, aDoc.sShape, "parse_projected", sText.size(), 1, [&]() {
+        pjson* pDoc = pjson::CreateFromString(sText.c_str(), sText.size(), oNoFields);
+        g_iSink += (pDoc != nullptr);
+        delete pDoc;
+    }));
+    // parse above includes the delete; report it separately so it can be subtracted
+    a_rResults.push_back(_MeasureDestroy(aOptions, aDoc));
+    a_rResults.push_back(_Measure(aOptions, aDoc.sShape, "validate", sText.size(), 1, [&]() {
+        g_iSink += pjson::Validate(sText).iElements;
+    }));
+    a_rResults.push_back(_Measure(aOptions, aDoc.sShape, "toString", sCompact.size(), 1, [&]() {
+        g_iSink += pTree->toString(false).size();
+    }));
+    a_rResults.push_back(_Measure(aOptions, aDoc.sShape, "toString_pretty", sPretty.size(), 1, [&]() {
+        g_iSink += pTree->toString(true).size();
+    }));
+    const pjson::SerializeOptions oCompact = pjson::SerializeOptions::Compact();
+    const size_t iCompactBytes = pTree->toString(oCompact).size();
+    a_rResults.push_back(_Measure(aOptions, aDoc.sShape, "toString_compact", iCompactBytes, 1, [&]() {
+        g_iSink += pTree->toString(oCompact).size();
+    }));
+    std::string sMinified;
+    sMinified.reserve(sPretty.size());
+    a_rResults.push_back(_Measure(aOptions, aDoc.sShape, "minify", sPretty.size(), 1, [&]() {
+        sMinified.clear();
+        pjson::Reformatter::Reformat(sPretty.data(), sPretty.size(), sMinified, oCompact);
+        g_iSink += sMinified.size();
+    }));
+    a_rResults.push_back(_Measure(aOptions, aDoc.sShape, "copyFrom", sText.size(), 1, [&]() {
+        pjson oCopy;
+        oCopy.copyFrom(*pTree);
+        g_iSink += oCopy.getType();
+    }));
+
+    std::vector<BenchLookup> vLookups;
+    _CollectLookups(pTree, 1024, vLookups);
+    if(!vLookups.empty()) {
+        a_rResults.push_back(_Measure(aOptions, aDoc.sShape, "lookup", 0, vLookups.size(), [&]() {
+            for(const BenchLookup& rLookup : vLookups) {
+                g_iSink += _Lookup(rLookup);
+            }
+        }));
+    }
+    std::vector<const pjson::PJSONARRAY*> vArrays;
+    const size_t iElements = _CollectArrays(pTree, vArrays);
+    if(iElements > 0) {
+        // the typed accessors in a tight loop, one op per element
+        a_rResults.push_back(_Measure(aOptions, aDoc.sShape, "array_read", 0, iElements, [&]() {
+            double dSum = 0;
+            for(const pjson::PJSONARRAY* pArray : vArrays) {
+                for(const pjson* pItem : *pArray) {
+                    dSum += pItem->getDouble() + pItem->getBool();
+                }
+            }
+            g_iSink += size_t(dSum);
+        }));
+    }
+    if(pjson::jsonMap == pTree->getType()) {
+        // one extra top level member rewritten per run, the rest spliced from the cache
+        pjson::SerializeCache oCache(oCompact);
+        std::string sCached;
+        oCache.toString(*pTree, sCached);
+        int iRun = 0;
+        a_rResults.push_back(_Measure(aOptions, aDoc.sShape, "toString_cached", iCompactBytes, 1, [&]() {
+            (*pTree)["pjsonbench_run"] = ++iRun;
+            sCached.clear();
+            oCache.toString(*pTree, sCached);
+            g_iSink += sCached.size();
+        }));
+    }
+    delete pTree;
+}
+//-----------------------------------------------------------------
+static void _Print(const BenchOptions& aOptions, const std::vector<BenchResult>& aResults) {
+    char buf[512];
+    if(aOptions.bCsv) {
+        std::cout << "shape,op,bytes,ops,seconds,mb_per_s,ops_per_s,allocs_per_op" << std::endl;
+    } else {
+        std::cout << "{\"size\":" << aOptions.iSize << ",\"seed\":" << aOptions.iSeed
+                  << ",\"cpu\":\"" << pjson::Cpu::Name(pjson::Cpu::Active()) << "\",\"results\":[" << std::endl;
+    }
+    for(size_t i = 0; i < aResults.size(); ++i) {
+        const BenchResult& r = aResults[i];
+        double dOpsPerSecond = r.dSeconds > 0 ? r.iOps / r.dSeconds : 0.0;
+        double dMBPerSecond = dOpsPerSecond * r.iBytes / (1024.0 * 1024.0);
+        double dAllocations = r.iOps ? double(r.iAllocations) / r.iOps : 0.0;
+        if(aOptions.bCsv) {
+            snprintf(buf, sizeof(buf), "%s,%s,%zu,%llu,%.6f,%.3f,%.1f,%.2f",
+                     r.sShape.c_str(), r.sOp.c_str(), r.iBytes, (unsigned long long)r.iOps,
+                     r.dSeconds, dMBPerSecond, dOpsPerSecond, dAllocations);
+        } else {
+            snprintf(buf, sizeof(buf),
+                     "  {\"shape\":\"%s\",\"op\":\"%s\",\"bytes\":%zu,\"ops\":%llu,\"seconds\":%.6f,"
+                     "\"mb_per_s\":%.3f,\"ops_per_s\":%.1f,\"allocs_per_op\":%.2f}%s",
+                     r.sShape.c_str(), r.sOp.c_str(), r.iBytes, (unsigned long long)r.iOps,
+                     r.dSeconds, dMBPerSecond, dOpsPerSecond, dAllocations,
+                     (i + 1 < aResults.size()) ? "," : "");
+        }
+        std::cout << buf << std::endl;
+    }
+    if(!aOptions.bCsv) {
+        std::cout << "]}" << std::endl;
+    }
+}
+//-----------------------------------------------------------------
+static bool _ParseArgs(int argc, char* argv[], BenchOptions& a_rOptions) {
+    for(int i = 1; i < argc; ++i) {
+        const char* pArg = argv[i];
+        const char* pValue = strchr(pArg, '=');
+        std::string sName = pValue ? std::string(pArg, pValue - pArg) : std::string(pArg);
+        pValue = pValue ? pValue + 1 : "";
+        if("--size" == sName) {
+            a_rOptions.iSize = strtoull(pValue, nullptr, 10);
+        } else if("--seed" == sName) {
+            a_rOptions.iSeed = strtoull(pValue, nullptr, 10);
+        } else if("--min-time" == sName) {
+            a_rOptions.dMinTime = strtod(pValue, nullptr);
+        } else if("--format" == sName && (0 == strcmp(pValue, "json") || 0 == strcmp(pValue, "csv"))) {
+            a_rOptions.bCsv = (0 == strcmp(pValue, "csv"));
+        } else if("--shape" == sName) {
+            std::string sList = pValue;
+            size_t iFrom = 0;
+            while(iFrom <= sList.size()) {
+                size_t iComma = sList.find(',', iFrom);
+                if(std::string::npos == iComma) {
+                    iComma = sList.size();
+                }
+                if(iComma > iFrom) {
+                    a_rOptions.vShapes.push_back(sList.substr(iFrom, iComma - iFrom));
+                }
+                iFrom = iComma + 1;
+            }
+        } else {
+            std::cerr << "usage: pjsonbench [--size=BYTES] [--seed=N] [--min-time=SECONDS]"
+                         " [--shape=NAME[,NAME...]] [--format=json|csv]" << std::endl;
+            return false;
+        }
+    }
+    if(a_rOptions.vShapes.empty()) {
+        a_rOptions.vShapes = BenchCorpus::Shapes();
+    }
+    return true;
+}
+//-----------------------------------------------------------------
+int main(int argc, char* argv[]) {
+    BenchOptions oOptions;
+    if(!_ParseArgs(argc, argv, oOptions)) {
+        return 1;
+    }
+    std::vector<BenchResult> vResults;
+    for(const std::string& sShape : oOptions.vShapes) {
+        BenchDocument oDoc;
+        if(!BenchCorpus::Generate(sShape, oOptions.iSize, oOptions.iSeed, oDoc)) {
+            std::cerr << "pjsonbench: unknown shape " << sShape << std::endl;
+            return 1;
+        }
+        _RunShape(oOptions, oDoc, vResults);
+    }
+    _Print(oOptions, vResults);
+    return 0;
+}
@@ -19,6 +19,9 @@
 #ifndef PRAVEENJSON_H
 #define PRAVEENJSON_H
 
+#include <atomic>
+#include <cstdint>
+#include <functional>
 #include <vector>
 //#include <unordered_map>
 #include <map>
@@ -41,6 +44,26 @@ namespace ByteDance {
         //typedef std::unordered_map<std::string, pjson*> PJSONMAP;
         typedef std::map<std::string, pjson*> PJSONMAP;
 
+        class Writer; // DOM-free streaming output, see pjson_writer.h
+        class Reformatter; // DOM-free minify / pretty-print of JSON text, see pjson_reformat.h
+        struct SerializeOptions;
+        class ParseContext; // per-thread node / storage recycling, see pjson_context.h
+        class SharedDocument; // frozen document published to many threads, see pjson_shared.h
+        struct Stats; // optional parse / serialize counters, see pjson_stats.h
+        struct ValidateResult; // see pjson_validate.h
+        class InputStream; // file / decompressing byte sources, see pjson_stream.h
+        class PrefetchStream;
+        class RecordReader; // NDJSON / array records parsed one at a time
+        class SerializeCache; // repeated toString() reusing unchanged subtrees, see pjson_cache.h
+        class HashCache; // repeated hash() reusing unchanged subtrees, see pjson_cache.h
+        class Projection; // key paths to keep when parsing, see pjson_projection.h
+        class ArrayIndex; // random access into a huge top level array file, see pjson_index.h
+        struct Cpu; // SIMD level of the scanning kernels, see pjson_cpu.h
+        struct Trace; // latency spans and USDT probes, see pjson_trace.h
+        class Image; // relocatable binary document read in place (mmap), see pjson_image.h
+        class Query; // compiled JSONPath (RFC 9535) over trees or text, see pjson_query.h
+        class ColumnReader; // NDJSON fields straight into typed column buffers, see pjson_columns.h
+
         pjson(); // Default Constructor
         ~pjson(); // Destructor
         pjson(const pjson& aFrom); // Copy Constructor
@@ -50,40 +73,96 @@ namespace ByteDance {
 
         static pjson* CreateFromString(const std::string& aStr);
         static pjson* CreateFromString(const char* aSrc, size_t a_iSize);
+        static pjson* CreateFromString(const char* aSrc, size_t a_iSize, ParseContext& a_rContext);
+        // Builds only the selected subtrees; everything else is skipped unallocated
+        static pjson* CreateFromString(const char* aSrc, size_t a_iSize, const Projection& aFields);
+        static pjson* CreateFromString(const char* aSrc, size_t a_iSize, const Projection& aFields, ParseContext& a_rContext);
+        static pjson* CreateFromStream(InputStream& a_rSource); // one document, read to the end
+        // Strict syntax check only: builds nothing and allocates nothing
+        static ValidateResult Validate(const char* aSrc, size_t a_iSize);
+        static ValidateResult Validate(const std::string& aStr);
+
+        // Parsing fails (returns nullptr) on arrays / objects nested deeper than
+        // this. Destruction, copies and toString() recurse once per level, so
+        // the limit also keeps those within the thread stack.
+        static const size_t DefaultMaxParseDepth = 1024;
+        static void SetMaxParseDepth(size_t a_iDepth); // process wide; see also ParseContext
+        static size_t GetMaxParseDepth();
 
         jsonType getType() const;
         std::string toString(bool bPretty = false) const;
+        std::string toString(const SerializeOptions& aOptions) const;
+        void toString(std::string& a_rOut, const SerializeOptions& aOptions) const; // appends
         void copyFrom(const pjson& aFrom);
 
+        // Copy-on-write mode: copies of a node in this mode (copy constructor,
+        // copy assignment, copyFrom) share its value in O(1). The shared value is
+        // cloned one level at a time, only along the path that gets mutated.
+        // References into the tree taken before a copy must not be used to mutate it.
+        void setCopyOnWrite(bool bEnable);
+        bool isCopyOnWrite() const;
+
+        // Structural diff as a JSON Patch (RFC 6902) array or a JSON Merge Patch
+        // (RFC 7386) document. Identical (e.g. still shared) subtrees are skipped.
+        static pjson* CreatePatch(const pjson& aFrom, const pjson& aTo);
+        static pjson* CreateMergePatch(const pjson& aFrom, const pjson& aTo);
+        // Applies a JSON Patch in place; all or nothing, returns false if any operation fails.
+        // On failure the operations already applied are undone; the document is never copied.
+        bool applyPatch(const pjson& aPatch);
+        void applyMergePatch(const pjson& aPatch);
+
+        // Structural equality; map key order never matters. Numbers must have
+        // the same type unless a_bNumericEquality, which compares ints and
+        // floats by value (1 == 1.0). Numbers kept as text (setLazyNumbers)
+        // compare by their text unless a_bNumericEquality.
+        bool equals(const pjson& aOther, bool a_bNumericEquality = false) const;
+        bool operator==(const pjson& aOther) const; // strict equals()
+        bool operator!=(const pjson& aOther) const;
+        // Stable 64 bit content hash, the same on every run and platform and
+        // consistent with equals() in both modes. Walks the whole tree; a
+        // HashCache (pjson_cache.h) rehashes only the paths edited since.
+        uint64_t hash() const;
+
+        // Typed accessors below are defined inline with PJSON_INLINE, see pjson_inline.h
         PJSONARRAY* getArray();
         PJSONMAP* getMap();
+        const PJSONARRAY* getArray() const;
+        const PJSONMAP* getMap() const;
+
+        float getFloat() const;
+        int getInt() const;
+        bool getBool() const;
+        std::string getString() const;
+        int64_t getInt64() const;
+        double getDouble() const;
 
-        float getFloat();
-        int getInt();
-        bool getBool();
-        std::string getString();
+        // Numbers stored as text (see ParseContext::setLazyNumbers): converted on
+        // every get*() call and written back verbatim by toString().
+        bool isRawNumber() const;
+        void setInt64(int64_t aValue); // stored as text, jsonNumberInt
+        void setDouble(double aValue); // stored as text (%.17g), jsonNumberFloat; NaN / inf become null
 
         // Extracting from a Map
-        bool hasKey(const std::string& aKey);
-        bool hasKey(const char* aKey);
-
-        bool getIfExist(const std::string& aKey, float& a_rResult);
-        bool getIfExist(const std::string& aKey, int& a_rResult);
-        bool getIfExist(const std::string& aKey, bool& a_rResult);
-        bool getIfExist(const std::string& aKey, std::string& a_rResult);
-        bool getIfExist(const std::string& aKey, std::vector<std::string>& a_rResult);
-        bool getIfExist(const std::string& aKey, std::vector<int>& a_rResult);
-        bool getIfExist(const std::string& aKey, std::vector<float>& a_rResult);
-        bool getIfExist(const std::string& aKey, std::vector<bool>& a_rResult);
-
-        bool getIfExist(const char* aKey, float& a_rResult);
-        bool getIfExist(const char* aKey, int& a_rResult);
-        bool getIfExist(const char* aKey, bool& a_rResult);
-        bool getIfExist(const char* aKey, std::string& a_rResult);
-        bool getIfExist(const char* aKey, std::vector<std::string>& a_rResult);
-        bool getIfExist(const char* aKey, std::vector<int>& a_rResult);
-        bool getIfExist(const char* aKey, std::vector<float>& a_rResult);
-        bool getIfExist(const char* aKey, std::vector<bool>& a_rResult);
+        bool hasKey(const std::string& aKey) const;
+        bool hasKey(const char* aKey) const;
+
+        bool getIfExist(const std::string& aKey, float& a_rResult) const;
+        bool getIfExist(const std::string& aKey, int& a_rResult) const;
+        bool getIfExist(const std::string& aKey, bool& a_rResult) const;
+        bool getIfExist(const std::string& aKey, std::string& a_rResult) const;
+        bool getIfExist(const std::string& aKey, std::vector<std::string>& a_rResult) const;
+        bool getIfExist(const std::string& aKey, std::vector<int>& a_rResult) const;
+        bool getIfExist(const std::string& aKey, std::vector<float>& a_rResult) const;
+        bool getIfExist(const std::string& aKey, std::vector<bool>& a_rResult) const;
+
+        bool getIfExist(const char* aKey, float& a_rResult) const;
+        bool getIfExist(const char* aKey, int& a_rResult) const;
+        bool getIfExist(const char* aKey, bool& a_rResult) const;
+        bool getIfExist(const char* aKey, std::string& a_rResult) const;
+        bool getIfExist(const char* aKey, std::vector<std::string>& a_rResult) const;
+        bool getIfExist(const char* aKey, std::vector<int>& a_rResult) const;
+        bool getIfExist(const char* aKey, std::vector<float>& a_rResult) const;
+        bool getIfExist(const char* aKey, std::vector<bool>& a_rResult) const;
 
         void reset();
         void resetTo(jsonType aeType);
@@ -97,6 +176,16 @@ namespace ByteDance {
         pjson& operator[] (const char* aSkey);
         pjson& operator[] (int index);
 
+        // Read-only lookups: never insert or change types, so a const tree can
+        // be read from many threads at once. A missing key, an out-of-range
+        // (or negative) index or a type mismatch yields a shared null value.
+        const pjson& at(const std::string& aString) const;
+        const pjson& at(const char* aSkey) const;
+        const pjson& at(int index) const;
+        const pjson& operator[] (const std::string& aString) const;
+        const pjson& operator[] (const char* aSkey) const;
+        const pjson& operator[] (int index) const;
+
         pjson& operator=(const std::string& aString);
         pjson& operator=(const char* aCString);
         pjson& operator=(const int aInt);
@@ -123,10 +212,10 @@ namespace ByteDance {
         pjson& operator+=(const std::vector<float>& aValueArray);
         pjson& operator+=(const std::vector<bool>& aValueArray);
 
-        bool getArrayValues(size_t aFrom, size_t aTo, std::vector<std::string>& aDest);
-        bool getArrayValues(size_t aFrom, size_t aTo, std::vector<int>& aDest);
-        bool getArrayValues(size_t aFrom, size_t aTo, std::vector<float>& aDest);
-        bool getArrayValues(size_t aFrom, size_t aTo, std::vector<bool>& aDest);
+        bool getArrayValues(size_t aFrom, size_t aTo, std::vector<std::string>& aDest) const;
+        bool getArrayValues(size_t aFrom, size_t aTo, std::vector<int>& aDest) const;
+        bool getArrayValues(size_t aFrom, size_t aTo, std::vector<float>& aDest) const;
+        bool getArrayValues(size_t aFrom, size_t aTo, std::vector<bool>& aDest) const;
 
     /*
      * Encodes a data buffer as a JSON-safe string by escaping special characters
@@ -159,19 +248,68 @@ namespace ByteDance {
     static std::string DecodeBase64FromJSON(const std::string& base64Str);
 
     private:
-        std::string _toString(int a_iIndent) const;
+        friend class pjsonBindIO;
+
+        static const pjson& _NullValue();
+        void _serialize(std::string& a_rOut, const SerializeOptions& aOptions, SerializeCache* a_pCache) const;
+        void _toString(std::string& sOut, int a_iIndent, SerializeCache* a_pCache = nullptr) const;
+        void _toStringStyled(std::string& sOut, const SerializeOptions& aOptions, size_t a_iDepth,
+                             SerializeCache* a_pCache = nullptr) const;
+        static void _AppendNewline(std::string& sOut, const SerializeOptions& aOptions, size_t a_iDepth);
         void _resetIfneeded(jsonType aeType);
-        static bool _CreateFromString(const char* aSrc, size_t& a_iStart, size_t a_iEnd, pjson*& a_rResult);
+        void _releaseValue();
+        void _setRawNumber(jsonType aeType, const char* aText, size_t a_iLength);
+        void _detach();
+        class CacheSlot; // invalidation shared by the caches of one document, see pjson_cache.h
+        void _dropCaches();
+        void _uncoverChildren();
+        void _moveCaches(pjson& a_rFrom);
+        uint64_t _hash(HashCache* a_pCache) const;
+        void _shareFrom(const pjson& aFrom);
+        void _copyFrom(const pjson& aFrom); // copyFrom() without the trace span
+
+        static bool _isEqual(const pjson& aLeft, const pjson& aRight, bool a_bNumeric = false);
+        static void _diff(const pjson& aFrom, const pjson& aTo, std::string& a_rPath, pjson& a_rPatch);
+        static bool _mergeDiff(const pjson& aFrom, const pjson& aTo, pjson& a_rPatch);
+        struct PatchUndo; // reverts one change made by applyPatch()
+        bool _applyPatchOperation(const pjson& aOperation, std::vector<PatchUndo>& a_rUndo);
+        void _undoPatch(std::vector<PatchUndo>& a_rUndo);
+        bool _patchRemove(const std::vector<std::string>& aPath, pjson& a_rTaken);
+        bool _patchAdd(const std::vector<std::string>& aPath, pjson& a_rValue, std::vector<PatchUndo>* a_pUndo);
+        pjson* _resolvePointer(const std::vector<std::string>& aTokens, size_t a_iCount, bool bMutable);
+        struct ProjectionNode; // one compiled Projection step
+        static bool _CreateFromString(const char* aSrc, size_t& a_iStart, size_t a_iEnd, pjson*& a_rResult, ParseContext* a_pContext = nullptr,
+                                      const ProjectionNode* a_pSelect = nullptr);
 
         static bool _ScanPastColon(const char* aSrc, size_t& a_iStart,const size_t a_iEnd);
         static bool _ExtractString(const char* aSrc, size_t& a_iStart,const size_t a_iEnd, std::string& aStrResult);
-        static bool _ScanString(const char* aSrc, size_t& a_iStart,const size_t a_iEnd, pjson*& a_rStrResult);
-        static bool _ScanBool(const char* aSrc, size_t& a_iStart,const size_t a_iEnd, pjson*& a_rBoolResult);
+        static bool _ExtractStringSpan(const char* aSrc, size_t& a_iStart,const size_t a_iEnd, size_t& a_rBegin, size_t& a_rLength);
+        static bool _ScanString(const char* aSrc, size_t& a_iStart,const size_t a_iEnd, pjson*& a_rStrResult, ParseContext* a_pContext = nullptr);
+        static bool _ScanBool(const char* aSrc, size_t& a_iStart,const size_t a_iEnd, pjson*& a_rBoolResult, ParseContext* a_pContext = nullptr);
         static bool _ScanToNext(const char* aSrc, size_t& a_iStart,const size_t a_iEnd, char& a_rResult);
-        static bool _ScanNull(const char* aSrc, size_t& a_iStart,const size_t a_iEnd, pjson*& a_rNUllResult);
-        static bool _ScanNumber(const char* aSrc, size_t& a_iStart, const size_t a_iEnd, pjson*& a_rNumResult);
-        static bool _ScanArray(const char* aSrc, size_t& a_iStart, const size_t a_iEnd, pjson*& a_rAResult);
-        static bool _ScanObject(const char* aSrc, size_t& a_iStart, const size_t a_iEnd, pjson*& a_rAResult);
+        static bool _ScanNull(const char* aSrc, size_t& a_iStart,const size_t a_iEnd, pjson*& a_rNUllResult, ParseContext* a_pContext = nullptr);
+        static bool _ScanNumber(const char* aSrc, size_t& a_iStart, const size_t a_iEnd, pjson*& a_rNumResult, ParseContext* a_pContext = nullptr);
+        static bool _ScanNumberSpan(const char* aSrc, size_t a_iStart, const size_t a_iEnd, size_t& a_rLength, bool& a_rFloat);
+        static bool _SkipValue(const char* aSrc, size_t& a_iStart, const size_t a_iEnd);
+        static size_t _MatchLiteral(const char* aSrc, size_t a_iStart, size_t a_iEnd, const char* aLiteral, size_t a_iLength);
+        // An array / object still being parsed, with the pending member key
+        struct ParseFrame {
+            pjson* pNode;
+            size_t iKey;
+            size_t iKeyLength;
+            const ProjectionNode* pSelect; // nullptr: every member / element is kept
+            size_t iIndex; // array elements seen so far, for [N] paths
+        };
+        static void _AttachValue(const char* aSrc, const ParseFrame& aFrame, pjson* aValue, ParseContext* a_pContext);
+        static std::atomic<size_t>& _MaxParseDepth();
+        static pjson* _NewNode(jsonType aeType, ParseContext* a_pContext);
+        static void _FreeNode(pjson* aNode, ParseContext* a_pContext);
+
+        static void _AppendInt(std::string& a_rOut, int64_t aValue);
+        static void _AppendFloat(std::string& a_rOut, float aValue);
+        static void _AppendDouble(std::string& a_rOut, double aValue);
+        static void _AppendString(std::string& a_rOut, const char* aStr, size_t a_iLength);
+        static void _AppendEscaped(std::string& a_rOut, const char* data, size_t length);
 
     private:
 
@@ -186,7 +324,67 @@ namespace ByteDance {
             std::string* _pValueString;
             /* data */
         };
+        // Non-null while in copy-on-write mode; counts the nodes sharing the value
+        mutable std::atomic<std::atomic<int>*> _pShareCount{nullptr};
+
+        enum : unsigned char {
+            FlagRawNumber = 1 // number held as text in _pValueString
+        };
+        unsigned char _iFlags = 0;
+        enum : unsigned char {
+            CacheCoversChildren = 1 // every child holds the CacheSlot of the caches above it
+        };
+        mutable std::atomic<unsigned char> _iCacheFlags{0};
+        // CacheSlot of the caches whose saved text / hash of a parent includes
+        // this node, 0 when none (see pjson_cache.h)
+        mutable std::atomic<uint16_t> _iCacheSlot{0};
+        // Version of the value that cache entries are keyed by; 0 after every
+        // mutating access until a cache stamps the node again. The three cache
+        // fields share the padding after _iFlags.
+        mutable std::atomic<uint32_t> _iCacheStamp{0};
+    };
+
+    // Output layout for toString() and pjson::Writer. Keys are always written
+    // in sorted order, since PJSONMAP is an ordered std::map.
+    struct pjson::SerializeOptions {
+        enum Style : int {
+            styleLegacy,       // { "k" : v , "k2" : v2 }, same as toString(false)
+            styleLegacyPretty, // same as toString(true)
+            styleCompact,      // {"k":v,"k2":v2}, no insignificant whitespace
+            stylePretty,       // one member per line, iIndent x cIndent per level
+        };
+        Style eStyle = styleLegacy;
+        int iIndent = 2;
+        char cIndent = ' ';
+        std::string sNewline = "\n";
+
+        static SerializeOptions Compact() {
+            SerializeOptions oOptions;
+            oOptions.eStyle = styleCompact;
+            return oOptions;
+        }
+        static SerializeOptions Pretty(int a_iIndent = 2, const char* aNewline = "\n", char a_cIndent = ' ') {
+            SerializeOptions oOptions;
+            oOptions.eStyle = stylePretty;
+            oOptions.iIndent = a_iIndent;
+            oOptions.sNewline = aNewline;
+            oOptions.cIndent = a_cIndent;
+            return oOptions;
+        }
     };
 //========================================================================
 };// end namespace ByteDance
+
+#ifdef PJSON_INLINE
+#include "pjson_inline.h" // hot accessors defined in the header
+#endif
+
+namespace std {
+    template<>
+    struct hash<ByteDance::pjson> {
+        size_t operator()(const ByteDance::pjson& aValue) const {
+            return static_cast<size_t>(aValue.hash());
+        }
+    };
+}
 #endif /* !PRAVEENJSON_H */
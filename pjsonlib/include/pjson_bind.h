@@ -0,0 +1,249 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#ifndef PRAVEENJSON_BIND_H
+#define PRAVEENJSON_BIND_H
+
+#include <cstring>
+#include "pjson.h"
+#include "pjson_writer.h"
+
+//
+// Direct struct binding: parses JSON text straight into a C++ struct and
+// serializes it back, without building any pjson nodes.
+//
+//   struct Msg { int id; std::string name; std::vector<float> prices; };
+//
+//   PJSON_BIND_BEGIN(Msg)          // must be used at global scope
+//       PJSON_BIND(id)
+//       PJSON_BIND_AS(name, "user_name")
+//       PJSON_BIND(prices)
+//   PJSON_BIND_END()
+//
+//   Msg oMsg;
+//   pjsonBind<Msg>::FromString(sJson, oMsg);
+//   std::string sOut = pjsonBind<Msg>::ToString(oMsg);
+//
+// Supported members: int, int64_t, float, double, bool, std::string, pjson, std::vector<> of
+// those and any other bound struct. Unknown keys are skipped. A value of the
+// wrong type leaves the member untouched, the same as getIfExist().
+// Strings are kept in their JSON-escaped form, the same as getString().
+//
+namespace ByteDance {
+//==[Interface]============================================================
+    template<typename T> struct pjsonBinding; // specialised by PJSON_BIND_BEGIN
+
+    // Scanner primitives used by the generated code
+    class pjsonBindIO {
+    public:
+        static char Peek(const char* aSrc, size_t& a_iStart, const size_t a_iEnd);
+        static bool BeginObject(const char* aSrc, size_t& a_iStart, const size_t a_iEnd);
+        static bool NextMember(const char* aSrc, size_t& a_iStart, const size_t a_iEnd,
+                               const char*& a_rKey, size_t& a_rKeyLength, bool& a_rEnd);
+        static bool BeginArray(const char* aSrc, size_t& a_iStart, const size_t a_iEnd);
+        static bool NextElement(const char* aSrc, size_t& a_iStart, const size_t a_iEnd, bool& a_rEnd);
+        static bool SkipValue(const char* aSrc, size_t& a_iStart, const size_t a_iEnd);
+
+        static bool Read(const char* aSrc, size_t& a_iStart, const size_t a_iEnd, int& a_rValue);
+        static bool Read(const char* aSrc, size_t& a_iStart, const size_t a_iEnd, int64_t& a_rValue);
+        static bool Read(const char* aSrc, size_t& a_iStart, const size_t a_iEnd, float& a_rValue);
+        static bool Read(const char* aSrc, size_t& a_iStart, const size_t a_iEnd, double& a_rValue);
+        static bool Read(const char* aSrc, size_t& a_iStart, const size_t a_iEnd, bool& a_rValue);
+        static bool Read(const char* aSrc, size_t& a_iStart, const size_t a_iEnd, std::string& a_rValue);
+        static bool Read(const char* aSrc, size_t& a_iStart, const size_t a_iEnd, pjson& a_rValue);
+    };
+
+    // Reads / writes one value of type T; bound structs use pjsonBinding<T>
+    template<typename T>
+    struct pjsonBindCodec {
+        static bool Read(const char* aSrc, size_t& a_iStart, const size_t a_iEnd, T& a_rValue);
+        static void Write(pjson::Writer& a_rWriter, const T& aValue);
+    };
+
+    template<typename T>
+    class pjsonBind {
+    public:
+        static bool FromString(const std::string& aStr, T& a_rResult) {
+            return FromString(aStr.c_str(), aStr.length(), a_rResult);
+        }
+        static bool FromString(const char* aSrc, size_t a_iSize, T& a_rResult) {
+            size_t iStart = 0;
+            return pjsonBindCodec<T>::Read(aSrc, iStart, a_iSize, a_rResult);
+        }
+        static std::string ToString(const T& aValue) {
+            std::string sOut;
+            ToString(aValue, sOut);
+            return sOut;
+        }
+        static void ToString(const T& aValue, std::string& a_rOut) { // appends
+            pjson::Writer oWriter(a_rOut);
+            pjsonBindCodec<T>::Write(oWriter, aValue);
+        }
+        static void ToWriter(const T& aValue, pjson::Writer& a_rWriter) {
+            pjsonBindCodec<T>::Write(a_rWriter, aValue);
+        }
+    };
+
+//==[Implementation]=======================================================
+    // Matches one incoming key against the bound members
+    class pjsonBindReader {
+    public:
+        pjsonBindReader(const char* aSrc, size_t& a_iStart, const size_t a_iEnd, const char* aKey, size_t a_iKeyLength)
+            : _pSrc(aSrc), _rStart(a_iStart), _iEnd(a_iEnd), _pKey(aKey), _iKeyLength(a_iKeyLength) {}
+
+        template<size_t N, typename F>
+        void operator()(const char (&aKey)[N], F& a_rField) {
+            if(!_bMatched && (N - 1) == _iKeyLength && 0 == memcmp(aKey, _pKey, N - 1)) {
+                _bMatched = true;
+                _bValid = pjsonBindCodec<F>::Read(_pSrc, _rStart, _iEnd, a_rField);
+            }
+        }
+
+        bool matched() const { return _bMatched; }
+        bool valid() const { return _bValid; }
+
+    private:
+        const char* _pSrc;
+        size_t& _rStart;
+        const size_t _iEnd;
+        const char* _pKey;
+        const size_t _iKeyLength;
+        bool _bMatched = false;
+        bool _bValid = false;
+    };
+
+    // Emits every bound member in declaration order
+    class pjsonBindWriter {
+    public:
+        explicit pjsonBindWriter(pjson::Writer& a_rWriter) : _rWriter(a_rWriter) {}
+
+        template<size_t N, typename F>
+        void operator()(const char (&aKey)[N], const F& aField) {
+            _rWriter.key(aKey, N - 1);
+            pjsonBindCodec<F>::Write(_rWriter, aField);
+        }
+
+    private:
+        pjson::Writer& _rWriter;
+    };
+
+    //-----------------------------------------------------------------
+    template<typename T>
+    bool pjsonBindCodec<T>::Read(const char* aSrc, size_t& a_iStart, const size_t a_iEnd, T& a_rValue) {
+        if('{' != pjsonBindIO::Peek(aSrc, a_iStart, a_iEnd)) {
+            return pjsonBindIO::SkipValue(aSrc, a_iStart, a_iEnd);
+        }
+        if(!pjsonBindIO::BeginObject(aSrc, a_iStart, a_iEnd)) {
+            return false;
+        }
+        const char* pKey = nullptr;
+        size_t iKeyLength = 0;
+        bool bEnd = false;
+        while(pjsonBindIO::NextMember(aSrc, a_iStart, a_iEnd, pKey, iKeyLength, bEnd)) {
+            if(bEnd) {
+                return true;
+            }
+            pjsonBindReader oReader(aSrc, a_iStart, a_iEnd, pKey, iKeyLength);
+            pjsonBinding<T>::Visit(a_rValue, oReader);
+            if(!oReader.matched()) {
+                if(!pjsonBindIO::SkipValue(aSrc, a_iStart, a_iEnd)) {
+                    return false;
+                }
+            } else if(!oReader.valid()) {
+                return false;
+            }
+        }
+        return false;
+    }
+    //-----------------------------------------------------------------
+    template<typename T>
+    void pjsonBindCodec<T>::Write(pjson::Writer& a_rWriter, const T& aValue) {
+        a_rWriter.startObject();
+        pjsonBindWriter oWriter(a_rWriter);
+        pjsonBinding<T>::Visit(aValue, oWriter);
+        a_rWriter.endObject();
+    }
+    //-----------------------------------------------------------------
+    #define PJSON_BIND_SCALAR_CODEC(TYPE)                                                          \
+    template<>                                                                                     \
+    struct pjsonBindCodec<TYPE> {                                                                  \
+        static bool Read(const char* aSrc, size_t& a_iStart, const size_t a_iEnd, TYPE& a_rValue) { \
+            return pjsonBindIO::Read(aSrc, a_iStart, a_iEnd, a_rValue);                            \
+        }                                                                                          \
+        static void Write(pjson::Writer& a_rWriter, const TYPE& aValue) {                          \
+            a_rWriter.value(aValue);                                                               \
+        }                                                                                          \
+    };
+    PJSON_BIND_SCALAR_CODEC(int)
+    PJSON_BIND_SCALAR_CODEC(int64_t)
+    PJSON_BIND_SCALAR_CODEC(float)
+    PJSON_BIND_SCALAR_CODEC(double)
+    PJSON_BIND_SCALAR_CODEC(bool)
+    PJSON_BIND_SCALAR_CODEC(std::string)
+    PJSON_BIND_SCALAR_CODEC(pjson)
+    #undef PJSON_BIND_SCALAR_CODEC
+    //-----------------------------------------------------------------
+    template<typename T>
+    struct pjsonBindCodec<std::vector<T> > {
+        static bool Read(const char* aSrc, size_t& a_iStart, const size_t a_iEnd, std::vector<T>& a_rValue) {
+            if('[' != pjsonBindIO::Peek(aSrc, a_iStart, a_iEnd)) {
+                return pjsonBindIO::SkipValue(aSrc, a_iStart, a_iEnd);
+            }
+            if(!pjsonBindIO::BeginArray(aSrc, a_iStart, a_iEnd)) {
+                return false;
+            }
+            a_rValue.clear();
+            bool bEnd = false;
+            while(pjsonBindIO::NextElement(aSrc, a_iStart, a_iEnd, bEnd)) {
+                if(bEnd) {
+                    return true;
+                }
+                T oElement = T();
+                if(!pjsonBindCodec<T>::Read(aSrc, a_iStart, a_iEnd, oElement)) {
+                    return false;
+                }
+                a_rValue.push_back(oElement);
+            }
+            return false;
+        }
+        static void Write(pjson::Writer& a_rWriter, const std::vector<T>& aValue) {
+            a_rWriter.startArray();
+            for(typename std::vector<T>::const_iterator it = aValue.begin(); it != aValue.end(); ++it) {
+                pjsonBindCodec<T>::Write(a_rWriter, *it);
+            }
+            a_rWriter.endArray();
+        }
+    };
+//========================================================================
+};// end namespace ByteDance
+
+#define PJSON_BIND_BEGIN(TYPE)                                  \
+namespace ByteDance {                                           \
+    template<> struct pjsonBinding<TYPE> {                      \
+        template<typename T, typename V>                        \
+        static void Visit(T& a_rObj, V& a_rVisitor) {
+
+#define PJSON_BIND(MEMBER)          a_rVisitor(#MEMBER, a_rObj.MEMBER);
+#define PJSON_BIND_AS(MEMBER, KEY)  a_rVisitor(KEY, a_rObj.MEMBER);
+
+#define PJSON_BIND_END()                                        \
+        }                                                       \
+    };                                                          \
+}
+
+#endif /* !PRAVEENJSON_BIND_H */
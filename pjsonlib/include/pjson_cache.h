@@ -0,0 +1,178 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#ifndef PRAVEENJSON_CACHE_H
+#define PRAVEENJSON_CACHE_H
+
+#include <unordered_map>
+#include "pjson.h"
+
+//
+// Incremental re-serialization: keeps the text of every array / object it
+// writes and, on the next toString() of the same tree, splices the saved
+// bytes of subtrees that were not touched. Only the edited paths are written
+// again, so output cost follows the size of the edit, not of the document.
+//
+//   pjson::SerializeCache oCache(pjson::SerializeOptions::Compact());
+//   std::string sBody = oCache.toString(oDoc);   // full write, fills the cache
+//   oDoc["user"]["score"] = 42;
+//   sBody = oCache.toString(oDoc);               // rewrites root, "user" and "score" only
+//
+// Output is byte for byte the same as oDoc.toString(options). Every non-const
+// access (operator[], at(), operator=, resetTo(), ...) marks the node dirty,
+// and a lookup marks every node on its path. An edit through a reference kept
+// across toString() calls cannot mark the parents, so the next call starts
+// over with an empty cache; edit through the path (or re-fetch it) instead.
+// Only the caches of that document start over, see CacheSlot below.
+// Subtrees smaller than a_iMinBytes or deeper than a_iMaxDepth are always
+// rewritten; they cost less to write than to keep.
+//
+// One cache follows one document (one root) at a time and is not thread safe;
+// passing another root drops what it saved. Nodes may be cached by several
+// caches, each one only reuses what it wrote itself.
+//
+namespace ByteDance {
+//==[Interface]============================================================
+    // The caches following one root share a slot in a table of epochs. Every
+    // array / object they write or hash records the slot on its children, and
+    // a mutating access to such a child moves that slot's epoch on, so the
+    // caches of that document, and only those, start over on their next call.
+    // A node included by caches of different roots (e.g. a subtree cached on
+    // its own) records Shared, whose epoch every cache follows; so do the
+    // caches beyond the first Count - 2 roots.
+    class pjson::CacheSlot {
+    public:
+        enum : uint16_t {
+            Count = 4096,
+            Shared = Count - 1
+        };
+
+        CacheSlot() = default;
+        ~CacheSlot();
+
+        CacheSlot(const CacheSlot&) = delete;
+        CacheSlot& operator=(const CacheSlot&) = delete;
+
+        bool follow(const pjson& aRoot); // false: another root, or a covered node changed since
+        void cover(const pjson& aNode) const; // records the slot on aNode's children
+
+        static uint32_t Stamp(const pjson& aNode); // the node's stamp, a new one if it has none
+        static void Touch(uint16_t a_iSlot); // a node recording a_iSlot is about to change
+
+    private:
+        static std::atomic<uint64_t>* _Epochs();
+        void _release();
+
+        const pjson* _pRoot = nullptr;
+        uint16_t _iSlot = 0;
+        uint64_t _iEpoch = 0;
+        uint64_t _iSharedEpoch = 0;
+    };
+
+    class pjson::SerializeCache {
+    public:
+        explicit SerializeCache(const SerializeOptions& aOptions = SerializeOptions(),
+                                size_t a_iMinBytes = 128, size_t a_iMaxDepth = 16);
+
+        SerializeCache(const SerializeCache&) = delete;
+        SerializeCache& operator=(const SerializeCache&) = delete;
+
+        std::string toString(const pjson& aRoot);
+        void toString(const pjson& aRoot, std::string& a_rOut); // appends
+
+        void clear(); // drops every saved subtree, e.g. before switching documents
+
+        size_t entries() const;     // subtrees currently saved
+        size_t cachedBytes() const; // text held for them
+
+    private:
+        friend class pjson;
+
+        struct Entry {
+            uint32_t iStamp;  // matches the node's _iCacheStamp while it is unchanged
+            int iContext;     // indent / depth the text was written at
+            std::string sText;
+            std::vector<const pjson*> vChildren; // child containers, to drop their entries later
+        };
+
+        bool _splice(const pjson& aNode, int a_iContext, std::string& a_rOut);
+        void _store(const pjson& aNode, int a_iContext, const std::string& aOut, size_t a_iBegin);
+        void _updateChildren(const pjson& aNode, Entry& a_rEntry);
+        void _erase(const pjson* aNode);
+
+    private:
+        SerializeOptions _oOptions;
+        size_t _iMinBytes;
+        size_t _iMaxDepth;
+        size_t _iDepth = 0; // containers being written right now
+        size_t _iCachedBytes = 0;
+        CacheSlot _oSlot;
+        std::unordered_map<const pjson*, Entry> _mEntries;
+    };
+
+//
+// Incremental hash(): keeps the hash of every array / object it hashes and,
+// on the next hash() of the same tree, reuses it for subtrees that were not
+// touched. Only the containers on the edited paths are hashed again, with
+// their untouched children looked up.
+//
+//   pjson::HashCache oHashes;
+//   uint64_t iKey = oHashes.hash(oDoc);    // full walk, fills the cache
+//   oDoc["user"]["score"] = 42;
+//   iKey = oHashes.hash(oDoc);             // rehashes root and "user" only
+//
+// The value is always the same as oDoc.hash(). Edits are tracked as for
+// SerializeCache, including edits through kept references. Arrays and objects
+// with fewer than a_iMinChildren elements are always hashed again. Entries of
+// nodes that left the document are swept once the cache has doubled in size.
+//
+// One cache follows one document (one root) at a time and is not thread safe.
+//
+    class pjson::HashCache {
+    public:
+        explicit HashCache(size_t a_iMinChildren = 4);
+
+        HashCache(const HashCache&) = delete;
+        HashCache& operator=(const HashCache&) = delete;
+
+        uint64_t hash(const pjson& aRoot);
+
+        void clear();
+        size_t entries() const;
+
+    private:
+        friend class pjson;
+
+        struct Entry {
+            uint32_t iStamp; // matches the node's _iCacheStamp while it is unchanged
+            uint64_t iHash;
+        };
+
+        bool _find(const pjson& aNode, uint64_t& a_rHash) const;
+        void _store(const pjson& aNode, uint64_t a_iHash);
+        void _sweep(const pjson& aRoot);
+
+    private:
+        size_t _iMinChildren;
+        size_t _iSweepAt;
+        CacheSlot _oSlot;
+        std::unordered_map<const pjson*, Entry> _mEntries;
+    };
+//========================================================================
+};// end namespace ByteDance
+#endif /* !PRAVEENJSON_CACHE_H */
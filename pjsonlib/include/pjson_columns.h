@@ -0,0 +1,173 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#ifndef PRAVEENJSON_COLUMNS_H
+#define PRAVEENJSON_COLUMNS_H
+
+#include <cstdint>
+#include <deque>
+#include <string>
+#include <vector>
+#include "pjson.h"
+#include "pjson_stream.h"
+
+//
+// Columnar extraction: a few fields of every record go straight from the
+// record text into one contiguous typed buffer per field, with a null bitmap,
+// without building a pjson tree per record.
+//
+//   pjson::ColumnReader oColumns;
+//   oColumns.add("user.id", pjson::ColumnReader::typeInt64);
+//   oColumns.add("score", pjson::ColumnReader::typeFloat);
+//   oColumns.add("tags[0]", pjson::ColumnReader::typeString);
+//
+//   pjson::RecordReader oReader(*pFile);
+//   oColumns.read(oReader);                            // every record, on all cores
+//
+//   const pjson::ColumnReader::Column& rScore = oColumns.column(1);
+//   const float* pScores = rScore.floats();            // rows() values
+//   bool bMissing = rScore.isNull(17);
+//
+// Paths use the Projection syntax without wildcards: keys separated by '.'
+// and "[N]" for element N, matched against keys as written in the JSON.
+// Members nobody asked for are stepped over by the bracket matching skipper,
+// and a record is left as soon as every column has its value.
+//
+// A value of the wrong kind reads as null: numbers fill the numeric columns
+// (a fraction is truncated for the integer ones, and out of range integers
+// are null), true / false fill typeBool and strings fill typeString, kept
+// JSON-escaped like getString(). Null rows hold 0 / an empty string. When a
+// key repeats, its first value is used.
+//
+// read() copies records into batches on the calling thread while worker
+// threads extract the previous batch, each into its own rows. A ColumnReader
+// itself is not thread safe.
+//
+namespace ByteDance {
+//==[Interface]============================================================
+    class pjson::ColumnReader {
+    public:
+        enum Type : int {
+            typeBool,   // uint8_t 0 / 1
+            typeInt32,
+            typeInt64,
+            typeFloat,
+            typeDouble,
+            typeString  // offsets() into chars()
+        };
+        class Column;
+
+        ColumnReader();
+
+        ColumnReader(const ColumnReader&) = delete;
+        ColumnReader& operator=(const ColumnReader&) = delete;
+
+        // false on a malformed path, or once rows have been read
+        bool add(const std::string& aPath, Type aeType);
+        size_t columns() const;
+        const Column& column(size_t a_iIndex) const;
+
+        // One row per record; false if the text is malformed (the values
+        // found before the error are kept, see malformed())
+        bool append(const char* aSrc, size_t a_iSize);
+        // Every remaining record of a_rReader. a_iThreads extract in parallel
+        // (0: one per hardware thread, 1: only the calling thread). false if
+        // the reader failed.
+        bool read(RecordReader& a_rReader, size_t a_iThreads = 0);
+
+        size_t rows() const;
+        size_t malformed() const; // records cut short by a syntax error
+        void reserve(size_t a_iRows);
+        void clearRows(); // keeps the columns and their capacity
+
+    private:
+        // One path step; a path ending here fills vColumns
+        struct Step {
+            std::vector<size_t> vColumns;
+            std::vector<std::pair<std::string, Step*> > vKeys;
+            std::vector<std::pair<size_t, Step*> > vIndices;
+
+            const Step* key(const char* aKey, size_t a_iLength) const;
+            const Step* index(size_t a_iIndex) const;
+        };
+        // What one worker produces apart from the fixed width values
+        struct Slice {
+            std::vector<std::string> vChars; // per column, typeString only
+            size_t iMalformed = 0;
+        };
+
+        void _gather(RecordReader& a_rReader, std::string& a_rText, std::vector<size_t>& a_rEnds);
+        void _begin(size_t a_iRecords, size_t a_iWorkers);
+        void _extractRange(const char* aText, const size_t* aEnds, size_t a_iFirst, size_t a_iLast, Slice* a_pSlice);
+        bool _extractRecord(const char* aSrc, size_t a_iSize, size_t a_iRecord, Slice& a_rSlice);
+        bool _extractValue(const char* aSrc, size_t& a_iStart, size_t a_iEnd, const Step& aStep, size_t a_iRecord,
+                           Slice& a_rSlice, size_t& a_rFound, size_t a_iDepth);
+        void _store(size_t a_iColumn, const char* aSrc, size_t a_iStart, size_t a_iEnd, size_t a_iRecord,
+                    Slice& a_rSlice, size_t& a_rFound);
+        void _finish(size_t a_iRecords);
+
+    private:
+        std::deque<Step> _vSteps; // [0] is the record root; a deque keeps pointers stable
+        std::vector<Column> _vColumns;
+        size_t _iRows = 0;
+        size_t _iMalformed = 0;
+        // the batch being extracted
+        std::vector<uint8_t> _vFound; // record * columns() + column
+        std::vector<Slice> _vSlices;
+    };
+
+    // One extracted field: rows() values, contiguous
+    class pjson::ColumnReader::Column {
+    public:
+        const std::string& path() const;
+        Type type() const;
+        size_t size() const; // rows
+        size_t nulls() const;
+        bool isNull(size_t a_iRow) const;
+        // Bit (row % 8) of byte (row / 8) is set when the row has a value
+        const uint8_t* validity() const;
+
+        // The values; nullptr unless the column has that type
+        const uint8_t* bools() const;
+        const int32_t* int32s() const;
+        const int64_t* int64s() const;
+        const float* floats() const;
+        const double* doubles() const;
+        // typeString: row i is chars()[offsets()[i] .. offsets()[i + 1])
+        const uint64_t* offsets() const;
+        const char* chars() const;
+        std::string getString(size_t a_iRow) const;
+
+    private:
+        friend class pjson::ColumnReader;
+        Column(const std::string& aPath, Type aeType);
+        size_t _width() const; // bytes per fixed width value
+
+    private:
+        std::string _sPath;
+        Type _eType;
+        size_t _iRows = 0;
+        size_t _iNulls = 0;
+        std::vector<uint8_t> _vValid;
+        std::vector<uint64_t> _vValues; // fixed width values, packed; 8 byte aligned
+        std::vector<uint64_t> _vOffsets; // typeString: rows + 1
+        std::string _sChars;
+    };
+//========================================================================
+};// end namespace ByteDance
+#endif /* !PRAVEENJSON_COLUMNS_H */
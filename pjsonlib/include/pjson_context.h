@@ -0,0 +1,96 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#ifndef PRAVEENJSON_CONTEXT_H
+#define PRAVEENJSON_CONTEXT_H
+
+#include "pjson.h"
+
+//
+// Parser context: keeps released nodes and their value storage (strings,
+// numbers, arrays, maps) in free lists, so that a steady stream of small
+// documents is parsed without going back to the allocator.
+//
+//   pjson::ParseContext oContext;        // one per thread, not thread safe
+//   for(...) {
+//       pjson* pDoc = pjson::CreateFromString(aSrc, iSize, oContext);
+//       ...
+//       oContext.recycle(pDoc);          // instead of delete pDoc
+//   }
+//
+// Trees from the context are ordinary pjson trees: they may be kept, mutated
+// or deleted as usual. recycle() accepts any tree owned by the caller.
+// std::map entries are still allocated per key.
+//
+namespace ByteDance {
+//==[Interface]============================================================
+    class pjson::ParseContext {
+    public:
+        explicit ParseContext(size_t a_iMaxPooled = 64 * 1024); // per free list
+        ~ParseContext();
+
+        ParseContext(const ParseContext&) = delete;
+        ParseContext& operator=(const ParseContext&) = delete;
+
+        void recycle(pjson* aRoot); // takes ownership of aRoot and all its children
+        void trim(); // hands all pooled memory back to the allocator
+
+        void setMaxDepth(size_t a_iDepth); // defaults to pjson::GetMaxParseDepth()
+        size_t maxDepth() const;
+
+        // Keep numbers as their source text (see pjson::isRawNumber): nothing is
+        // converted until a get*() call, and toString() writes the text back
+        // unchanged, so large IDs and long decimals pass through intact.
+        void setLazyNumbers(bool bEnable);
+        bool lazyNumbers() const;
+
+        size_t pooledNodes() const;
+
+    private:
+        friend class pjson;
+
+        pjson* _acquire(jsonType aeType);
+        pjson* _acquireRawNumber(jsonType aeType);
+        void _release(pjson* aNode);
+
+        template<typename T>
+        void _push(std::vector<T*>& a_rPool, T* aItem) {
+            if(a_rPool.size() < _iMaxPooled) {
+                a_rPool.push_back(aItem);
+            } else {
+                delete aItem;
+            }
+        }
+
+    private:
+        size_t _iMaxPooled;
+        size_t _iMaxDepth;
+        bool _bLazyNumbers;
+        std::vector<ParseFrame> _vFrames; // parser stack, reused across parses
+        std::vector<pjson*> _vNodes;
+        std::vector<std::string*> _vStrings;
+        std::vector<int*> _vInts;
+        std::vector<float*> _vFloats;
+        std::vector<bool*> _vBools;
+        std::vector<PJSONARRAY*> _vArrays;
+        std::vector<PJSONMAP*> _vMaps;
+        std::vector<pjson*> _vPending; // recycle() work list
+    };
+//========================================================================
+};// end namespace ByteDance
+#endif /* !PRAVEENJSON_CONTEXT_H */
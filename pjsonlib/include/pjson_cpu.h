@@ -0,0 +1,67 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#ifndef PRAVEENJSON_CPU_H
+#define PRAVEENJSON_CPU_H
+
+#include "pjson.h"
+
+//
+// Runtime CPU dispatch for the byte scanning kernels. The parser's string
+// scanning, Validate(), Reformatter, EncodeForJSON(), UTF-8 validation and
+// the base64 helpers use the widest implementation the CPU supports. The
+// choice is made once, when the library is loaded:
+//
+//   levelScalar  portable C++, the reference for every other level
+//   levelSSE2    x86 baseline (base64 stays scalar, it needs pshufb)
+//   levelAVX2    x86 with AVX2
+//   levelAVX512  x86 with AVX-512BW (UTF-8 and base64 use the AVX2 code)
+//   levelNEON    AArch64, only when built with PJSON_ENABLE_NEON
+//
+// Every level produces the same results. To force a level for benchmarking or
+// testing, set PJSON_CPU_LEVEL=scalar|sse2|avx2|avx512|neon in the
+// environment or call SetLevel():
+//
+//   PJSON_CPU_LEVEL=scalar ./pjsonbench
+//   pjson::Cpu::SetLevel(pjson::Cpu::levelSSE2);
+//
+// If the CPU lacks the requested level, the next lower level it supports is
+// used instead. Build with PJSON_NO_SIMD to compile only the scalar kernels.
+//
+namespace ByteDance {
+//==[Interface]============================================================
+    struct pjson::Cpu {
+        enum Level : int {
+            levelScalar,
+            levelSSE2,
+            levelAVX2,
+            levelAVX512,
+            levelNEON
+        };
+
+        static Level Detected(); // best level of this CPU and build
+        static Level Active();   // level in use
+        static bool IsSupported(Level a_eLevel);
+        // Switches every kernel to a_eLevel, or the next lower supported level;
+        // returns the level now in use. Calls already running finish on the old one.
+        static Level SetLevel(Level a_eLevel);
+        static const char* Name(Level a_eLevel); // "scalar", "sse2", ... as in PJSON_CPU_LEVEL
+    };
+//========================================================================
+};// end namespace ByteDance
+#endif /* !PRAVEENJSON_CPU_H */
@@ -0,0 +1,137 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#ifndef PRAVEENJSON_IMAGE_H
+#define PRAVEENJSON_IMAGE_H
+
+#include <cstdint>
+#include <string>
+#include "pjson.h"
+
+//
+// Relocatable binary image of a parsed document. All links inside the image
+// are offsets from its start, so it can be mapped read-only and used in
+// place: opening one is O(1) whatever its size, pages are faulted in as they
+// are read, and every process mapping the same file shares them.
+//
+//   pjson::Image::Save(*pCatalog, "catalog.pjimg");        // once, offline
+//
+//   pjson::Image* pImage = pjson::Image::Open("catalog.pjimg");
+//   pjson::Image::View oItem = pImage->root()["items"][1234];
+//   int iPrice = oItem["price"].getInt();
+//   std::string sName = oItem["name"].getString();
+//   delete pImage;                                          // unmaps; views become invalid
+//
+// Views read like a const pjson: a missing key, an index out of range or a
+// type mismatch gives a null view, and the getters convert the way pjson's
+// do. Object members are kept in key order (the order toString() writes
+// them), so key lookups are a binary search. Strings are kept in their
+// JSON-escaped form, the same as getString(), and each distinct key is
+// stored once.
+//
+// Images are in native byte order and Open() rejects an image from a machine
+// of the other byte order. Every offset is bounds checked when followed, so a
+// truncated or corrupt image reads as nulls rather than faulting.
+// An Image and its views are immutable and can be read from many threads.
+//
+namespace ByteDance {
+//==[Interface]============================================================
+    class pjson::Image {
+    public:
+        class View;
+
+        static void Create(const pjson& aRoot, std::string& a_rOut); // replaces a_rOut
+        static bool Save(const pjson& aRoot, const char* aPath);
+
+        // Maps the file read-only; nullptr if it cannot be read or is not an image
+        static Image* Open(const char* aPath);
+        // Uses caller memory in place: it must be 8 byte aligned and outlive the Image
+        static Image* FromBuffer(const char* aData, size_t a_iSize);
+        ~Image();
+
+        Image(const Image&) = delete;
+        Image& operator=(const Image&) = delete;
+
+        View root() const;
+        size_t size() const; // bytes
+        bool isMapped() const;
+
+    private:
+        class Builder; // writes the image of a tree
+        Image(const char* aData, size_t a_iSize, bool a_bMapped);
+        static bool _IsValid(const char* aData, size_t a_iSize);
+
+    private:
+        const char* _pData;
+        size_t _iSize;
+        bool _bMapped;
+        std::string _sOwned; // the file contents, where it could not be mapped
+    };
+
+    // One value inside an Image; cheap to copy, valid while the Image lives
+    class pjson::Image::View {
+    public:
+        View(); // null
+
+        jsonType getType() const;
+        bool isNull() const;
+        size_t size() const; // elements / members; 0 for scalars
+
+        View at(int index) const;
+        View at(const char* aSkey) const;
+        View at(const std::string& aString) const;
+        View operator[](int index) const;
+        View operator[](const char* aSkey) const;
+        View operator[](const std::string& aString) const;
+        bool hasKey(const char* aKey) const;
+        bool hasKey(const std::string& aKey) const;
+
+        // Members by position, in key order
+        const char* keyAt(size_t a_iIndex, size_t& a_rLength) const; // nullptr when out of range
+        View valueAt(size_t a_iIndex) const;
+
+        float getFloat() const;
+        int getInt() const;
+        bool getBool() const;
+        std::string getString() const;
+        int64_t getInt64() const;
+        double getDouble() const;
+        bool isRawNumber() const;
+        // The string in place, without copying; nullptr unless jsonString
+        const char* getStringData(size_t& a_rLength) const;
+
+        // Deep copy into a regular tree; the caller owns it. A null pjson when
+        // a corrupt image links back to its own values.
+        pjson* toPjson() const;
+
+    private:
+        friend class pjson::Image;
+        View(const char* aBase, uint64_t a_iSize, uint64_t a_iSlot);
+        const char* _record(uint64_t a_iOffset, size_t a_iItemSize, uint64_t& a_rCount) const;
+        const char* _text(uint64_t a_iOffset, size_t& a_rLength) const;
+        View _find(const char* aKey, size_t a_iLength) const;
+        bool _materialize(pjson& a_rOut, size_t a_iDepth, size_t& a_rBudget) const;
+
+    private:
+        const char* _pBase;
+        uint64_t _iSize;
+        uint64_t _iSlot; // offset of this value's slot; 0 for a null view
+    };
+//========================================================================
+};// end namespace ByteDance
+#endif /* !PRAVEENJSON_IMAGE_H */
@@ -0,0 +1,104 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#ifndef PRAVEENJSON_INDEX_H
+#define PRAVEENJSON_INDEX_H
+
+#include <cstdint>
+#include <cstdio>
+#include <list>
+#include <memory>
+#include <unordered_map>
+#include "pjson.h"
+
+//
+// Random access into a file holding one large top level JSON array. Opening
+// records the byte offset of every element (8 bytes each); element N is then
+// read and parsed on its own, without touching elements 0..N-1, so files far
+// larger than RAM can be sampled or walked with bounded memory.
+//
+//   pjson::ArrayIndex* pData = pjson::ArrayIndex::Open("events.json", "events.json.pjidx");
+//   pjson::ArrayIndex::Ptr pEvent = pData->get(1234567);  // parsed, kept in a small LRU cache
+//   int iUser = (*pEvent)["user"].getInt();
+//   for(size_t i = 0; i < pData->size(); ++i) {
+//       pjson* pRecord = pData->parse(i);                 // uncached, caller owns
+//       ...
+//       delete pRecord;
+//   }
+//   delete pData;
+//
+// The sidecar file is optional. When it matches the data file (same size,
+// modification time to the nanosecond where the platform keeps it, and the
+// same first and last 64 KiB) the index is loaded from it instead of scanning
+// the whole file; otherwise the index is built and written there. It is stored
+// in native byte order. Only plain (uncompressed) files can be indexed.
+//
+// Elements handed out by get() stay valid while their Ptr is held, even after
+// the cache evicted them. An ArrayIndex itself is not thread safe.
+//
+namespace ByteDance {
+//==[Interface]============================================================
+    class pjson::ArrayIndex {
+    public:
+        typedef std::shared_ptr<const pjson> Ptr;
+
+        // nullptr if the file cannot be read or is not a well formed array
+        static ArrayIndex* Open(const char* aPath, const char* aSidecarPath = nullptr);
+        ~ArrayIndex();
+
+        ArrayIndex(const ArrayIndex&) = delete;
+        ArrayIndex& operator=(const ArrayIndex&) = delete;
+
+        size_t size() const; // elements in the array
+
+        // Element a_iIndex, parsed on first use and cached; nullptr when out
+        // of range, unreadable or not parsable
+        Ptr get(size_t a_iIndex);
+        // Uncached parse; the caller owns the result
+        pjson* parse(size_t a_iIndex);
+        pjson* parse(size_t a_iIndex, ParseContext& a_rContext);
+        // Element text as stored in the file
+        bool text(size_t a_iIndex, std::string& a_rOut);
+
+        void setCacheSize(size_t a_iElements); // default 1024; 0 disables the cache
+        size_t cached() const;
+        void evict(size_t a_iIndex);
+        void evictAll();
+
+        bool save(const char* aSidecarPath) const; // writes the index
+
+    private:
+        ArrayIndex(FILE* a_pFile, uint64_t a_iFileSize, int64_t a_iFileTime);
+        bool _build();
+        bool _load(const char* aSidecarPath);
+
+    private:
+        FILE* _pFile;
+        uint64_t _iFileSize;
+        int64_t _iFileTime; // ns
+        uint64_t _iFingerprint = 0; // hash of the first and last chunk
+        // start of every element, plus the end of the last one
+        std::vector<uint64_t> _vOffsets;
+        std::string _sBuffer;
+        size_t _iCacheSize = 1024;
+        std::list<size_t> _lRecent; // most recently used first
+        std::unordered_map<size_t, std::pair<Ptr, std::list<size_t>::iterator> > _mCache;
+    };
+//========================================================================
+};// end namespace ByteDance
+#endif /* !PRAVEENJSON_INDEX_H */
@@ -0,0 +1,204 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#ifndef PRAVEENJSON_INLINE_H
+#define PRAVEENJSON_INLINE_H
+
+#include <climits>
+#include <cstdlib>
+
+//
+// The only definitions of the hot read accessors. With PJSON_INLINE (the
+// pjson_inline target sets it for its users) pjson.h includes this file and
+// they are inline in every translation unit. Without it pjson.cpp includes it
+// once and PJSON_ACCESSOR is empty, so they are ordinary out-of-line
+// functions of the library. Do not include it anywhere else.
+//
+// With the accessors visible to the compiler, a loop such as
+//
+//   for(const pjson* pItem : *pDoc->getArray()) {
+//       iSum += pItem->getInt();
+//   }
+//
+// compiles to a type check and a load per element instead of a call.
+// Numbers kept as text (setLazyNumbers) and the non-const getArray() /
+// getMap() still call into the library, and so do the mutating at().
+//
+// The whole program must use the same mode: mixing translation units built
+// with and without PJSON_INLINE against one library is an ODR violation.
+//
+#ifdef PJSON_INLINE
+#define PJSON_ACCESSOR inline
+#else
+#define PJSON_ACCESSOR
+#endif
+
+namespace ByteDance {
+//==[Implementation]=======================================================
+    //-----------------------------------------------------------------
+    PJSON_ACCESSOR pjson::jsonType pjson::getType() const {
+        return _eType;
+    }
+    //-----------------------------------------------------------------
+    PJSON_ACCESSOR pjson::PJSONARRAY* pjson::getArray() {
+        if(_eType == jsonType::jsonArray) {
+            _detach();
+            return _pValueArray;
+        }
+        return nullptr;
+    }
+    //-----------------------------------------------------------------
+    PJSON_ACCESSOR pjson::PJSONMAP* pjson::getMap() {
+        if(_eType == jsonType::jsonMap) {
+            _detach();
+            return _pValueMap;
+        }
+        return nullptr;
+    }
+    //-----------------------------------------------------------------
+    PJSON_ACCESSOR const pjson::PJSONARRAY* pjson::getArray() const {
+        return (_eType == jsonType::jsonArray) ? _pValueArray : nullptr;
+    }
+    //-----------------------------------------------------------------
+    PJSON_ACCESSOR const pjson::PJSONMAP* pjson::getMap() const {
+        return (_eType == jsonType::jsonMap) ? _pValueMap : nullptr;
+    }
+    //-----------------------------------------------------------------
+    PJSON_ACCESSOR float pjson::getFloat() const {
+        if(_iFlags & FlagRawNumber) {
+            return static_cast<float>(getDouble());
+        }
+        if(_eType == jsonType::jsonNumberInt) {
+            return float(*_pValueInt);
+        } else if(_eType == jsonType::jsonNumberFloat) {
+            return *_pValueFloat;
+        }
+        return 0.0f;
+    }
+    //-----------------------------------------------------------------
+    PJSON_ACCESSOR int pjson::getInt() const {
+        if(_iFlags & FlagRawNumber) {
+            if(_eType == jsonType::jsonNumberFloat) {
+                return int(getDouble());
+            }
+            int64_t iValue = getInt64();
+            return (iValue > INT_MAX) ? INT_MAX : (iValue < INT_MIN) ? INT_MIN : static_cast<int>(iValue);
+        }
+        if(_eType == jsonType::jsonNumberInt) {
+            return *_pValueInt;
+        } else if(_eType == jsonType::jsonNumberFloat) {
+            return int(*_pValueFloat);
+        }
+        return 0;
+    }
+    //-----------------------------------------------------------------
+    PJSON_ACCESSOR bool pjson::getBool() const {
+        switch (_eType) {
+            case jsonType::jsonString:      { return (_pValueString->length() > 0); }
+            case jsonType::jsonNumberInt:   { return (_iFlags & FlagRawNumber) ? (0 != getInt64()) : bool(*_pValueInt); }
+            case jsonType::jsonNumberFloat: { return (_iFlags & FlagRawNumber) ? (0.0 != getDouble()) : bool(*_pValueFloat); }
+            case jsonType::jsonBoolean:     { return (*_pValueBool); }
+            default:                        { return false; }
+        }
+    }
+    //-----------------------------------------------------------------
+    PJSON_ACCESSOR std::string pjson::getString() const {
+        return (_eType == jsonType::jsonString)? (*_pValueString): "";
+    }
+    //-----------------------------------------------------------------
+    PJSON_ACCESSOR int64_t pjson::getInt64() const {
+        if(_iFlags & FlagRawNumber) {
+            if(_eType == jsonType::jsonNumberFloat) {
+                return static_cast<int64_t>(getDouble());
+            }
+            return strtoll(_pValueString->c_str(), nullptr, 10); // saturates on overflow
+        }
+        if(_eType == jsonType::jsonNumberInt) {
+            return *_pValueInt;
+        } else if(_eType == jsonType::jsonNumberFloat) {
+            return static_cast<int64_t>(*_pValueFloat);
+        }
+        return 0;
+    }
+    //-----------------------------------------------------------------
+    PJSON_ACCESSOR double pjson::getDouble() const {
+        if(_iFlags & FlagRawNumber) {
+            return strtod(_pValueString->c_str(), nullptr);
+        }
+        if(_eType == jsonType::jsonNumberInt) {
+            return *_pValueInt;
+        } else if(_eType == jsonType::jsonNumberFloat) {
+            return *_pValueFloat;
+        }
+        return 0.0;
+    }
+    //-----------------------------------------------------------------
+    PJSON_ACCESSOR bool pjson::isRawNumber() const {
+        return 0 != (_iFlags & FlagRawNumber);
+    }
+    //-----------------------------------------------------------------
+    PJSON_ACCESSOR pjson& pjson::operator[] (int index) {
+        return at(index);
+    }
+    //-----------------------------------------------------------------
+    PJSON_ACCESSOR pjson& pjson::operator[] (const std::string& aString) {
+        return at(aString);
+    }
+    //-----------------------------------------------------------------
+    PJSON_ACCESSOR pjson& pjson::operator[] (const char* aSkey) {
+        return at(aSkey);
+    }
+    //-----------------------------------------------------------------
+    PJSON_ACCESSOR const pjson& pjson::at(const std::string& aString) const {
+        return at(aString.c_str());
+    }
+    //-----------------------------------------------------------------
+    PJSON_ACCESSOR const pjson& pjson::at(const char* aSkey) const {
+        if(_eType == jsonType::jsonMap) {
+            PJSONMAP::const_iterator it = _pValueMap->find(aSkey);
+            if(it != _pValueMap->end()) {
+                return *(it->second);
+            }
+        }
+        return _NullValue();
+    }
+    //-----------------------------------------------------------------
+    PJSON_ACCESSOR const pjson& pjson::at(int index) const {
+        if(_eType == jsonType::jsonArray && index >= 0
+           && static_cast<size_t>(index) < _pValueArray->size()) {
+            return *(*_pValueArray)[static_cast<size_t>(index)];
+        }
+        return _NullValue();
+    }
+    //-----------------------------------------------------------------
+    PJSON_ACCESSOR const pjson& pjson::operator[] (int index) const {
+        return at(index);
+    }
+    //-----------------------------------------------------------------
+    PJSON_ACCESSOR const pjson& pjson::operator[] (const std::string& aString) const {
+        return at(aString.c_str());
+    }
+    //-----------------------------------------------------------------
+    PJSON_ACCESSOR const pjson& pjson::operator[] (const char* aSkey) const {
+        return at(aSkey);
+    }
+//========================================================================
+};// end namespace ByteDance
+
+#undef PJSON_ACCESSOR
+#endif /* !PRAVEENJSON_INLINE_H */
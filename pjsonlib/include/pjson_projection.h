@@ -0,0 +1,90 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#ifndef PRAVEENJSON_PROJECTION_H
+#define PRAVEENJSON_PROJECTION_H
+
+#include <deque>
+#include <initializer_list>
+#include "pjson.h"
+
+//
+// Parse-time projection: only the subtrees named by a set of key paths are
+// built into pjson nodes. Every other value is stepped over by the bracket
+// matching skipper, so it is never allocated and never needs destroying.
+//
+//   pjson::Projection oFields({"user.id", "items[*].price", "meta"});
+//   pjson* pEvent = pjson::CreateFromString(aSrc, iSize, oFields);       // or with a ParseContext
+//   int iUser = (*pEvent)["user"]["id"].getInt();
+//
+// Path syntax: keys separated by '.', "[*]" for every array element, "[N]"
+// for element N and "*" for every key of an object. Keys are matched against
+// the key text as written in the JSON (still escaped, like getMap() keys).
+// A path ending on an array or object keeps that whole subtree.
+//
+// The objects and arrays leading to a selected value are kept, even when
+// nothing below them matched (so "user.id" on {"user":{}} gives {"user":{}}).
+// Values of the wrong kind for the path (a string where "user.id" expects an
+// object) are skipped. Array elements keep their positions: skipped elements
+// before a kept one read back as null, trailing ones are dropped.
+//
+// A Projection is read-only while parsing and can be shared by any number of
+// threads. See also RecordReader::setProjection().
+//
+namespace ByteDance {
+//==[Interface]============================================================
+    // Children of one step. A wildcard is also merged into every named
+    // sibling, so a lookup only ever follows a single node.
+    struct pjson::ProjectionNode {
+        bool bKeepAll = false;                                    // a path ends here
+        std::vector<std::pair<std::string, ProjectionNode*> > vKeys;
+        ProjectionNode* pAnyKey = nullptr;                        // "*"
+        std::vector<std::pair<size_t, ProjectionNode*> > vIndices;
+        ProjectionNode* pAnyIndex = nullptr;                      // "[*]"
+
+        const ProjectionNode* key(const char* aKey, size_t a_iLength) const;
+        const ProjectionNode* index(size_t a_iIndex) const;
+        bool wantsObject() const { return pAnyKey || !vKeys.empty(); }
+        bool wantsArray() const { return pAnyIndex || !vIndices.empty(); }
+    };
+
+    class pjson::Projection {
+    public:
+        Projection();
+        Projection(std::initializer_list<const char*> aPaths);
+        explicit Projection(const std::vector<std::string>& aPaths);
+        Projection(const Projection& aFrom);
+        Projection& operator=(const Projection& aFrom);
+
+        bool add(const std::string& aPath); // false (and nothing added) on a malformed path
+        void clear();
+        size_t size() const; // paths added
+
+    private:
+        friend class pjson;
+
+        ProjectionNode* _newNode();
+        ProjectionNode* _clone(const ProjectionNode* aNode);
+
+    private:
+        std::deque<ProjectionNode> _vNodes; // [0] is the document root; a deque keeps pointers stable
+        std::vector<std::string> _vPaths; // to rebuild copies
+    };
+//========================================================================
+};// end namespace ByteDance
+#endif /* !PRAVEENJSON_PROJECTION_H */
@@ -0,0 +1,105 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#ifndef PRAVEENJSON_QUERY_H
+#define PRAVEENJSON_QUERY_H
+
+#include <string>
+#include <utility>
+#include <vector>
+#include "pjson.h"
+
+//
+// JSONPath queries (RFC 9535), compiled once and run against any number of
+// documents, either a pjson tree or JSON text.
+//
+//   pjson::Query oCheap("$.items[?@.price < 10 && @.tags[0] == 'sale'].name");
+//
+//   std::vector<const pjson*> vNames;
+//   oCheap.select(*pCatalog, vNames);                   // references into the tree
+//   pjson* pNames = oCheap.selectCopy(*pCatalog);       // an array of copies
+//
+//   std::vector<pjson*> vFound;
+//   oCheap.select(sText.data(), sText.size(), vFound);  // streaming, on the text
+//
+// On text nothing is built but the results: the query walks the text with
+// the same bracket matching skipper as Projection, steps over every member
+// and element it does not select, and filters read only the values they
+// compare. selectSpans() returns where each result is in the text instead.
+//
+// Supported: $, @, .name, ['name'], [N] (negative from the end), [start:end:step],
+// * and [*], unions [a,b], .. descendants, and filters with == != < <= > >=,
+// && || ! and parentheses, plus the functions length(), count(), value(),
+// match() and search(). Their I-Regexp (RFC 9485) patterns run as a Thompson
+// NFA over code points, in time linear in the string; Unicode category
+// escapes (\p{..}, \P{..}) are not supported and never match.
+//
+// Results come in the order RFC 9535 gives; members of an object, which it
+// leaves unordered, come in key order on a tree and document order on text.
+// Member names are compared with keys in their escaped form, as Projection
+// does; a name from the query is escaped only where JSON requires it (quote,
+// backslash, control characters). String values are decoded before
+// comparing, and single precision floats of a tree compare as the decimal
+// they were read from.
+//
+// A compiled Query is read-only while selecting and can be shared by any
+// number of threads.
+//
+namespace ByteDance {
+//==[Interface]============================================================
+    class pjson::Query {
+    public:
+        typedef std::pair<size_t, size_t> Span; // offset and length of a result in the text
+
+        Query();
+        explicit Query(const std::string& aPath); // see valid()
+        Query(const Query& aFrom);
+        Query& operator=(const Query& aFrom);
+        ~Query();
+
+        bool compile(const std::string& aPath); // false on a malformed query, see error()
+        bool valid() const;
+        const std::string& path() const;
+        const std::string& error() const; // what failed to compile, and where
+
+        // On a tree: references valid until the tree is next modified (appends)
+        void select(const pjson& aRoot, std::vector<const pjson*>& a_rResults) const;
+        pjson* selectCopy(const pjson& aRoot) const; // array of copies; the caller owns it
+
+        // On JSON text (appends). false when the text read on the way is
+        // malformed; results found before that are kept.
+        bool select(const char* aSrc, size_t a_iSize, std::vector<pjson*>& a_rResults) const; // caller owns
+        bool selectSpans(const char* aSrc, size_t a_iSize, std::vector<Span>& a_rResults) const;
+
+    private:
+        struct Program; // parsed segments and filter expressions
+        class Parser; // RFC 9535 grammar into a Program
+        class TextSource; // reads values in place from JSON text
+        class TreeSource; // reads values from a pjson tree
+
+        template<typename Source, typename Emit>
+        bool _run(Source& a_rSource, Emit& a_rEmit) const;
+
+    private:
+        Program* _pProgram = nullptr; // nullptr until a successful compile()
+        std::string _sPath;
+        std::string _sError;
+    };
+//========================================================================
+};// end namespace ByteDance
+#endif /* !PRAVEENJSON_QUERY_H */
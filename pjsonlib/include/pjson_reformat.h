@@ -0,0 +1,90 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#ifndef PRAVEENJSON_REFORMAT_H
+#define PRAVEENJSON_REFORMAT_H
+
+#include "pjson.h"
+
+//
+// Text to text reformatting: rewrites the whitespace of JSON text into any
+// SerializeOptions layout without building a tree. Input may arrive in
+// chunks of any size, split anywhere (even inside a string or number).
+//
+//   std::string sOut;                    // reuse across records
+//   pjson::Reformatter oMinify(sOut, pjson::SerializeOptions::Compact());
+//   while(ReadChunk(pChunk, iLength)) {
+//       oMinify.feed(pChunk, iLength);
+//       Ship(sOut); sOut.clear();
+//   }
+//   bool bOk = oMinify.finish();
+//
+// Strings, numbers and literals are copied byte for byte; commas are
+// regenerated, so only whitespace changes. Unlike toString(), object keys
+// keep their source order and duplicates are kept. Syntax is not checked
+// beyond bracket matching, so run Validate() first on untrusted input.
+// Several top level values (e.g. NDJSON) come out one per line.
+//
+namespace ByteDance {
+//==[Interface]============================================================
+    class pjson::Reformatter {
+    public:
+        explicit Reformatter(std::string& a_rOut, const SerializeOptions& aOptions = SerializeOptions()); // appends to a_rOut
+
+        Reformatter(const Reformatter&) = delete;
+        Reformatter& operator=(const Reformatter&) = delete;
+
+        // Returns false (and ignores further input) once a bracket does not match
+        bool feed(const char* aSrc, size_t a_iSize);
+        // End of input: true if everything fed was complete and balanced
+        bool finish();
+        void reset(); // ready for a new stream; the output buffer is left alone
+
+        size_t depth() const;
+
+        // One shot convenience, appends to a_rOut
+        static bool Reformat(const char* aSrc, size_t a_iSize, std::string& a_rOut, const SerializeOptions& aOptions);
+
+    private:
+        void _beforeValue();
+        void _afterValue();
+        bool _close(char aBracket);
+
+    private:
+        enum : unsigned char {
+            FrameObject = 1,
+            FrameHasItems = 2
+        };
+        enum State : unsigned char {
+            stateNone,
+            stateString,
+            stateEscape, // inside a string, just after a backslash
+            stateScalar  // inside a number or literal
+        };
+
+        SerializeOptions _oOptions;
+        std::string& _rOut;
+        std::vector<unsigned char> _vFrames;
+        State _eState = stateNone;
+        bool _bAfterKey = false;
+        bool _bComplete = false;
+        bool _bFailed = false;
+    };
+//========================================================================
+};// end namespace ByteDance
+#endif /* !PRAVEENJSON_REFORMAT_H */
@@ -0,0 +1,80 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#ifndef PRAVEENJSON_SHARED_H
+#define PRAVEENJSON_SHARED_H
+
+#include <cstdint>
+#include <memory>
+#include "pjson.h"
+
+//
+// Shared document: publishes a frozen (const, reference counted) pjson tree
+// to any number of reader threads and swaps in new versions atomically.
+// Readers only use the const accessors, which never mutate, and keep the
+// version they are reading alive until they move on.
+//
+//   pjson::SharedDocument oConfig(pjson::CreateFromString(sJson));
+//
+//   // worker thread
+//   pjson::SharedDocument::Reader oReader(oConfig);
+//   const pjson& rConfig = oReader.get();     // cheap when nothing changed
+//   int iLimit = rConfig["limits"]["max"].getInt();
+//
+//   // reload thread
+//   oConfig.publish(pjson::CreateFromString(sNewJson));
+//
+// A frozen tree must not be modified. To derive the next version, copy it
+// (O(1) when it is in copy-on-write mode), edit the copy and publish that.
+//
+namespace ByteDance {
+//==[Interface]============================================================
+    class pjson::SharedDocument {
+    public:
+        typedef std::shared_ptr<const pjson> Ptr;
+
+        SharedDocument();
+        explicit SharedDocument(pjson* aDoc); // takes ownership
+
+        SharedDocument(const SharedDocument&) = delete;
+        SharedDocument& operator=(const SharedDocument&) = delete;
+
+        void publish(pjson* aDoc); // takes ownership; nullptr publishes an empty document
+        void publish(const Ptr& aDoc);
+        Ptr load() const; // current version, kept alive by the returned pointer
+        uint64_t version() const; // bumped by every publish()
+
+        // Per-thread cursor: re-reads the shared pointer only after a publish()
+        class Reader {
+        public:
+            explicit Reader(const SharedDocument& aDoc);
+            const pjson& get(); // valid until the next get() on this reader
+            const Ptr& ptr();
+        private:
+            const SharedDocument& _rDoc;
+            Ptr _pCurrent;
+            uint64_t _iVersion;
+        };
+
+    private:
+        Ptr _pDoc; // accessed only through std::atomic_load / std::atomic_store
+        std::atomic<uint64_t> _iVersion;
+    };
+//========================================================================
+};// end namespace ByteDance
+#endif /* !PRAVEENJSON_SHARED_H */
@@ -0,0 +1,118 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#ifndef PRAVEENJSON_STATS_H
+#define PRAVEENJSON_STATS_H
+
+#include <chrono>
+#include <cstdint>
+#include "pjson.h"
+
+//
+// Parse / serialize instrumentation. Counting is compiled in only when the
+// library is built with PJSON_ENABLE_STATS (cmake -DPJSON_ENABLE_STATS=ON);
+// otherwise the hooks below expand to nothing and Current() stays zero.
+//
+// Counters are per thread and accumulate until Reset(), so per call figures
+// are taken with a Reset() before the call:
+//
+//   pjson::Stats::Reset();
+//   pjson* pDoc = pjson::CreateFromString(sPayload);
+//   const pjson::Stats& rStats = pjson::Stats::Current();
+//   if(rStats.iMaxDepth > 64 || rStats.iAllocations > 100000) { ... }
+//
+namespace ByteDance {
+//==[Interface]============================================================
+    struct pjson::Stats {
+        uint64_t iNodes[jsonType::jsonMap + 1]; // nodes created by the parser, by jsonType
+        uint64_t iAllocations;     // heap allocations made by resetTo() and the parser
+        uint64_t iAllocatedBytes;  // their approximate size
+        uint64_t iStringBytes;     // string and key bytes copied from the source
+        uint64_t iMaxDepth;        // deepest array / object nesting seen
+        uint64_t iParseCalls;
+        uint64_t iParsedBytes;
+        uint64_t iScanNanos;       // parse time not spent in the two phases below
+        uint64_t iNumberNanos;     // number conversion
+        uint64_t iInsertNanos;     // adding values to arrays and maps
+        uint64_t iSerializeCalls;
+        uint64_t iSerializedBytes;
+        uint64_t iSerializeNanos;
+
+        static Stats& Current(); // this thread's counters
+        static void Reset();
+        static bool Enabled(); // built with PJSON_ENABLE_STATS
+    };
+
+//==[Implementation]=======================================================
+#ifdef PJSON_ENABLE_STATS
+    typedef std::chrono::steady_clock pjsonStatsClock;
+
+    inline uint64_t pjsonStatsNanos(pjsonStatsClock::time_point aFrom) {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(pjsonStatsClock::now() - aFrom).count();
+    }
+
+    // Adds the elapsed time of its scope to one counter
+    class pjsonStatsTimer {
+    public:
+        explicit pjsonStatsTimer(uint64_t& a_rNanos) : _rNanos(a_rNanos), _tStart(pjsonStatsClock::now()) {}
+        ~pjsonStatsTimer() { _rNanos += pjsonStatsNanos(_tStart); }
+    private:
+        uint64_t& _rNanos;
+        pjsonStatsClock::time_point _tStart;
+    };
+
+    // One top level parse; time not spent in number / insert phases is scan time
+    class pjsonStatsParse {
+    public:
+        explicit pjsonStatsParse(size_t a_iBytes)
+            : _rStats(pjson::Stats::Current())
+            , _iPhaseNanos(_rStats.iNumberNanos + _rStats.iInsertNanos)
+            , _tStart(pjsonStatsClock::now()) {
+            ++_rStats.iParseCalls;
+            _rStats.iParsedBytes += a_iBytes;
+        }
+        ~pjsonStatsParse() {
+            uint64_t iTotal = pjsonStatsNanos(_tStart);
+            uint64_t iPhases = _rStats.iNumberNanos + _rStats.iInsertNanos - _iPhaseNanos;
+            _rStats.iScanNanos += (iTotal > iPhases) ? (iTotal - iPhases) : 0;
+        }
+    private:
+        pjson::Stats& _rStats;
+        uint64_t _iPhaseNanos;
+        pjsonStatsClock::time_point _tStart;
+    };
+
+    #define PJSON_STATS_NODE(TYPE)          (++pjson::Stats::Current().iNodes[TYPE])
+    #define PJSON_STATS_ALLOC(BYTES)        do { pjson::Stats& rStats_ = pjson::Stats::Current(); \
+                                                 ++rStats_.iAllocations; rStats_.iAllocatedBytes += (BYTES); } while(0)
+    #define PJSON_STATS_ADD(FIELD, COUNT)   (pjson::Stats::Current().FIELD += (COUNT))
+    #define PJSON_STATS_TIMER(FIELD)        pjsonStatsTimer oStatsTimer_(pjson::Stats::Current().FIELD)
+    #define PJSON_STATS_DEPTH(DEPTH)        do { pjson::Stats& rStats_ = pjson::Stats::Current(); \
+                                                 if((DEPTH) > rStats_.iMaxDepth) { rStats_.iMaxDepth = (DEPTH); } } while(0)
+    #define PJSON_STATS_PARSE(BYTES)        pjsonStatsParse oStatsParse_(BYTES)
+#else
+    #define PJSON_STATS_NODE(TYPE)          ((void)0)
+    #define PJSON_STATS_ALLOC(BYTES)        ((void)0)
+    #define PJSON_STATS_ADD(FIELD, COUNT)   ((void)0)
+    #define PJSON_STATS_TIMER(FIELD)        ((void)0)
+    #define PJSON_STATS_DEPTH(DEPTH)        ((void)0)
+    #define PJSON_STATS_PARSE(BYTES)        ((void)0)
+#endif
+//========================================================================
+};// end namespace ByteDance
+#endif /* !PRAVEENJSON_STATS_H */
@@ -0,0 +1,194 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#ifndef PRAVEENJSON_STREAM_H
+#define PRAVEENJSON_STREAM_H
+
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <thread>
+#include "pjson.h"
+
+//
+// Streaming input: read (optionally compressed) files in bounded chunks and
+// parse the records they hold one at a time, so memory stays at one chunk
+// plus one record instead of the whole decompressed file.
+//
+//   pjson::InputStream* pFile = pjson::InputStream::Open("events.ndjson.gz"); // gzip / zstd detected
+//   pjson::PrefetchStream oPrefetch(*pFile);    // optional: decompress on another thread
+//   pjson::RecordReader oReader(oPrefetch);
+//   while(pjson* pRecord = oReader.next()) {
+//       ...
+//       delete pRecord;
+//   }
+//   if(oReader.failed()) { ... }
+//   delete pFile;
+//
+// gzip needs zlib and zstd needs libzstd when the library is built (both
+// are picked up by CMake when found, see PJSON_WITH_ZLIB / PJSON_WITH_ZSTD).
+// InputStream::Supports() reports what is compiled in.
+//
+namespace ByteDance {
+//==[Interface]============================================================
+    class pjson::InputStream {
+    public:
+        enum Compression : int {
+            compressionNone,
+            compressionGzip, // gzip or zlib
+            compressionZstd
+        };
+
+        virtual ~InputStream() {}
+        // Copies up to a_iSize bytes into aBuffer; 0 only at the end of input
+        // (or on error, see failed())
+        virtual size_t read(char* aBuffer, size_t a_iSize) = 0;
+        virtual bool failed() const = 0;
+
+        // Opens a file, detecting gzip / zstd from its first bytes. Returns
+        // nullptr if the file cannot be opened or its format is not compiled in.
+        static InputStream* Open(const char* aPath);
+        // Reads from an open FILE* (e.g. stdin); the FILE* is not closed
+        static InputStream* FromFile(FILE* a_pFile);
+        // Reads a caller owned buffer, e.g. a compressed HTTP body
+        static InputStream* FromMemory(const char* aData, size_t a_iSize);
+        // Decompresses a_pSource, which the returned stream owns. Returns
+        // nullptr (and deletes a_pSource) if the format is not compiled in.
+        static InputStream* Decompress(InputStream* a_pSource, Compression aeCompression);
+        static bool Supports(Compression aeCompression);
+    };
+
+    // Reads its source ahead on a background thread into a ring of a_iChunks
+    // buffers of a_iChunkSize bytes (rounded up to whole 4 KB pages, page
+    // aligned), so reading and decompression overlap with parsing on the
+    // calling thread. For bulk loads from fast disks use a few MB per chunk.
+    class pjson::PrefetchStream : public pjson::InputStream {
+    public:
+        explicit PrefetchStream(InputStream& a_rSource, size_t a_iChunkSize = 256 * 1024, size_t a_iChunks = 4);
+        ~PrefetchStream() override; // stops and joins the reader thread
+
+        PrefetchStream(const PrefetchStream&) = delete;
+        PrefetchStream& operator=(const PrefetchStream&) = delete;
+
+        size_t read(char* aBuffer, size_t a_iSize) override;
+        bool failed() const override;
+
+        // Where the time goes. iWaitNanos high: the consumer is starved, add
+        // chunks or I/O bandwidth. iReaderWaitNanos high: parsing is the
+        // bottleneck and the read-ahead already hides the I/O.
+        struct Stats {
+            uint64_t iBytes = 0;           // handed to the consumer
+            uint64_t iChunks = 0;          // filled by the reader thread
+            uint64_t iReadNanos = 0;       // reader thread inside the source's read()
+            uint64_t iReaderWaitNanos = 0; // reader thread waiting for a free buffer
+            uint64_t iWaits = 0;           // read() calls that found no data ready
+            uint64_t iWaitNanos = 0;       // consumer blocked in read() waiting for data
+            uint64_t iConsumeNanos = 0;    // consumer time between read() calls (parsing)
+        };
+        Stats stats() const; // call from the consuming thread
+
+    private:
+        void _produce();
+
+    private:
+        InputStream& _rSource;
+        std::vector<char> _vStorage; // all chunks, one block
+        char* _pChunks;              // first page aligned byte of _vStorage
+        size_t _iChunkSize;
+        std::vector<size_t> _vSizes; // bytes filled per chunk
+        // Ring: the reader fills _iHead, the consumer reads from _iTail.
+        // _iFilled counts chunks between them, including the one being read.
+        size_t _iHead = 0;
+        size_t _iTail = 0;
+        size_t _iFilled = 0;
+        bool _bReading = false;      // the consumer is inside chunk _iTail
+        size_t _iTailPos = 0;
+        mutable std::mutex _oMutex;
+        std::condition_variable _oCondition;
+        bool _bEnd = false;  // the source is exhausted
+        bool _bStop = false;
+        bool _bFailed = false;
+        Stats _oReaderStats;   // reader thread fields, under _oMutex
+        Stats _oConsumerStats; // consumer fields, owned by the reading thread
+        uint64_t _iLastReturn = 0;
+        std::thread _oThread;
+    };
+
+    // Splits a stream into records and parses each one on its own. Records
+    // are top level values (NDJSON or simply concatenated JSON) or, when the
+    // input is a single top level array, its elements.
+    class pjson::RecordReader {
+    public:
+        enum Mode : int {
+            modeAuto,   // modeArray if the input starts with '[', else modeValues
+            modeValues, // every top level value is a record
+            modeArray   // the input is one array; every element is a record
+        };
+
+        explicit RecordReader(InputStream& a_rSource, Mode aeMode = modeAuto, size_t a_iChunkSize = 64 * 1024);
+
+        RecordReader(const RecordReader&) = delete;
+        RecordReader& operator=(const RecordReader&) = delete;
+
+        // Next parsed record, nullptr at the end of input or on error
+        pjson* next();
+        pjson* next(ParseContext& a_rContext);
+        // Next record as text, valid until the following call; false at the
+        // end of input or on error. Lets callers Validate() or bind records.
+        bool nextText(const char*& a_rText, size_t& a_rLength);
+
+        bool failed() const;      // bad framing, a record that did not parse, or a read error
+        size_t records() const;   // records returned so far
+        size_t offset() const;    // decompressed byte offset of the last record returned
+        void setMaxRecordSize(size_t a_iBytes); // larger records fail; default 256 MB
+        // next() builds only these fields (see pjson_projection.h); nullptr for
+        // whole records. aFields must outlive its use here.
+        void setProjection(const Projection* aFields);
+
+    private:
+        bool _fill();
+        bool _scanRecord(size_t& a_rEnd);
+        pjson* _parseNext(ParseContext* a_pContext);
+
+    private:
+        InputStream& _rSource;
+        Mode _eMode;
+        size_t _iChunkSize;
+        size_t _iMaxRecordSize;
+        std::vector<char> _vBuffer;
+        size_t _iBegin = 0;       // first unconsumed byte in _vBuffer
+        size_t _iDiscarded = 0;   // bytes dropped from the front of _vBuffer so far
+        size_t _iOffset = 0;
+        size_t _iRecords = 0;
+        // record scanner state, kept across refills
+        size_t _iScan = 0;        // next byte to scan, an index into _vBuffer (never before _iBegin)
+        size_t _iDepth = 0;
+        bool _bInRecord = false;
+        bool _bInString = false;
+        bool _bEscape = false;
+        bool _bScalar = false;
+        bool _bStarted = false;   // modeArray: the opening '[' has been consumed
+        bool _bClosed = false;    // modeArray: the closing ']' has been consumed
+        bool _bEof = false;
+        bool _bFailed = false;
+        const Projection* _pProjection = nullptr;
+    };
+//========================================================================
+};// end namespace ByteDance
+#endif /* !PRAVEENJSON_STREAM_H */
@@ -0,0 +1,218 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#ifndef PRAVEENJSON_TRACE_H
+#define PRAVEENJSON_TRACE_H
+
+#include <chrono>
+#include <cstdint>
+#include "pjson.h"
+
+//
+// Trace spans around CreateFromString(), toString(), copyFrom() and the
+// destruction of large arrays / objects, for attributing latency in
+// production. Compiled in only when the library is built with
+// PJSON_ENABLE_TRACE (cmake -DPJSON_ENABLE_TRACE=ON); otherwise the hooks
+// below expand to nothing.
+//
+// In a trace build each span is reported to the installed Listener and, when
+// <sys/sdt.h> was found, fired as a USDT probe of provider "pjson":
+//
+//   parse__start(bytes)                      parse__done(bytes, nodes, nanos, ok)
+//   serialize__done(bytes, nodes, nanos)     copy__done(nodes, nanos)
+//   destroy__done(nodes, nanos)
+//
+//   bpftrace -e 'usdt:./libpjson.so:pjson:parse__done { @us = hist(arg2 / 1000); }'
+//
+// While nobody listens (no Listener and no probe attached) a span costs one
+// check and takes no timestamps. Node counts come from a walk of the tree,
+// which is only done while someone listens.
+//
+//   class LatencyLog : public pjson::Trace::Listener {
+//       void onEnd(const pjson::Trace::Span& aSpan) override { ... }
+//   };
+//   LatencyLog oLog;
+//   pjson::Trace::SetListener(&oLog);
+//
+namespace ByteDance {
+//==[Interface]============================================================
+    struct pjson::Trace {
+        enum Event : int {
+            eventParse,     // CreateFromString()
+            eventSerialize, // toString() and SerializeCache
+            eventCopy,      // copyFrom() and the copy constructor / assignment
+            eventDestroy    // freeing an array / object with at least DestroyThreshold() children
+        };
+
+        struct Span {
+            Event eEvent;
+            uint64_t iBytes; // parse: input size, serialize: output size, otherwise 0
+            uint64_t iNodes; // nodes parsed, written, copied or freed
+            uint64_t iNanos; // 0 in onBegin()
+            bool bSuccess;   // false only for a failed parse
+        };
+
+        // Called on the thread doing the work; must not call back into the traced operation
+        class Listener {
+        public:
+            virtual ~Listener() {}
+            virtual void onBegin(const Span& aSpan) { (void)aSpan; } // iBytes set for parse only
+            virtual void onEnd(const Span& aSpan) = 0;
+        };
+
+        // nullptr removes it; the Listener must stay alive until spans already started have ended
+        static void SetListener(Listener* a_pListener);
+        static Listener* GetListener();
+        static void SetDestroyThreshold(size_t a_iChildren); // default 1024 direct children
+        static size_t DestroyThreshold();
+        static bool Enabled(); // built with PJSON_ENABLE_TRACE
+        static bool Probes();  // built with USDT probes
+        static bool Active();  // a Listener is set or a probe is attached
+        static const char* Name(Event aeEvent);
+
+    private:
+        friend class pjsonTraceSpan;
+        static void _Begin(const Span& aSpan);
+        static void _End(const Span& aSpan);
+    };
+
+//==[Implementation]=======================================================
+#ifdef PJSON_ENABLE_TRACE
+    // Times one operation and reports it, if anyone listens when it starts.
+    // Nodes are counted outside the timed part.
+    class pjsonTraceSpan {
+    public:
+        pjsonTraceSpan(pjson::Trace::Event aeEvent, uint64_t a_iBytes, bool a_bWanted = true)
+            : _bActive(a_bWanted && pjson::Trace::Active()) {
+            if(_bActive) {
+                _oSpan.eEvent = aeEvent;
+                _oSpan.iBytes = a_iBytes;
+                _oSpan.iNodes = 0;
+                _oSpan.iNanos = 0;
+                _oSpan.bSuccess = true;
+                pjson::Trace::_Begin(_oSpan);
+                _tStart = std::chrono::steady_clock::now();
+            }
+        }
+        bool active() const { return _bActive; }
+        pjson::Trace::Span& span() { return _oSpan; }
+        void stop() {
+            _oSpan.iNanos = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - _tStart).count();
+        }
+        void report() { pjson::Trace::_End(_oSpan); }
+
+        static uint64_t CountNodes(const pjson* a_pNode); // 0 for nullptr
+    private:
+        const bool _bActive;
+        pjson::Trace::Span _oSpan;
+        std::chrono::steady_clock::time_point _tStart;
+    };
+
+    // CreateFromString: a_rResult is read when the scope ends
+    class pjsonTraceParse {
+    public:
+        pjsonTraceParse(size_t a_iBytes, pjson* const& a_rResult) : _oSpan(pjson::Trace::eventParse, a_iBytes), _rResult(a_rResult) {}
+        ~pjsonTraceParse() {
+            if(_oSpan.active()) {
+                _oSpan.stop();
+                _oSpan.span().iNodes = pjsonTraceSpan::CountNodes(_rResult);
+                _oSpan.span().bSuccess = (nullptr != _rResult);
+                _oSpan.report();
+            }
+        }
+    private:
+        pjsonTraceSpan _oSpan;
+        pjson* const& _rResult;
+    };
+
+    // toString: the bytes appended to a_rOut after a_iStart
+    class pjsonTraceSerialize {
+    public:
+        pjsonTraceSerialize(const pjson& aNode, const std::string& a_rOut, size_t a_iStart)
+            : _oSpan(pjson::Trace::eventSerialize, 0), _rNode(aNode), _rOut(a_rOut), _iStart(a_iStart) {}
+        ~pjsonTraceSerialize() {
+            if(_oSpan.active()) {
+                _oSpan.stop();
+                _oSpan.span().iBytes = _rOut.length() - _iStart;
+                _oSpan.span().iNodes = pjsonTraceSpan::CountNodes(&_rNode);
+                _oSpan.report();
+            }
+        }
+    private:
+        pjsonTraceSpan _oSpan;
+        const pjson& _rNode;
+        const std::string& _rOut;
+        const size_t _iStart;
+    };
+
+    // copyFrom: counts the copy once it is complete
+    class pjsonTraceCopy {
+    public:
+        explicit pjsonTraceCopy(const pjson& aCopy) : _oSpan(pjson::Trace::eventCopy, 0), _rCopy(aCopy) {}
+        ~pjsonTraceCopy() {
+            if(_oSpan.active()) {
+                _oSpan.stop();
+                _oSpan.span().iNodes = pjsonTraceSpan::CountNodes(&_rCopy);
+                _oSpan.report();
+            }
+        }
+    private:
+        pjsonTraceSpan _oSpan;
+        const pjson& _rCopy;
+    };
+
+    // Freeing a large container: counted before it goes, and only the
+    // outermost large container on the thread is reported
+    class pjsonTraceDestroy {
+    public:
+        pjsonTraceDestroy(const pjson& aNode, size_t a_iChildren)
+            : _bClaimed(_Claim(a_iChildren))
+            , _iNodes(_bClaimed ? pjsonTraceSpan::CountNodes(&aNode) : 0)
+            , _oSpan(pjson::Trace::eventDestroy, 0, _bClaimed) {}
+        ~pjsonTraceDestroy() {
+            if(_oSpan.active()) {
+                _oSpan.stop();
+                _oSpan.span().iNodes = _iNodes;
+                _oSpan.report();
+            }
+            if(_bClaimed) {
+                _Release();
+            }
+        }
+    private:
+        static bool _Claim(size_t a_iChildren);
+        static void _Release();
+
+        const bool _bClaimed;
+        const uint64_t _iNodes;
+        pjsonTraceSpan _oSpan;
+    };
+
+    #define PJSON_TRACE_PARSE(BYTES, RESULT)          pjsonTraceParse oTraceParse_((BYTES), (RESULT))
+    #define PJSON_TRACE_SERIALIZE(NODE, OUT, START)   pjsonTraceSerialize oTraceSerialize_((NODE), (OUT), (START))
+    #define PJSON_TRACE_COPY(COPY)                    pjsonTraceCopy oTraceCopy_(COPY)
+    #define PJSON_TRACE_DESTROY(NODE, CHILDREN)       pjsonTraceDestroy oTraceDestroy_((NODE), (CHILDREN))
+#else
+    #define PJSON_TRACE_PARSE(BYTES, RESULT)          ((void)0)
+    #define PJSON_TRACE_SERIALIZE(NODE, OUT, START)   ((void)0)
+    #define PJSON_TRACE_COPY(COPY)                    ((void)0)
+    #define PJSON_TRACE_DESTROY(NODE, CHILDREN)       ((void)0)
+#endif
+//========================================================================
+};// end namespace ByteDance
+#endif /* !PRAVEENJSON_TRACE_H */
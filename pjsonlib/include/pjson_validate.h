@@ -0,0 +1,68 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#ifndef PRAVEENJSON_VALIDATE_H
+#define PRAVEENJSON_VALIDATE_H
+
+#include <cstddef>
+#include "pjson.h"
+
+//
+// Validate-only check: scans the text once against strict RFC 8259 JSON
+// (well-formed UTF-8, exact literals, no trailing commas or garbage) without
+// building a tree and without allocating.
+//
+//   pjson::ValidateResult oResult = pjson::Validate(pMsg, iLength);
+//   if(!oResult) {
+//       LOG("bad payload: %s at byte %zu", pjson::ValidateResult::ErrorName(oResult.eError), oResult.iOffset);
+//   }
+//
+// The check is stricter than CreateFromString(), which also accepts lenient
+// forms such as unquoted literals in any case, missing commas or "+1".
+// Nesting is limited to GetMaxParseDepth() levels, and never more than
+// MaxLevels, the size of the fixed bit stack the scanner keeps.
+//
+namespace ByteDance {
+//==[Interface]============================================================
+    struct pjson::ValidateResult {
+        enum Error : int {
+            errNone,
+            errEmpty,          // nothing but whitespace
+            errUnexpectedEnd,  // input ends inside a value
+            errUnexpectedChar, // a byte that cannot start / continue the current token
+            errInvalidLiteral, // not exactly true, false or null
+            errInvalidNumber,
+            errInvalidEscape,
+            errControlChar,    // unescaped byte below 0x20 inside a string
+            errInvalidUtf8,
+            errTooDeep,
+            errTrailingData    // more text after the top level value
+        };
+        static const size_t MaxLevels = 4096;
+
+        Error eError = errNone;
+        size_t iOffset = 0;   // byte offset of the error, or the input size on success
+        size_t iDepth = 0;    // nesting depth at the error, or the deepest level on success
+        size_t iElements = 0; // values (including arrays, objects and nested values) scanned
+
+        explicit operator bool() const { return errNone == eError; }
+        static const char* ErrorName(Error aeError);
+    };
+//========================================================================
+};// end namespace ByteDance
+#endif /* !PRAVEENJSON_VALIDATE_H */
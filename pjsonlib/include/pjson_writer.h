@@ -0,0 +1,114 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#ifndef PRAVEENJSON_WRITER_H
+#define PRAVEENJSON_WRITER_H
+
+#include <ostream>
+#include <type_traits>
+#include "pjson.h"
+
+//
+// Streaming writer: emits JSON text directly, without building a pjson tree.
+// Output uses the same layout, number formatting and string handling as
+// pjson::toString(); pass SerializeOptions::Compact() / Pretty() for the
+// other layouts (styleLegacyPretty is written as styleLegacy).
+//
+//   std::string sBuffer;                 // reuse across responses
+//   pjson::Writer oWriter(sBuffer);
+//   oWriter.startObject()
+//              .key("id").value(7)
+//              .key("tags").startArray().value("a").value("b").endArray()
+//              .key("config").value(oConfig)   // embeds an existing tree
+//          .endObject();
+//
+// Like operator=(const char*), value() writes strings as given, so they must
+// already be JSON-escaped. valueEscaped() escapes raw text (see EncodeForJSON).
+//
+namespace ByteDance {
+//==[Interface]============================================================
+    class pjson::Writer {
+    public:
+        explicit Writer(std::string& a_rBuffer, const SerializeOptions& aOptions = SerializeOptions()); // appends to a_rBuffer
+        explicit Writer(std::ostream& a_rStream, size_t a_iFlushSize = 64 * 1024,
+                        const SerializeOptions& aOptions = SerializeOptions());
+        ~Writer(); // flushes to the stream
+
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        Writer& startObject();
+        Writer& endObject();
+        Writer& startArray();
+        Writer& endArray();
+
+        Writer& key(const char* aKey);
+        Writer& key(const char* aKey, size_t a_iLength);
+        Writer& key(const std::string& aKey);
+
+        Writer& value(const char* aValue);
+        Writer& value(const char* aValue, size_t a_iLength);
+        Writer& value(const std::string& aValue);
+        Writer& value(const int aValue);
+        Writer& value(const int64_t aValue);
+        Writer& value(const unsigned aValue);
+        Writer& value(const uint64_t aValue);
+        // Any other integer type (long long, short, char ...), so that e.g.
+        // value(vItems.size()) is never ambiguous
+        template<typename T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value, int>::type = 0>
+        Writer& value(const T aValue) {
+            return std::is_signed<T>::value ? value(static_cast<int64_t>(aValue)) : value(static_cast<uint64_t>(aValue));
+        }
+        Writer& value(const float aValue);
+        Writer& value(const double aValue); // %.17g, round-trips exactly
+        Writer& value(const bool aValue);
+        Writer& value(const pjson& aValue); // embeds an existing subtree
+        Writer& valueEscaped(const char* data, size_t length);
+        Writer& nullValue();
+        Writer& rawValue(const char* aJson, size_t a_iLength); // pre-serialized JSON
+
+        void flush(); // stream mode: hands buffered bytes to the stream
+        void reset(); // forgets nesting state; stream mode also drops unflushed bytes
+
+        size_t depth() const;
+        bool isComplete() const; // a full top level value has been written
+        const std::string& buffer() const;
+
+    private:
+        void _beforeValue();
+        void _afterValue();
+        void _close(char aBracket);
+
+    private:
+        enum : unsigned char {
+            WriterFrameObject = 1,
+            WriterFrameHasItems = 2
+        };
+
+        SerializeOptions _oOptions;
+        std::string _sOwned;
+        std::string* _pOut;
+        std::ostream* _pStream;
+        size_t _iFlushSize;
+        std::vector<unsigned char> _vFrames;
+        bool _bAfterKey = false;
+        bool _bComplete = false;
+    };
+//========================================================================
+};// end namespace ByteDance
+#endif /* !PRAVEENJSON_WRITER_H */
@@ -17,33 +17,110 @@
 // License: Apache 2.0
 //
 #include "pjson.h"
+#include "pjson_cache.h"
+#include "pjson_context.h"
+#include "pjson_projection.h"
+#include "pjson_simd.h"
+#include "pjson_stats.h"
+#include "pjson_trace.h"
+#ifndef PJSON_INLINE
+#include "pjson_inline.h" // the hot accessors, defined out of line here
+#endif
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
 using namespace ByteDance;
 
+//-----------------------------------------------------------------
+// Case-insensitive keyword match, same rules as _ScanBool/_ScanNull
+/*static*/
+size_t pjson::_MatchLiteral(const char* aSrc, size_t a_iStart, size_t a_iEnd, const char* aLiteral, size_t a_iLength) {
+    if((a_iEnd - a_iStart) < a_iLength) {
+        return 0;
+    }
+    for(size_t i = 0; i < a_iLength; ++i) {
+        if(tolower(aSrc[a_iStart + i]) != aLiteral[i]) {
+            return 0;
+        }
+    }
+    return a_iLength;
+}
+
+//-----------------------------------------------------------------
+// Strict JSON number grammar; lenient forms (+1, .5, 01) are kept converted
+// so that raw numbers are always written back as valid JSON
+static bool _IsJsonNumber(const char* aText, size_t a_iLength) {
+    size_t i = 0;
+    auto fnDigits = [&]() {
+        size_t iFrom = i;
+        while(i < a_iLength && '0' <= aText[i] && '9' >= aText[i]) {
+            ++i;
+        }
+        return i - iFrom;
+    };
+    if(i < a_iLength && '-' == aText[i]) {
+        ++i;
+    }
+    if(i < a_iLength && '0' == aText[i]) {
+        ++i;
+    } else if(0 == fnDigits()) {
+        return false;
+    }
+    if(i < a_iLength && '.' == aText[i]) {
+        ++i;
+        if(0 == fnDigits()) {
+            return false;
+        }
+    }
+    if(i < a_iLength && ('e' == aText[i] || 'E' == aText[i])) {
+        ++i;
+        if(i < a_iLength && ('+' == aText[i] || '-' == aText[i])) {
+            ++i;
+        }
+        if(0 == fnDigits()) {
+            return false;
+        }
+    }
+    return i == a_iLength;
+}
+
 //-----------------------------------------------------------------
 pjson::pjson()
         : _eType(jsonType::jsonNull)
         , _pValueRaw(nullptr)
+        , _pShareCount(nullptr)
 {
 
 }
 //-----------------------------------------------------------------
 pjson::~pjson() {
+    _iCacheSlot.store(0, std::memory_order_relaxed); // the parent is changing as well
     reset();
 }
 //-----------------------------------------------------------------
 pjson::pjson(const pjson& aFrom)
         : _eType(jsonType::jsonNull)
         , _pValueRaw(nullptr)
+        , _pShareCount(nullptr)
 {
     copyFrom(aFrom);
 }
 //-----------------------------------------------------------------
 // Move constructor
-pjson::pjson(pjson&& aFrom) {
+pjson::pjson(pjson&& aFrom)
+        : _pShareCount(nullptr)
+{
     _eType = aFrom._eType;
     _pValueRaw = aFrom._pValueRaw;
+    _pShareCount = aFrom._pShareCount.exchange(nullptr);
+    _iFlags = aFrom._iFlags;
+    _moveCaches(aFrom);
     aFrom._pValueRaw = nullptr;
     aFrom._eType = jsonType::jsonNull;
+    aFrom._iFlags = 0;
 }
 //-----------------------------------------------------------------
 // Move assignment
@@ -54,9 +131,13 @@ pjson& pjson::operator=(pjson&& aFrom) {
     reset();
     _eType = aFrom._eType;
     _pValueRaw = aFrom._pValueRaw;
+    _pShareCount = aFrom._pShareCount.exchange(nullptr);
+    _iFlags = aFrom._iFlags;
+    _moveCaches(aFrom);
 
     aFrom._eType = jsonType::jsonNull;
     aFrom._pValueRaw = nullptr;
+    aFrom._iFlags = 0;
 
     return *this;
 }
@@ -71,71 +152,28 @@ pjson& pjson::operator=(const pjson& aFrom) {
     return *this;
 }
 //-----------------------------------------------------------------
-pjson::jsonType pjson::getType() const {
-    return _eType;
-};
-//-----------------------------------------------------------------
-pjson::PJSONARRAY* pjson::getArray() {
-    if(_eType == jsonType::jsonArray) {
-        return _pValueArray;
-    }
-    return nullptr;
-}
-//-----------------------------------------------------------------
-pjson::PJSONMAP* pjson::getMap() {
-    if(_eType == jsonType::jsonMap) {
-        return _pValueMap;
-    }
-    return nullptr;
-}
-//-----------------------------------------------------------------
-float pjson::getFloat() {
-    if(_eType == jsonType::jsonNumberInt) {
-        return float(*_pValueInt);
-    } else if(_eType == jsonType::jsonNumberFloat) {
-        return *_pValueFloat;
-    }
-    return 0.0f;
-}
-//-----------------------------------------------------------------
-int pjson::getInt() {
-    if(_eType == jsonType::jsonNumberInt) {
-        return *_pValueInt;
-    } else if(_eType == jsonType::jsonNumberFloat) {
-        return int(*_pValueFloat);
-    }
-    return 0;
+void pjson::setInt64(int64_t aValue) {
+    std::string sText;
+    _AppendInt(sText, aValue);
+    _setRawNumber(jsonType::jsonNumberInt, sText.data(), sText.length());
 }
 //-----------------------------------------------------------------
-bool pjson::getBool() {
-    switch (_eType) {
-        case jsonType::jsonNull: {
-            return false;
-        }
-        case jsonType::jsonString: {
-            return (_pValueString->length() > 0);
-        }
-        case jsonType::jsonNumberInt: {
-            return bool(*_pValueInt);
-        }
-        case jsonType::jsonNumberFloat: {
-            return bool(*_pValueFloat);
-        }
-        case jsonType::jsonBoolean: {
-            return (*_pValueBool);
-        }
-            break;
-        case jsonType::jsonArray:
-        case jsonType::jsonMap:
-        default:
-            return false;
-            break;
+void pjson::setDouble(double aValue) {
+    if(!std::isfinite(aValue)) {
+        reset(); // not representable in JSON
+        return;
     }
-    return false;
+    std::string sText;
+    _AppendDouble(sText, aValue);
+    _setRawNumber(jsonType::jsonNumberFloat, sText.data(), sText.length());
 }
 //-----------------------------------------------------------------
-std::string pjson::getString() {
-    return (_eType == jsonType::jsonString)? (*_pValueString): "";
+void pjson::_setRawNumber(jsonType aeType, const char* aText, size_t a_iLength) {
+    _releaseValue();
+    _pValueString = new std::string(aText, a_iLength);
+    PJSON_STATS_ALLOC(sizeof(std::string));
+    _eType = aeType;
+    _iFlags = FlagRawNumber;
 }
 //-----------------------------------------------------------------
 void pjson::reset() {
@@ -143,19 +181,41 @@ void pjson::reset() {
 }
 //-----------------------------------------------------------------
 void pjson::_resetIfneeded(jsonType aeType) {
-    if(_eType != aeType) {
+    if(_eType != aeType || (_iFlags & FlagRawNumber)) {
         resetTo(aeType);
+    } else {
+        _detach();
     }
 }
 //-----------------------------------------------------------------
-void pjson::resetTo(pjson::jsonType aeType) {
+void pjson::_releaseValue() {
+    _dropCaches();
+    _iCacheFlags.fetch_and(static_cast<unsigned char>(~CacheCoversChildren), std::memory_order_relaxed);
+    std::atomic<int>* pCount = _pShareCount.exchange(nullptr);
+    if(pCount) {
+        if(1 != pCount->fetch_sub(1, std::memory_order_acq_rel)) {
+            // still used by other nodes
+            _pValueRaw = nullptr;
+            _iFlags = 0;
+            return;
+        }
+        delete pCount;
+    }
+
     switch(_eType) {
         case jsonType::jsonNull:         { _pValueRaw = nullptr; break; }
         case jsonType::jsonString:       { delete _pValueString;  break; }
-        case jsonType::jsonNumberInt:    { delete _pValueInt;     break; }
-        case jsonType::jsonNumberFloat:  { delete _pValueFloat;   break; }
+        case jsonType::jsonNumberInt:    {
+            if(_iFlags & FlagRawNumber) { delete _pValueString; } else { delete _pValueInt; }
+            break;
+        }
+        case jsonType::jsonNumberFloat:  {
+            if(_iFlags & FlagRawNumber) { delete _pValueString; } else { delete _pValueFloat; }
+            break;
+        }
         case jsonType::jsonBoolean:      { delete _pValueBool;    break; }
         case jsonType::jsonArray:  {
+            PJSON_TRACE_DESTROY(*this, _pValueArray->size());
             for(pjson* pj : *_pValueArray) {
                 delete pj;
             }
@@ -163,6 +223,7 @@ void pjson::resetTo(pjson::jsonType aeType) {
             break;
         }
         case jsonType::jsonMap: {
+            PJSON_TRACE_DESTROY(*this, _pValueMap->size());
             for (const auto& kv : *_pValueMap) {
                 delete kv.second;
             }
@@ -171,20 +232,40 @@ void pjson::resetTo(pjson::jsonType aeType) {
         }
     }//end switch
     _pValueRaw = nullptr;
+    _iFlags = 0;
+}
+//-----------------------------------------------------------------
+void pjson::resetTo(pjson::jsonType aeType) {
+    _releaseValue();
 
     switch(aeType) {
         case jsonType::jsonNull:         { /* _pValueRaw = nullptr; */ break; }
-        case jsonType::jsonString:       { _pValueString = new std::string; break; }
-        case jsonType::jsonNumberInt:    { _pValueInt = new int; break; }
-        case jsonType::jsonNumberFloat:  { _pValueFloat = new float; break; }
-        case jsonType::jsonBoolean:      { _pValueBool = new bool; break; }
-        case jsonType::jsonArray:        { _pValueArray = new PJSONARRAY; break; }
-        case jsonType::jsonMap:       { _pValueMap = new PJSONMAP; break; }
+        case jsonType::jsonString:       { _pValueString = new std::string; PJSON_STATS_ALLOC(sizeof(std::string)); break; }
+        case jsonType::jsonNumberInt:    { _pValueInt = new int; PJSON_STATS_ALLOC(sizeof(int)); break; }
+        case jsonType::jsonNumberFloat:  { _pValueFloat = new float; PJSON_STATS_ALLOC(sizeof(float)); break; }
+        case jsonType::jsonBoolean:      { _pValueBool = new bool; PJSON_STATS_ALLOC(sizeof(bool)); break; }
+        case jsonType::jsonArray:        { _pValueArray = new PJSONARRAY; PJSON_STATS_ALLOC(sizeof(PJSONARRAY)); break; }
+        case jsonType::jsonMap:       { _pValueMap = new PJSONMAP; PJSON_STATS_ALLOC(sizeof(PJSONMAP)); break; }
     } //end switch
     _eType = aeType;
 }
 //-----------------------------------------------------------------
 void pjson::copyFrom(const pjson& aFrom) {
+    PJSON_TRACE_COPY(*this);
+    _copyFrom(aFrom);
+}
+//-----------------------------------------------------------------
+void pjson::_copyFrom(const pjson& aFrom) {
+    if(aFrom.isCopyOnWrite()) {
+        _shareFrom(aFrom);
+        return;
+    }
+    if(aFrom._iFlags & FlagRawNumber) {
+        if(&aFrom != this) {
+            _setRawNumber(aFrom._eType, aFrom._pValueString->data(), aFrom._pValueString->length());
+        }
+        return;
+    }
     resetTo(aFrom.getType());
 
     switch(_eType) {
@@ -196,7 +277,7 @@ void pjson::copyFrom(const pjson& aFrom) {
         case jsonType::jsonArray:        {
             for (auto it : *(aFrom._pValueArray)) {
                 pjson* pObj = new pjson();
-                pObj->copyFrom(*it);
+                pObj->_copyFrom(*it);
                 _pValueArray->push_back(pObj);
             }
             break;
@@ -204,7 +285,7 @@ void pjson::copyFrom(const pjson& aFrom) {
         case jsonType::jsonMap:       {
             for (auto const& it : *(aFrom._pValueMap)) {
                 pjson* pObj = new pjson();
-                pObj->copyFrom(*(it.second));
+                pObj->_copyFrom(*(it.second));
                 (*_pValueMap)[it.first] = pObj;
             }
             break;
@@ -212,27 +293,187 @@ void pjson::copyFrom(const pjson& aFrom) {
     } //end switch
 }
 //-----------------------------------------------------------------
+void pjson::setCopyOnWrite(bool bEnable) {
+    if(bEnable) {
+        if(nullptr == _pShareCount.load(std::memory_order_acquire)) {
+            _pShareCount.store(new std::atomic<int>(1), std::memory_order_release);
+        }
+        return;
+    }
+    _detach();
+    std::atomic<int>* pCount = _pShareCount.exchange(nullptr);
+    delete pCount; // sole owner after _detach()
+}
+//-----------------------------------------------------------------
+bool pjson::isCopyOnWrite() const {
+    return nullptr != _pShareCount.load(std::memory_order_acquire);
+}
+//-----------------------------------------------------------------
+void pjson::_shareFrom(const pjson& aFrom) {
+    if(&aFrom == this) {
+        return;
+    }
+    reset();
+    std::atomic<int>* pCount = aFrom._pShareCount.load(std::memory_order_acquire);
+    if(nullptr == pCount) {
+        // Several threads may share the same untouched child at once
+        std::atomic<int>* pNew = new std::atomic<int>(1);
+        if(aFrom._pShareCount.compare_exchange_strong(pCount, pNew, std::memory_order_acq_rel)) {
+            pCount = pNew;
+        } else {
+            delete pNew;
+        }
+    }
+    pCount->fetch_add(1, std::memory_order_relaxed);
+    _eType = aFrom._eType;
+    _pValueRaw = aFrom._pValueRaw;
+    _iFlags = aFrom._iFlags;
+    // Same children, so the same cover
+    _iCacheFlags.fetch_or(aFrom._iCacheFlags.load(std::memory_order_relaxed) & CacheCoversChildren, std::memory_order_relaxed);
+    _pShareCount.store(pCount, std::memory_order_release);
+}
+//-----------------------------------------------------------------
+void pjson::_detach() {
+    _dropCaches(); // the caller may be about to mutate
+    std::atomic<int>* pCount = _pShareCount.load(std::memory_order_acquire);
+    if(nullptr == pCount || 1 == pCount->load(std::memory_order_acquire)) {
+        _uncoverChildren(); // edits below now come through this node
+        return;
+    }
+
+    // Hand the shared reference to a temporary, which releases it on exit
+    pjson oShared;
+    oShared._eType = _eType;
+    oShared._pValueRaw = _pValueRaw;
+    oShared._pShareCount.store(_pShareCount.exchange(nullptr));
+    oShared._iFlags = _iFlags;
+    _eType = jsonType::jsonNull;
+    _pValueRaw = nullptr;
+    _iFlags = 0;
+
+    if(oShared._iFlags & FlagRawNumber) {
+        _setRawNumber(oShared._eType, oShared._pValueString->data(), oShared._pValueString->length());
+        return;
+    }
+
+    // Clone one level; children keep sharing until they are mutated
+    resetTo(oShared._eType);
+    switch(_eType) {
+        case jsonType::jsonNull:         { break; }
+        case jsonType::jsonString:       { *_pValueString = *(oShared._pValueString); break; }
+        case jsonType::jsonNumberInt:    { *_pValueInt = *(oShared._pValueInt); break; }
+        case jsonType::jsonNumberFloat:  { *_pValueFloat = *(oShared._pValueFloat); break; }
+        case jsonType::jsonBoolean:      { *_pValueBool = *(oShared._pValueBool); break; }
+        case jsonType::jsonArray:        {
+            _pValueArray->reserve(oShared._pValueArray->size());
+            for (auto it : *(oShared._pValueArray)) {
+                pjson* pObj = new pjson();
+                pObj->_shareFrom(*it);
+                _pValueArray->push_back(pObj);
+            }
+            break;
+        }
+        case jsonType::jsonMap:       {
+            for (auto const& it : *(oShared._pValueMap)) {
+                pjson* pObj = new pjson();
+                pObj->_shareFrom(*(it.second));
+                _pValueMap->emplace_hint(_pValueMap->end(), it.first, pObj);
+            }
+            break;
+        }
+    } //end switch
+}
+//-----------------------------------------------------------------
+// Drops the node's cache stamp before it changes. A parent whose saved text
+// or hash includes the node cannot be reached from here, so the caches of the
+// node's document start over (see CacheSlot).
+void pjson::_dropCaches() {
+    _iCacheStamp.store(0, std::memory_order_relaxed);
+    uint16_t iSlot = _iCacheSlot.load(std::memory_order_relaxed);
+    if(0 != iSlot) {
+        CacheSlot::Touch(iSlot);
+    }
+}
+//-----------------------------------------------------------------
+// Once this node's stamp is dropped, its children no longer need to touch
+// the slot when they change
+void pjson::_uncoverChildren() {
+    if(0 == (_iCacheFlags.load(std::memory_order_relaxed) & CacheCoversChildren)) {
+        return;
+    }
+    if(jsonType::jsonArray == _eType) {
+        for(pjson* pChild : *_pValueArray) {
+            pChild->_iCacheSlot.store(0, std::memory_order_relaxed);
+        }
+    } else if(jsonType::jsonMap == _eType) {
+        for(auto const& it : *_pValueMap) {
+            it.second->_iCacheSlot.store(0, std::memory_order_relaxed);
+        }
+    }
+    _iCacheFlags.fetch_and(static_cast<unsigned char>(~CacheCoversChildren), std::memory_order_relaxed);
+}
+//-----------------------------------------------------------------
+// The value moves with its children, so their cover moves too; this node
+// keeps its own place under its parent
+void pjson::_moveCaches(pjson& a_rFrom) {
+    _iCacheFlags.fetch_or(a_rFrom._iCacheFlags.load(std::memory_order_relaxed) & CacheCoversChildren, std::memory_order_relaxed);
+    a_rFrom._dropCaches();
+    a_rFrom._iCacheFlags.fetch_and(static_cast<unsigned char>(~CacheCoversChildren), std::memory_order_relaxed);
+}
+//-----------------------------------------------------------------
 std::string pjson::toString(bool bPretty /*=false*/) const {
-    int iIndent = bPretty?0:-1;
-    return _toString(iIndent);
+    SerializeOptions oOptions;
+    oOptions.eStyle = bPretty ? SerializeOptions::styleLegacyPretty : SerializeOptions::styleLegacy;
+    return toString(oOptions);
 }
 //-----------------------------------------------------------------
-std::string pjson::_toString(int a_iIndent) const {
+std::string pjson::toString(const SerializeOptions& aOptions) const {
     std::string sOut;
-
+    toString(sOut, aOptions);
+    return sOut;
+}
+//-----------------------------------------------------------------
+void pjson::toString(std::string& a_rOut, const SerializeOptions& aOptions) const {
+    _serialize(a_rOut, aOptions, nullptr);
+}
+//-----------------------------------------------------------------
+// a_pCache (optional) splices clean subtrees instead of rewriting them
+void pjson::_serialize(std::string& a_rOut, const SerializeOptions& aOptions, SerializeCache* a_pCache) const {
+    size_t iStart = a_rOut.length();
+    PJSON_TRACE_SERIALIZE(*this, a_rOut, iStart);
+    {
+        PJSON_STATS_TIMER(iSerializeNanos);
+        switch(aOptions.eStyle) {
+            case SerializeOptions::styleLegacy:       { _toString(a_rOut, -1, a_pCache); break; }
+            case SerializeOptions::styleLegacyPretty: { _toString(a_rOut, 0, a_pCache); break; }
+            default:                                  { _toStringStyled(a_rOut, aOptions, 0, a_pCache); break; }
+        }
+    }
+    PJSON_STATS_ADD(iSerializeCalls, 1);
+    PJSON_STATS_ADD(iSerializedBytes, a_rOut.length() - iStart);
+    (void)iStart;
+}
+//-----------------------------------------------------------------
+void pjson::_toString(std::string& sOut, int a_iIndent, SerializeCache* a_pCache /*= nullptr*/) const {
+    size_t iBegin = sOut.length();
+    const bool bCached = a_pCache && (jsonType::jsonArray == _eType || jsonType::jsonMap == _eType);
+    if(bCached && a_pCache->_splice(*this, a_iIndent, sOut)) {
+        return;
+    }
     switch(_eType) {
         case jsonType::jsonNull:         { sOut += "null"; break; }
-        case jsonType::jsonString:       { sOut += "\"" + (*_pValueString) + "\""; break; }
-        case jsonType::jsonNumberInt:    { sOut += std::to_string(*_pValueInt); break; }
-        case jsonType::jsonNumberFloat:  { sOut += std::to_string(*_pValueFloat); break; }
+        case jsonType::jsonString:       { _AppendString(sOut, _pValueString->data(), _pValueString->length()); break; }
+        case jsonType::jsonNumberInt:    {
+            if(_iFlags & FlagRawNumber) { sOut += *_pValueString; } else { _AppendInt(sOut, *_pValueInt); }
+            break;
+        }
+        case jsonType::jsonNumberFloat:  {
+            if(_iFlags & FlagRawNumber) { sOut += *_pValueString; } else { _AppendFloat(sOut, *_pValueFloat); }
+            break;
+        }
         case jsonType::jsonBoolean:      { sOut += (*_pValueBool)?"true":"false"; break; }
         case jsonType::jsonArray:  {
             sOut += "[";
-            std::string spaces;
-            if(a_iIndent >=0) {
-                spaces = std::string(a_iIndent, ' ');
-            }
-
             bool bFirstElement = true;
             for (auto it = _pValueArray->begin(); it != _pValueArray->end(); it++) {
                 if(!bFirstElement) {
@@ -241,12 +482,13 @@ std::string pjson::_toString(int a_iIndent) const {
 
                 int iIndent = a_iIndent;
                 if(a_iIndent >=0) {
-                    sOut += "\n" + spaces;
+                    sOut += '\n';
+                    sOut.append(a_iIndent, ' ');
                     iIndent += 1;
                 }
 
                 sOut += " ";
-                sOut += (*it)->_toString(iIndent);
+                (*it)->_toString(sOut, iIndent, a_pCache);
                 sOut += " ";
                 bFirstElement = false;
             }
@@ -255,7 +497,8 @@ std::string pjson::_toString(int a_iIndent) const {
                 sOut += " ]"; // no elements
             } else {
                 if(a_iIndent >=0) {
-                    sOut += "\n" + spaces;
+                    sOut += '\n';
+                    sOut.append(a_iIndent, ' ');
                 }
                 sOut += "]";
             }
@@ -263,10 +506,6 @@ std::string pjson::_toString(int a_iIndent) const {
         }
         case jsonType::jsonMap: {
             sOut += "{";
-            std::string spaces;
-            if(a_iIndent >=0) {
-                spaces = std::string(a_iIndent, ' ');
-            }
             bool bFirstElement = true;
             for (auto it = _pValueMap->begin(); it != _pValueMap->end(); it++) {
                 if(!bFirstElement) {
@@ -274,7 +513,8 @@ std::string pjson::_toString(int a_iIndent) const {
                 }
 
                 if(a_iIndent >=0) {
-                    sOut += "\n" + spaces;
+                    sOut += '\n';
+                    sOut.append(a_iIndent, ' ');
                 }
                 sOut += " \"";
                 int iLen = it->first.length();
@@ -285,7 +525,7 @@ std::string pjson::_toString(int a_iIndent) const {
                 if(a_iIndent >=0) {
                     iIndent += iLen + 6;
                 }
-                sOut += it->second->_toString(iIndent);
+                it->second->_toString(sOut, iIndent, a_pCache);
                 sOut += " ";
                 bFirstElement = false;
             } // end for
@@ -294,15 +534,129 @@ std::string pjson::_toString(int a_iIndent) const {
                 sOut += " }"; // no elements
             } else {
                 if(a_iIndent >=0) {
-                    sOut += "\n" + spaces;
+                    sOut += '\n';
+                    sOut.append(a_iIndent, ' ');
                 }
                 sOut += "}";
             }
             break;
         }
     }//end switch
-
-    return sOut;
+    if(bCached) {
+        a_pCache->_store(*this, a_iIndent, sOut, iBegin);
+    }
+}
+//-----------------------------------------------------------------
+/*static*/
+void pjson::_AppendNewline(std::string& sOut, const SerializeOptions& aOptions, size_t a_iDepth) {
+    sOut += aOptions.sNewline;
+    sOut.append(a_iDepth * aOptions.iIndent, aOptions.cIndent);
+}
+//-----------------------------------------------------------------
+// styleCompact / stylePretty; a_iDepth is the nesting level of this node
+void pjson::_toStringStyled(std::string& sOut, const SerializeOptions& aOptions, size_t a_iDepth,
+                            SerializeCache* a_pCache /*= nullptr*/) const {
+    const bool bPretty = (SerializeOptions::stylePretty == aOptions.eStyle);
+    size_t iBegin = sOut.length();
+    const bool bCached = a_pCache && (jsonType::jsonArray == _eType || jsonType::jsonMap == _eType);
+    if(bCached && a_pCache->_splice(*this, static_cast<int>(a_iDepth), sOut)) {
+        return;
+    }
+    switch(_eType) {
+        case jsonType::jsonArray:  {
+            sOut += '[';
+            bool bFirstElement = true;
+            for (auto it = _pValueArray->begin(); it != _pValueArray->end(); it++) {
+                if(!bFirstElement) {
+                    sOut += ',';
+                }
+                if(bPretty) {
+                    _AppendNewline(sOut, aOptions, a_iDepth + 1);
+                }
+                (*it)->_toStringStyled(sOut, aOptions, a_iDepth + 1, a_pCache);
+                bFirstElement = false;
+            }
+            if(bPretty && !bFirstElement) {
+                _AppendNewline(sOut, aOptions, a_iDepth);
+            }
+            sOut += ']';
+            break;
+        }
+        case jsonType::jsonMap: {
+            sOut += '{';
+            bool bFirstElement = true;
+            for (auto it = _pValueMap->begin(); it != _pValueMap->end(); it++) {
+                if(!bFirstElement) {
+                    sOut += ',';
+                }
+                if(bPretty) {
+                    _AppendNewline(sOut, aOptions, a_iDepth + 1);
+                }
+                _AppendString(sOut, it->first.data(), it->first.length());
+                sOut += bPretty ? ": " : ":";
+                it->second->_toStringStyled(sOut, aOptions, a_iDepth + 1, a_pCache);
+                bFirstElement = false;
+            }
+            if(bPretty && !bFirstElement) {
+                _AppendNewline(sOut, aOptions, a_iDepth);
+            }
+            sOut += '}';
+            break;
+        }
+        default: {
+            _toString(sOut, -1); // scalars are the same in every style
+            break;
+        }
+    }//end switch
+    if(bCached) {
+        a_pCache->_store(*this, static_cast<int>(a_iDepth), sOut, iBegin);
+    }
+}
+//-----------------------------------------------------------------
+/*static*/
+void pjson::_AppendInt(std::string& a_rOut, int64_t aValue) {
+    char buf[24];
+    char* pEnd = buf + sizeof(buf);
+    char* p = pEnd;
+    uint64_t uValue = (aValue < 0) ? 0u - static_cast<uint64_t>(aValue) : static_cast<uint64_t>(aValue);
+    do {
+        *--p = static_cast<char>('0' + (uValue % 10));
+        uValue /= 10;
+    } while(uValue);
+    if(aValue < 0) {
+        *--p = '-';
+    }
+    a_rOut.append(p, pEnd - p);
+}
+//-----------------------------------------------------------------
+/*static*/
+void pjson::_AppendFloat(std::string& a_rOut, float aValue) {
+    // Same text as std::to_string(float), without the temporary string
+    char buf[64];
+    int iLen = snprintf(buf, sizeof(buf), "%f", static_cast<double>(aValue));
+    if(iLen >= static_cast<int>(sizeof(buf))) {
+        a_rOut += std::to_string(aValue);
+    } else if(iLen > 0) {
+        a_rOut.append(buf, iLen);
+    }
+}
+//-----------------------------------------------------------------
+/*static*/
+void pjson::_AppendDouble(std::string& a_rOut, double aValue) {
+    // Enough digits to read back the same double
+    char buf[64];
+    int iLen = snprintf(buf, sizeof(buf), "%.17g", aValue);
+    if(iLen > 0 && iLen < static_cast<int>(sizeof(buf))) {
+        a_rOut.append(buf, iLen);
+    }
+}
+//-----------------------------------------------------------------
+/*static*/
+void pjson::_AppendString(std::string& a_rOut, const char* aStr, size_t a_iLength) {
+    // Strings are held in their JSON-escaped form, so they are written as-is
+    a_rOut += '\"';
+    a_rOut.append(aStr, a_iLength);
+    a_rOut += '\"';
 }
 //-----------------------------------------------------------------
 pjson& pjson::operator=(const std::string& aString) {
@@ -440,19 +794,19 @@ pjson& pjson::operator+=(const std::vector<std::string>& aValueArray) {
   }                                                           \
   return true;
 //-----------------------------------------------------------------
-bool pjson::getArrayValues(size_t aFrom, size_t aTo, std::vector<std::string>& aDest) {
+bool pjson::getArrayValues(size_t aFrom, size_t aTo, std::vector<std::string>& aDest) const {
     PJSON_VALUE_ARRAY_EXTRACT(getString)
 }
 //-----------------------------------------------------------------
-bool pjson::getArrayValues(size_t aFrom, size_t aTo, std::vector<int>& aDest) {
+bool pjson::getArrayValues(size_t aFrom, size_t aTo, std::vector<int>& aDest) const {
     PJSON_VALUE_ARRAY_EXTRACT(getInt)
 }
 //-----------------------------------------------------------------
-bool pjson::getArrayValues(size_t aFrom, size_t aTo, std::vector<float>& aDest){
+bool pjson::getArrayValues(size_t aFrom, size_t aTo, std::vector<float>& aDest) const {
     PJSON_VALUE_ARRAY_EXTRACT(getFloat)
 }
 //-----------------------------------------------------------------
-bool pjson::getArrayValues(size_t aFrom, size_t aTo, std::vector<bool>& aDest){
+bool pjson::getArrayValues(size_t aFrom, size_t aTo, std::vector<bool>& aDest) const {
     PJSON_VALUE_ARRAY_EXTRACT(getBool)
 }
 //-----------------------------------------------------------------
@@ -500,16 +854,10 @@ pjson& pjson::at(int index) {
     return *(*_pValueArray)[static_cast<size_t>(index)];
 }
 //-----------------------------------------------------------------
-pjson& pjson::operator[] (int index) {
-    return at(index);
-}
-//-----------------------------------------------------------------
-pjson& pjson::operator[] (const std::string& aString) {
-    return at(aString);
-}
-//-----------------------------------------------------------------
-pjson& pjson::operator[] (const char* aSkey) {
-    return at(aSkey);
+/*static*/
+const pjson& pjson::_NullValue() {
+    static const pjson oNull;
+    return oNull;
 }
 //-----------------------------------------------------------------
 /*static*/
@@ -519,53 +867,248 @@ pjson* pjson::CreateFromString(const std::string& aStr) {
 //-----------------------------------------------------------------
 /*static*/
 pjson* pjson::CreateFromString(const char* aSrc, size_t a_iSize) {
+    PJSON_STATS_PARSE(a_iSize);
     size_t iStart =0;
     size_t iEnd =a_iSize;
     pjson* pResult = nullptr;
+    PJSON_TRACE_PARSE(a_iSize, pResult);
     /*bool bSuccess = */
     _CreateFromString(aSrc, iStart, iEnd, pResult);
     return pResult;
 }
 //-----------------------------------------------------------------
 /*static*/
-bool pjson::_CreateFromString(const char* aSrc, size_t& a_iStart,size_t a_iEnd, pjson*& a_rResult) {
-    //1. Scan for fundametal type
-    char aChar;
-    while (_ScanToNext(aSrc, a_iStart, a_iEnd, aChar)) {
-        aChar = tolower(aChar);
-        if('\"' == aChar) {
-            return _ScanString(aSrc, a_iStart, a_iEnd, a_rResult);
-        }
-        else if('n' == aChar) {
-            return _ScanNull(aSrc, a_iStart, a_iEnd, a_rResult);
-        }
-        else if('t' == aChar || 'f' == aChar) {
-            return _ScanBool(aSrc, a_iStart, a_iEnd, a_rResult);
+pjson* pjson::CreateFromString(const char* aSrc, size_t a_iSize, ParseContext& a_rContext) {
+    PJSON_STATS_PARSE(a_iSize);
+    size_t iStart =0;
+    size_t iEnd =a_iSize;
+    pjson* pResult = nullptr;
+    PJSON_TRACE_PARSE(a_iSize, pResult);
+    /*bool bSuccess = */
+    _CreateFromString(aSrc, iStart, iEnd, pResult, &a_rContext);
+    return pResult;
+}
+//-----------------------------------------------------------------
+/*static*/
+pjson* pjson::CreateFromString(const char* aSrc, size_t a_iSize, const Projection& aFields) {
+    PJSON_STATS_PARSE(a_iSize);
+    size_t iStart =0;
+    pjson* pResult = nullptr;
+    PJSON_TRACE_PARSE(a_iSize, pResult);
+    _CreateFromString(aSrc, iStart, a_iSize, pResult, nullptr, &aFields._vNodes.front());
+    return pResult;
+}
+//-----------------------------------------------------------------
+/*static*/
+pjson* pjson::CreateFromString(const char* aSrc, size_t a_iSize, const Projection& aFields, ParseContext& a_rContext) {
+    PJSON_STATS_PARSE(a_iSize);
+    size_t iStart =0;
+    pjson* pResult = nullptr;
+    PJSON_TRACE_PARSE(a_iSize, pResult);
+    _CreateFromString(aSrc, iStart, a_iSize, pResult, &a_rContext, &aFields._vNodes.front());
+    return pResult;
+}
+//-----------------------------------------------------------------
+const size_t pjson::DefaultMaxParseDepth;
+//-----------------------------------------------------------------
+/*static*/
+void pjson::SetMaxParseDepth(size_t a_iDepth) {
+    _MaxParseDepth().store(a_iDepth, std::memory_order_relaxed);
+}
+//-----------------------------------------------------------------
+/*static*/
+size_t pjson::GetMaxParseDepth() {
+    return _MaxParseDepth().load(std::memory_order_relaxed);
+}
+//-----------------------------------------------------------------
+/*static*/
+std::atomic<size_t>& pjson::_MaxParseDepth() {
+    static std::atomic<size_t> iMaxDepth(DefaultMaxParseDepth);
+    return iMaxDepth;
+}
+//-----------------------------------------------------------------
+/*static*/
+bool pjson::_CreateFromString(const char* aSrc, size_t& a_iStart,size_t a_iEnd, pjson*& a_rResult, ParseContext* a_pContext,
+                              const ProjectionNode* a_pSelect) {
+    // Arrays and objects are tracked on an explicit stack rather than by
+    // recursion, so nesting is bounded by the max depth, not the thread stack.
+    // A container is attached to its parent only once it is complete.
+    // With a projection (a_pSelect) each frame carries the step it matched;
+    // values no step selects are skipped without building anything.
+    std::vector<ParseFrame> vLocalFrames;
+    std::vector<ParseFrame>& vFrames = a_pContext ? a_pContext->_vFrames : vLocalFrames;
+    const size_t iMaxDepth = a_pContext ? a_pContext->_iMaxDepth : GetMaxParseDepth();
+    vFrames.clear();
+
+    auto fnUnwind = [&]() {
+        while(!vFrames.empty()) {
+            _FreeNode(vFrames.back().pNode, a_pContext);
+            vFrames.pop_back();
         }
-        else if('+' == aChar || '-' == aChar || '.' == aChar || ('0' <= aChar && '9' >= aChar)) {
-            return _ScanNumber(aSrc, a_iStart, a_iEnd, a_rResult);
-        } else if('{' == aChar) {
-            return _ScanObject(aSrc, a_iStart, a_iEnd, a_rResult);
-        } else if('[' == aChar) {
-            return _ScanArray(aSrc, a_iStart, a_iEnd, a_rResult);
-        } else {
-            //unknown
-            break;
+    };
+
+    try {
+        char aChar;
+        for(;;) {
+            //1. Scan one value; a container is opened and filled by step 2
+            pjson* pValue = nullptr;
+            if(!_ScanToNext(aSrc, a_iStart, a_iEnd, aChar)) {
+                break;
+            }
+            const ProjectionNode* pSelect = vFrames.empty() ? a_pSelect : vFrames.back().pSelect;
+            bool bSkip = false;
+            if(pSelect && !vFrames.empty()) {
+                ParseFrame& rParent = vFrames.back();
+                pSelect = (jsonType::jsonArray == rParent.pNode->_eType) ? pSelect->index(rParent.iIndex++)
+                                                                        : pSelect->key(aSrc + rParent.iKey, rParent.iKeyLength);
+                if(nullptr == pSelect) {
+                    bSkip = true;
+                } else if(!pSelect->bKeepAll) {
+                    // the path goes deeper, so only a container of the right kind can match
+                    bSkip = ('{' == aChar) ? !pSelect->wantsObject() : ('[' == aChar) ? !pSelect->wantsArray() : true;
+                }
+            }
+            if(pSelect && pSelect->bKeepAll) {
+                pSelect = nullptr; // keep the whole subtree
+            }
+            aChar = tolower(aChar);
+            if(bSkip) {
+                if(!_SkipValue(aSrc, a_iStart, a_iEnd)) {
+                    break;
+                }
+            } else if('\"' == aChar) {
+                _ScanString(aSrc, a_iStart, a_iEnd, pValue, a_pContext);
+            } else if('n' == aChar) {
+                _ScanNull(aSrc, a_iStart, a_iEnd, pValue, a_pContext);
+            } else if('t' == aChar || 'f' == aChar) {
+                _ScanBool(aSrc, a_iStart, a_iEnd, pValue, a_pContext);
+            } else if('+' == aChar || '-' == aChar || '.' == aChar || ('0' <= aChar && '9' >= aChar)) {
+                _ScanNumber(aSrc, a_iStart, a_iEnd, pValue, a_pContext);
+            } else if('{' == aChar || '[' == aChar) {
+                if(vFrames.size() >= iMaxDepth) {
+                    break;
+                }
+                ParseFrame oFrame;
+                oFrame.pNode = _NewNode(('{' == aChar) ? jsonType::jsonMap : jsonType::jsonArray, a_pContext);
+                oFrame.pSelect = pSelect;
+                oFrame.iIndex = 0;
+                vFrames.push_back(oFrame);
+                PJSON_STATS_DEPTH(vFrames.size());
+                ++a_iStart; // ignore first char "{" / "["
+            } else {
+                break; // unknown
+            }
+            if(nullptr == pValue && !bSkip && '{' != aChar && '[' != aChar) {
+                break; // malformed scalar
+            }
+
+            //2. Attach complete values and close containers until a value is expected
+            bool bNeedValue = false;
+            bool bFailed = false;
+            while(!bNeedValue && !bFailed) {
+                if(pValue) {
+                    if(vFrames.empty()) {
+                        a_rResult = pValue;
+                        return true;
+                    }
+                    ParseFrame& rParent = vFrames.back();
+                    if(rParent.pSelect && jsonType::jsonArray == rParent.pNode->_eType) {
+                        // skipped elements before this one read back as null
+                        while(rParent.pNode->_pValueArray->size() + 1 < rParent.iIndex) {
+                            _AttachValue(aSrc, rParent, _NewNode(jsonType::jsonNull, a_pContext), a_pContext);
+                        }
+                    }
+                    _AttachValue(aSrc, rParent, pValue, a_pContext);
+                    pValue = nullptr;
+                }
+                ParseFrame& rTop = vFrames.back();
+                if(!_ScanToNext(aSrc, a_iStart, a_iEnd, aChar)) {
+                    bFailed = true;
+                } else if(',' == aChar) {
+                    ++a_iStart; // ignore commas
+                } else if(jsonType::jsonArray == rTop.pNode->_eType) {
+                    if(']' == aChar) {
+                        ++a_iStart;
+                        pValue = rTop.pNode;
+                        vFrames.pop_back();
+                    } else {
+                        bNeedValue = true;
+                    }
+                } else if('}' == aChar) {
+                    ++a_iStart;
+                    pValue = rTop.pNode;
+                    vFrames.pop_back();
+                } else if(_ExtractStringSpan(aSrc, a_iStart, a_iEnd, rTop.iKey, rTop.iKeyLength)
+                          && _ScanPastColon(aSrc, a_iStart, a_iEnd)) {
+                    bNeedValue = true;
+                } else {
+                    bFailed = true;
+                }
+            }
+            if(bFailed) {
+                break;
+            }
         }
-    } // end while
+    } catch(...) {
+        fnUnwind(); // e.g. std::stoi out of range
+        throw;
+    }
 
+    fnUnwind();
     return false;
 }
 //-----------------------------------------------------------------
 /*static*/
-bool pjson::_ScanBool(const char* aSrc, size_t& a_iStart,const size_t a_iEnd, pjson*& a_rBoolResult) {
+void pjson::_AttachValue(const char* aSrc, const ParseFrame& aFrame, pjson* aValue, ParseContext* a_pContext) {
+    PJSON_STATS_TIMER(iInsertNanos);
+    if(jsonType::jsonArray == aFrame.pNode->_eType) {
+        PJSONARRAY* pArray = aFrame.pNode->_pValueArray;
+        if(pArray->size() == pArray->capacity()) {
+            PJSON_STATS_ALLOC(sizeof(pjson*) * (pArray->empty() ? 1 : 2 * pArray->size()));
+        }
+        pArray->push_back(aValue);
+        return;
+    }
+    // a repeated key keeps the last value
+    PJSON_STATS_ALLOC(sizeof(PJSONMAP::value_type) + 4 * sizeof(void*)); // tree node
+    PJSON_STATS_ADD(iStringBytes, aFrame.iKeyLength);
+    auto itInsert = aFrame.pNode->_pValueMap->emplace(std::string(aSrc + aFrame.iKey, aFrame.iKeyLength), aValue);
+    if(!itInsert.second) {
+        _FreeNode(itInsert.first->second, a_pContext);
+        itInsert.first->second = aValue;
+    }
+}
+//-----------------------------------------------------------------
+/*static*/
+pjson* pjson::_NewNode(jsonType aeType, ParseContext* a_pContext) {
+    PJSON_STATS_NODE(aeType);
+    if(a_pContext) {
+        return a_pContext->_acquire(aeType);
+    }
+    pjson* pNode = new pjson();
+    PJSON_STATS_ALLOC(sizeof(pjson));
+    pNode->resetTo(aeType);
+    return pNode;
+}
+//-----------------------------------------------------------------
+/*static*/
+void pjson::_FreeNode(pjson* aNode, ParseContext* a_pContext) {
+    if(a_pContext) {
+        a_pContext->recycle(aNode);
+    } else {
+        delete aNode;
+    }
+}
+//-----------------------------------------------------------------
+/*static*/
+bool pjson::_ScanBool(const char* aSrc, size_t& a_iStart,const size_t a_iEnd, pjson*& a_rBoolResult, ParseContext* a_pContext) {
     if((a_iEnd - a_iStart) >= 4
        && 't' == tolower(aSrc[a_iStart])
        && 'r' == tolower(aSrc[a_iStart+1])
        && 'u' == tolower(aSrc[a_iStart+2])
        && 'e' == tolower(aSrc[a_iStart+3])) {
-        a_rBoolResult = new pjson();
-        *a_rBoolResult = bool(true);
+        a_rBoolResult = _NewNode(jsonType::jsonBoolean, a_pContext);
+        *a_rBoolResult->_pValueBool = true;
         a_iStart+=4;
         return true;
     }
@@ -575,8 +1118,8 @@ bool pjson::_ScanBool(const char* aSrc, size_t& a_iStart,const size_t a_iEnd, pj
        && 'l' == tolower(aSrc[a_iStart+2])
        && 's' == tolower(aSrc[a_iStart+3])
        && 'e' == tolower(aSrc[a_iStart+4])) {
-        a_rBoolResult = new pjson();
-        *a_rBoolResult = bool(false);
+        a_rBoolResult = _NewNode(jsonType::jsonBoolean, a_pContext);
+        *a_rBoolResult->_pValueBool = false;
         a_iStart+=5;
         return true;
     }
@@ -585,13 +1128,29 @@ bool pjson::_ScanBool(const char* aSrc, size_t& a_iStart,const size_t a_iEnd, pj
 //-----------------------------------------------------------------
 /*static*/
 bool pjson::_ExtractString(const char* aSrc, size_t& a_iStart,const size_t a_iEnd, std::string& aStrResult) {
+    size_t iBegin = 0;
+    size_t iLength = 0;
+    if(_ExtractStringSpan(aSrc, a_iStart, a_iEnd, iBegin, iLength)) {
+        aStrResult = std::string(aSrc+iBegin, iLength);
+        return true;
+    }
+    return false;
+}
+//-----------------------------------------------------------------
+/*static*/
+bool pjson::_ExtractStringSpan(const char* aSrc, size_t& a_iStart,const size_t a_iEnd, size_t& a_rBegin, size_t& a_rLength) {
     if('\"' != aSrc[a_iStart]){
         return false;
     }
     ++a_iStart;
-    int iEnd = a_iStart;
-    int iStart = a_iStart;
+    size_t iEnd = a_iStart;
+    size_t iStart = a_iStart;
+    const pjsonKernels& rKernels = pjsonKernels::Active();
     while(a_iStart<a_iEnd) {
+        a_iStart += rKernels.fnFindQuote(aSrc + a_iStart, a_iEnd - a_iStart);
+        if(a_iStart>=a_iEnd) {
+            break;
+        }
         char c = aSrc[a_iStart++];
         if('\"' == c) {
             iEnd = a_iStart - 1;
@@ -600,19 +1159,25 @@ bool pjson::_ExtractString(const char* aSrc, size_t& a_iStart,const size_t a_iEn
             ++a_iStart;
         }
     }
-    if(iStart<iEnd && iStart >=0 && iEnd >=0) {
-        aStrResult = std::string(aSrc+iStart, iEnd-iStart);
+    if(iStart<iEnd) {
+        a_rBegin = iStart;
+        a_rLength = iEnd-iStart;
         return true;
     }
     return false;
 }
 //-----------------------------------------------------------------
 /*static*/
-bool pjson::_ScanString(const char* aSrc, size_t& a_iStart,const size_t a_iEnd, pjson*& a_rStrResult) {
-    std::string str;
-    if(_ExtractString(aSrc, a_iStart, a_iEnd, str)) {
-        a_rStrResult = new pjson();
-        *a_rStrResult = str;
+bool pjson::_ScanString(const char* aSrc, size_t& a_iStart,const size_t a_iEnd, pjson*& a_rStrResult, ParseContext* a_pContext) {
+    size_t iBegin = 0;
+    size_t iLength = 0;
+    if(_ExtractStringSpan(aSrc, a_iStart, a_iEnd, iBegin, iLength)) {
+        a_rStrResult = _NewNode(jsonType::jsonString, a_pContext);
+        if(iLength > a_rStrResult->_pValueString->capacity()) {
+            PJSON_STATS_ALLOC(iLength + 1);
+        }
+        PJSON_STATS_ADD(iStringBytes, iLength);
+        a_rStrResult->_pValueString->assign(aSrc+iBegin, iLength);
         return true;
     }
     return false;
@@ -649,14 +1214,14 @@ bool pjson::_ScanToNext(const char* aSrc, size_t& a_iStart,const size_t a_iEnd,
 }
 //-----------------------------------------------------------------
 /*static*/
-bool pjson::_ScanNull(const char* aSrc, size_t& a_iStart,const size_t a_iEnd, pjson*& a_rNUllResult) {
+bool pjson::_ScanNull(const char* aSrc, size_t& a_iStart,const size_t a_iEnd, pjson*& a_rNUllResult, ParseContext* a_pContext) {
     if((a_iEnd - a_iStart) >= 4
        && 'n' == tolower(aSrc[a_iStart])
        && 'u' == tolower(aSrc[a_iStart+1])
        && 'l' == tolower(aSrc[a_iStart+2])
        && 'l' == tolower(aSrc[a_iStart+3])
             ) {
-        a_rNUllResult = new pjson();
+        a_rNUllResult = _NewNode(jsonType::jsonNull, a_pContext);
         a_iStart+=4;
         return true;
     }
@@ -664,9 +1229,45 @@ bool pjson::_ScanNull(const char* aSrc, size_t& a_iStart,const size_t a_iEnd, pj
 }
 //-----------------------------------------------------------------
 /*static*/
-bool pjson::_ScanNumber(const char* aSrc, size_t& a_iStart, const size_t a_iEnd, pjson*& a_rNumResult) {
+bool pjson::_ScanNumber(const char* aSrc, size_t& a_iStart, const size_t a_iEnd, pjson*& a_rNumResult, ParseContext* a_pContext) {
+    size_t iLength = 0;
     bool bFloat = false;
-    int iEnd = a_iStart;
+    if(_ScanNumberSpan(aSrc, a_iStart, a_iEnd, iLength, bFloat)) {
+        if(a_pContext && a_pContext->_bLazyNumbers && _IsJsonNumber(aSrc + a_iStart, iLength)) {
+            a_rNumResult = a_pContext->_acquireRawNumber(bFloat ? jsonType::jsonNumberFloat : jsonType::jsonNumberInt);
+            a_rNumResult->_pValueString->assign(aSrc + a_iStart, iLength);
+            PJSON_STATS_NODE(a_rNumResult->_eType);
+            a_iStart += iLength;
+            return true;
+        }
+        float fValue = 0.0f;
+        int iValue = 0;
+        {
+            PJSON_STATS_TIMER(iNumberNanos);
+            std::string sTemp = std::string(aSrc+a_iStart, iLength);
+            if(bFloat) {
+                fValue = std::stof(sTemp);
+            } else {
+                iValue = std::stoi(sTemp);
+            }
+        }
+        if(bFloat) {
+            a_rNumResult = _NewNode(jsonType::jsonNumberFloat, a_pContext);
+            *a_rNumResult->_pValueFloat = fValue;
+        } else {
+            a_rNumResult = _NewNode(jsonType::jsonNumberInt, a_pContext);
+            *a_rNumResult->_pValueInt = iValue;
+        }
+        a_iStart += iLength;
+        return true;
+    }
+    return false;
+}
+//-----------------------------------------------------------------
+/*static*/
+bool pjson::_ScanNumberSpan(const char* aSrc, size_t a_iStart, const size_t a_iEnd, size_t& a_rLength, bool& a_rFloat) {
+    bool bFloat = false;
+    size_t iEnd = a_iStart;
     enum NumberSection : int {
         NumberSectionSign = 0,
         NumberSectionDigit,
@@ -679,7 +1280,7 @@ bool pjson::_ScanNumber(const char* aSrc, size_t& a_iStart, const size_t a_iEnd,
     };
     int eSec = NumberSectionSign;
 
-    for(int i = a_iStart; i<a_iEnd && eSec!=NumberEnd; ) {
+    for(size_t i = a_iStart; i<a_iEnd && eSec!=NumberEnd; ) {
         switch ((NumberSection)eSec) {
             case NumberSectionSign: {
                 if('+' == aSrc[i] || '-' == aSrc[i]) {
@@ -745,112 +1346,93 @@ bool pjson::_ScanNumber(const char* aSrc, size_t& a_iStart, const size_t a_iEnd,
     } //end for
 
     if(iEnd > a_iStart) {
-        std::string sTemp = std::string(aSrc+a_iStart, iEnd-a_iStart);
-        a_rNumResult = new pjson();
-        if(bFloat) {
-            *a_rNumResult = std::stof(sTemp);
-        } else {
-            *a_rNumResult = std::stoi(sTemp);
-        }
-        a_iStart = iEnd;
+        a_rLength = iEnd - a_iStart;
+        a_rFloat = bFloat;
         return true;
     }
     return false;
 }
 //-----------------------------------------------------------------
 /*static*/
-bool pjson::_ScanArray(const char* aSrc, size_t& a_iStart, const size_t a_iEnd, pjson*& a_rAResult) {
-    a_rAResult = new pjson();
-    a_rAResult->resetTo(jsonType::jsonArray);
-    bool bValid = false;
-    ++a_iStart; // ignore first char "["
+bool pjson::_SkipValue(const char* aSrc, size_t& a_iStart, const size_t a_iEnd) {
+    // Walks over one value without allocating; containers are only bracket-matched
+    size_t iDepth = 0;
     char aChar;
     while(_ScanToNext(aSrc, a_iStart, a_iEnd, aChar)) {
-        if(']' == aChar) {
+        if('\"' == aChar) {
+            size_t iBegin = 0;
+            size_t iLength = 0;
+            if(!_ExtractStringSpan(aSrc, a_iStart, a_iEnd, iBegin, iLength)) {
+                return false;
+            }
+        } else if('[' == aChar || '{' == aChar) {
+            ++iDepth;
             ++a_iStart;
-            bValid = true;
-            break;
-        } else if(',' == aChar) {
-            ++a_iStart; //ignore commas
-        } else {
-            pjson* pTemp = nullptr;
-            if(_CreateFromString(aSrc, a_iStart,a_iEnd, pTemp)) {
-                a_rAResult->_pValueArray->push_back(pTemp);
-            } else {
-                break;
+            continue;
+        } else if(']' == aChar || '}' == aChar) {
+            if(0 == iDepth) {
+                return false;
             }
-        }
-    }
-    if(!bValid) {
-        delete a_rAResult;
-        a_rAResult = nullptr;
-    }
-
-    return bValid;
-}
-//-----------------------------------------------------------------
-/*static*/
-bool pjson::_ScanObject(const char* aSrc, size_t& a_iStart, const size_t a_iEnd, pjson*& a_rAResult) {
-    a_rAResult = new pjson();
-    a_rAResult->resetTo(jsonType::jsonMap);
-    bool bValid = false;
-    ++a_iStart; // ignore first char "{"
-    char aChar;
-    while(_ScanToNext(aSrc, a_iStart, a_iEnd, aChar)) {
-        if('}' == aChar) {
+            --iDepth;
             ++a_iStart;
-            bValid = true;
-            break;
-        } else if(',' == aChar) {
-            ++a_iStart; // ignore commas
+        } else if(iDepth > 0 && (',' == aChar || ':' == aChar)) {
+            ++a_iStart;
+            continue;
         } else {
-            pjson* pVal = nullptr;
-            std::string mkey;
-            if(_ExtractString(aSrc, a_iStart, a_iEnd, mkey)
-               && _ScanPastColon(aSrc, a_iStart, a_iEnd)
-               && _CreateFromString(aSrc, a_iStart, a_iEnd, pVal)) {
-                //success
-                (*(a_rAResult->_pValueMap))[mkey.c_str()] = pVal;
-            } else {
-                delete a_rAResult;
-                a_rAResult = nullptr;
-                bValid = false;
-                break;
+            aChar = tolower(aChar);
+            size_t iLength = 0;
+            bool bFloat = false;
+            if('n' == aChar) {
+                iLength = _MatchLiteral(aSrc, a_iStart, a_iEnd, "null", 4);
+            } else if('t' == aChar) {
+                iLength = _MatchLiteral(aSrc, a_iStart, a_iEnd, "true", 4);
+            } else if('f' == aChar) {
+                iLength = _MatchLiteral(aSrc, a_iStart, a_iEnd, "false", 5);
+            } else if(!_ScanNumberSpan(aSrc, a_iStart, a_iEnd, iLength, bFloat)) {
+                iLength = 0;
+            }
+            if(0 == iLength) {
+                return false;
             }
+            a_iStart += iLength;
+        }
+
+        if(0 == iDepth) {
+            return true;
         }
     }
-    return bValid;
+    return false;
 }
 //-----------------------------------------------------------------
-bool pjson::getIfExist(const std::string& aKey, float& a_rResult) {
+bool pjson::getIfExist(const std::string& aKey, float& a_rResult) const {
     return getIfExist(aKey.c_str(), a_rResult);
 }
 //-----------------------------------------------------------------
-bool pjson::getIfExist(const std::string& aKey, int& a_rResult) {
+bool pjson::getIfExist(const std::string& aKey, int& a_rResult) const {
     return getIfExist(aKey.c_str(), a_rResult);
 }
 //-----------------------------------------------------------------
-bool pjson::getIfExist(const std::string& aKey, bool& a_rResult) {
+bool pjson::getIfExist(const std::string& aKey, bool& a_rResult) const {
     return getIfExist(aKey.c_str(), a_rResult);
 }
 //-----------------------------------------------------------------
-bool pjson::getIfExist(const std::string& aKey, std::string& a_rResult) {
+bool pjson::getIfExist(const std::string& aKey, std::string& a_rResult) const {
     return getIfExist(aKey.c_str(), a_rResult);
 }
 //-----------------------------------------------------------------
-bool pjson::getIfExist(const std::string& aKey, std::vector<std::string>& a_rResult) {
+bool pjson::getIfExist(const std::string& aKey, std::vector<std::string>& a_rResult) const {
     return getIfExist(aKey.c_str(), a_rResult);
 }
 //-----------------------------------------------------------------
-bool pjson::getIfExist(const std::string& aKey, std::vector<int>& a_rResult) {
+bool pjson::getIfExist(const std::string& aKey, std::vector<int>& a_rResult) const {
     return getIfExist(aKey.c_str(), a_rResult);
 }
 //-----------------------------------------------------------------
-bool pjson::getIfExist(const std::string& aKey, std::vector<float>& a_rResult) {
+bool pjson::getIfExist(const std::string& aKey, std::vector<float>& a_rResult) const {
     return getIfExist(aKey.c_str(), a_rResult);
 }
 //-----------------------------------------------------------------
-bool pjson::getIfExist(const std::string& aKey, std::vector<bool>& a_rResult) {
+bool pjson::getIfExist(const std::string& aKey, std::vector<bool>& a_rResult) const {
     return getIfExist(aKey.c_str(), a_rResult);
 }
 //-----------------------------------------------------------------
@@ -865,7 +1447,7 @@ if(_eType == jsonType::jsonMap) {
 return false;                                                                    \
 //
 //-----------------------------------------------------------------
-bool pjson::getIfExist(const char* aKey, float& a_rResult) {
+bool pjson::getIfExist(const char* aKey, float& a_rResult) const {
     if(_eType == jsonType::jsonMap) {
         auto it = _pValueMap->find(aKey);
         if (it != _pValueMap->end()) {
@@ -879,15 +1461,15 @@ bool pjson::getIfExist(const char* aKey, float& a_rResult) {
     return false;
 }
 //-----------------------------------------------------------------
-bool pjson::getIfExist(const char* aKey, int& a_rResult) {
+bool pjson::getIfExist(const char* aKey, int& a_rResult) const {
     PJSON_VALUE_EXTRACT_IF_EXISTS(jsonNumberInt, getInt)
 }
 //-----------------------------------------------------------------
-bool pjson::getIfExist(const char* aKey, bool& a_rResult) {
+bool pjson::getIfExist(const char* aKey, bool& a_rResult) const {
     PJSON_VALUE_EXTRACT_IF_EXISTS(jsonBoolean, getBool)
 }
 //-----------------------------------------------------------------
-bool pjson::getIfExist(const char* aKey, std::string& a_rResult) {
+bool pjson::getIfExist(const char* aKey, std::string& a_rResult) const {
     PJSON_VALUE_EXTRACT_IF_EXISTS(jsonString, getString)
 }
 //-----------------------------------------------------------------
@@ -895,7 +1477,7 @@ bool pjson::getIfExist(const char* aKey, std::string& a_rResult) {
 if (_eType == jsonType::jsonMap) {                                              \
     auto it = _pValueMap->find(aKey);                                           \
     if (it != _pValueMap->end() && it->second->getType()==jsonType::jsonArray) {\
-        size_t arraylen = it->second->getArray()->size();                       \
+        size_t arraylen = it->second->_pValueArray->size();                     \
         a_rResult.clear();                                                      \
         it->second->getArrayValues(0,arraylen-1,a_rResult);                     \
         return true;                                                            \
@@ -904,27 +1486,27 @@ if (_eType == jsonType::jsonMap) {
 return false;                                                                   \
 //
 //-----------------------------------------------------------------
-bool pjson::getIfExist(const char* aKey, std::vector<std::string>& a_rResult) {
+bool pjson::getIfExist(const char* aKey, std::vector<std::string>& a_rResult) const {
     PJSON_ARRAY_VALUE_EXTRACT_IF_EXISTS
 }
 //-----------------------------------------------------------------
-bool pjson::getIfExist(const char* aKey, std::vector<int>& a_rResult) {
+bool pjson::getIfExist(const char* aKey, std::vector<int>& a_rResult) const {
     PJSON_ARRAY_VALUE_EXTRACT_IF_EXISTS
 }
 //-----------------------------------------------------------------
-bool pjson::getIfExist(const char* aKey, std::vector<float>& a_rResult) {
+bool pjson::getIfExist(const char* aKey, std::vector<float>& a_rResult) const {
     PJSON_ARRAY_VALUE_EXTRACT_IF_EXISTS
 }
 //-----------------------------------------------------------------
-bool pjson::getIfExist(const char* aKey, std::vector<bool>& a_rResult) {
+bool pjson::getIfExist(const char* aKey, std::vector<bool>& a_rResult) const {
     PJSON_ARRAY_VALUE_EXTRACT_IF_EXISTS
 }
 //-----------------------------------------------------------------
-bool pjson::hasKey(const std::string& aKey) {
+bool pjson::hasKey(const std::string& aKey) const {
     return hasKey(aKey.c_str());
 }
 //-----------------------------------------------------------------
-bool pjson::hasKey(const char* cStr) {
+bool pjson::hasKey(const char* cStr) const {
     if(_eType == jsonType::jsonMap) {
         auto it = _pValueMap->find(cStr);
         return (it != _pValueMap->end());
@@ -945,8 +1527,21 @@ bool pjson::hasKey(const char* cStr) {
 std::string pjson::EncodeForJSON(const char* data, size_t length) {
     std::string result;
     result.reserve(length * 2); // Reserve space to avoid frequent reallocations
-    
+    _AppendEscaped(result, data, length);
+    return result;
+}
+//-----------------------------------------------------------------
+/*static*/
+void pjson::_AppendEscaped(std::string& result, const char* data, size_t length) {
+    const pjsonKernels& rKernels = pjsonKernels::Active();
     for (size_t i = 0; i < length; ++i) {
+        // Copy the run that needs no escaping in one go
+        size_t plain = rKernels.fnFindEscape(data + i, length - i);
+        result.append(data + i, plain);
+        i += plain;
+        if (i >= length) {
+            break;
+        }
         char c = data[i];
         switch (c) {
             case '\"': result += "\\\""; break;
@@ -969,8 +1564,6 @@ std::string pjson::EncodeForJSON(const char* data, size_t length) {
                 break;
         }
     }
-    
-    return result;
 }
 
 //-----------------------------------------------------------------
@@ -980,23 +1573,11 @@ std::string pjson::EncodeBase64ForJSON(const char* data, size_t length) {
         "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
     
     std::string result;
-    result.reserve((length + 2) / 3 * 4); // Reserve space for base64 output
+    result.resize((length + 2) / 3 * 4); // Room for the whole output
     
-    size_t i = 0;
-    while (i + 2 < length) {
-        // Process 3 bytes at a time
-        uint32_t triplet = (static_cast<unsigned char>(data[i]) << 16) |
-                          (static_cast<unsigned char>(data[i+1]) << 8) |
-                          (static_cast<unsigned char>(data[i+2]));
-        
-        // Convert to 4 characters
-        result += base64_chars[(triplet >> 18) & 0x3F];
-        result += base64_chars[(triplet >> 12) & 0x3F];
-        result += base64_chars[(triplet >> 6) & 0x3F];
-        result += base64_chars[triplet & 0x3F];
-        
-        i += 3;
-    }
+    // Process 3 bytes at a time, as many as the active kernel takes
+    size_t i = pjsonKernels::Active().fnBase64Encode(reinterpret_cast<const unsigned char*>(data), length, &result[0]);
+    result.resize(i / 3 * 4);
     
     // Handle remaining bytes
     if (i + 1 == length) {
@@ -1086,13 +1667,22 @@ std::string pjson::DecodeBase64FromJSON(const std::string& base64Str) {
         0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0, 0
     };
     
+    const pjsonKernels& kernels = pjsonKernels::Active();
     std::string result;
-    result.reserve(base64Str.length() * 3 / 4); // Reserve space for decoded output
+    result.resize(base64Str.length() / 4 * 3 + 3); // Room for the whole output
+    unsigned char* out = reinterpret_cast<unsigned char*>(&result[0]);
+    size_t written = 0;
     
     size_t i = 0;
     while (i < base64Str.length()) {
-        // Skip non-base64 characters
-        if (base64Str[i] == '=' || base64_index[static_cast<unsigned char>(base64Str[i])] == 0) {
+        // Clean groups of 4 alphabet characters go through the kernel
+        size_t used = kernels.fnBase64Decode(base64Str.data() + i, base64Str.length() - i, out + written);
+        i += used;
+        written += used / 4 * 3;
+        if (i >= base64Str.length()) break;
+        
+        // Skip non-base64 characters ('A' is the one valid character indexed 0)
+        if (base64Str[i] == '=' || (base64_index[static_cast<unsigned char>(base64Str[i])] == 0 && base64Str[i] != 'A')) {
             i++;
             continue;
         }
@@ -1104,21 +1694,22 @@ std::string pjson::DecodeBase64FromJSON(const std::string& base64Str) {
         unsigned char a = base64_index[static_cast<unsigned char>(base64Str[i])];
         unsigned char b = base64_index[static_cast<unsigned char>(base64Str[i+1])];
         
-        result += static_cast<char>((a << 2) | (b >> 4));
+        out[written++] = static_cast<unsigned char>((a << 2) | (b >> 4));
         
         if (i + 2 < base64Str.length() && base64Str[i+2] != '=') {
             unsigned char c = base64_index[static_cast<unsigned char>(base64Str[i+2])];
-            result += static_cast<char>(((b & 0x0F) << 4) | (c >> 2));
+            out[written++] = static_cast<unsigned char>(((b & 0x0F) << 4) | (c >> 2));
             
             if (i + 3 < base64Str.length() && base64Str[i+3] != '=') {
                 unsigned char d = base64_index[static_cast<unsigned char>(base64Str[i+3])];
-                result += static_cast<char>(((c & 0x03) << 6) | d);
+                out[written++] = static_cast<unsigned char>(((c & 0x03) << 6) | d);
             }
         }
         
         i += 4;
     }
     
+    result.resize(written);
     return result;
 }
 //-----------------------------------------------------------------
\ No newline at end of file
@@ -0,0 +1,247 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#include "pjson_bind.h"
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+using namespace ByteDance;
+
+//-----------------------------------------------------------------
+// Copies a number span into a terminated buffer for strtol/strtof.
+// Returns false for spans too long to be a sane int/float.
+static bool _CopyNumber(const char* aSrc, size_t a_iStart, size_t a_iLength, char (&a_rBuf)[64]) {
+    if(a_iLength >= sizeof(a_rBuf)) {
+        return false;
+    }
+    memcpy(a_rBuf, aSrc + a_iStart, a_iLength);
+    a_rBuf[a_iLength] = '\0';
+    return true;
+}
+//-----------------------------------------------------------------
+static bool _IsNumberStart(char aChar) {
+    return '+' == aChar || '-' == aChar || '.' == aChar || ('0' <= aChar && '9' >= aChar);
+}
+//-----------------------------------------------------------------
+/*static*/
+char pjsonBindIO::Peek(const char* aSrc, size_t& a_iStart, const size_t a_iEnd) {
+    char aChar = '\0';
+    if(pjson::_ScanToNext(aSrc, a_iStart, a_iEnd, aChar)) {
+        return aChar;
+    }
+    return '\0';
+}
+//-----------------------------------------------------------------
+/*static*/
+bool pjsonBindIO::BeginObject(const char* aSrc, size_t& a_iStart, const size_t a_iEnd) {
+    if('{' != Peek(aSrc, a_iStart, a_iEnd)) {
+        return false;
+    }
+    ++a_iStart; // ignore first char "{"
+    return true;
+}
+//-----------------------------------------------------------------
+/*static*/
+bool pjsonBindIO::NextMember(const char* aSrc, size_t& a_iStart, const size_t a_iEnd,
+                             const char*& a_rKey, size_t& a_rKeyLength, bool& a_rEnd) {
+    a_rEnd = false;
+    char aChar;
+    while(pjson::_ScanToNext(aSrc, a_iStart, a_iEnd, aChar)) {
+        if('}' == aChar) {
+            ++a_iStart;
+            a_rEnd = true;
+            return true;
+        } else if(',' == aChar) {
+            ++a_iStart; // ignore commas
+        } else {
+            size_t iBegin = 0;
+            if(pjson::_ExtractStringSpan(aSrc, a_iStart, a_iEnd, iBegin, a_rKeyLength)
+               && pjson::_ScanPastColon(aSrc, a_iStart, a_iEnd)) {
+                a_rKey = aSrc + iBegin;
+                return true;
+            }
+            break;
+        }
+    }
+    return false;
+}
+//-----------------------------------------------------------------
+/*static*/
+bool pjsonBindIO::BeginArray(const char* aSrc, size_t& a_iStart, const size_t a_iEnd) {
+    if('[' != Peek(aSrc, a_iStart, a_iEnd)) {
+        return false;
+    }
+    ++a_iStart; // ignore first char "["
+    return true;
+}
+//-----------------------------------------------------------------
+/*static*/
+bool pjsonBindIO::NextElement(const char* aSrc, size_t& a_iStart, const size_t a_iEnd, bool& a_rEnd) {
+    a_rEnd = false;
+    char aChar;
+    while(pjson::_ScanToNext(aSrc, a_iStart, a_iEnd, aChar)) {
+        if(']' == aChar) {
+            ++a_iStart;
+            a_rEnd = true;
+            return true;
+        } else if(',' == aChar) {
+            ++a_iStart; // ignore commas
+        } else {
+            return true;
+        }
+    }
+    return false;
+}
+//-----------------------------------------------------------------
+/*static*/
+bool pjsonBindIO::SkipValue(const char* aSrc, size_t& a_iStart, const size_t a_iEnd) {
+    return pjson::_SkipValue(aSrc, a_iStart, a_iEnd);
+}
+//-----------------------------------------------------------------
+/*static*/
+bool pjsonBindIO::Read(const char* aSrc, size_t& a_iStart, const size_t a_iEnd, int& a_rValue) {
+    if(!_IsNumberStart(Peek(aSrc, a_iStart, a_iEnd))) {
+        return SkipValue(aSrc, a_iStart, a_iEnd);
+    }
+    size_t iLength = 0;
+    bool bFloat = false;
+    if(!pjson::_ScanNumberSpan(aSrc, a_iStart, a_iEnd, iLength, bFloat)) {
+        return false;
+    }
+    char buf[64];
+    if(!bFloat && _CopyNumber(aSrc, a_iStart, iLength, buf)) {
+        errno = 0;
+        char* pEnd = nullptr;
+        long lValue = strtol(buf, &pEnd, 10);
+        if(pEnd != buf && 0 == errno && lValue >= INT_MIN && lValue <= INT_MAX) {
+            a_rValue = static_cast<int>(lValue);
+        }
+    }
+    a_iStart += iLength;
+    return true;
+}
+//-----------------------------------------------------------------
+/*static*/
+bool pjsonBindIO::Read(const char* aSrc, size_t& a_iStart, const size_t a_iEnd, int64_t& a_rValue) {
+    if(!_IsNumberStart(Peek(aSrc, a_iStart, a_iEnd))) {
+        return SkipValue(aSrc, a_iStart, a_iEnd);
+    }
+    size_t iLength = 0;
+    bool bFloat = false;
+    if(!pjson::_ScanNumberSpan(aSrc, a_iStart, a_iEnd, iLength, bFloat)) {
+        return false;
+    }
+    char buf[64];
+    if(!bFloat && _CopyNumber(aSrc, a_iStart, iLength, buf)) {
+        errno = 0;
+        char* pEnd = nullptr;
+        long long lValue = strtoll(buf, &pEnd, 10);
+        if(pEnd != buf && 0 == errno) {
+            a_rValue = static_cast<int64_t>(lValue);
+        }
+    }
+    a_iStart += iLength;
+    return true;
+}
+//-----------------------------------------------------------------
+/*static*/
+bool pjsonBindIO::Read(const char* aSrc, size_t& a_iStart, const size_t a_iEnd, double& a_rValue) {
+    if(!_IsNumberStart(Peek(aSrc, a_iStart, a_iEnd))) {
+        return SkipValue(aSrc, a_iStart, a_iEnd);
+    }
+    size_t iLength = 0;
+    bool bFloat = false;
+    if(!pjson::_ScanNumberSpan(aSrc, a_iStart, a_iEnd, iLength, bFloat)) {
+        return false;
+    }
+    char buf[64];
+    if(_CopyNumber(aSrc, a_iStart, iLength, buf)) {
+        char* pEnd = nullptr;
+        double dValue = strtod(buf, &pEnd);
+        if(pEnd != buf) {
+            a_rValue = dValue;
+        }
+    }
+    a_iStart += iLength;
+    return true;
+}
+//-----------------------------------------------------------------
+/*static*/
+bool pjsonBindIO::Read(const char* aSrc, size_t& a_iStart, const size_t a_iEnd, float& a_rValue) {
+    if(!_IsNumberStart(Peek(aSrc, a_iStart, a_iEnd))) {
+        return SkipValue(aSrc, a_iStart, a_iEnd);
+    }
+    size_t iLength = 0;
+    bool bFloat = false;
+    if(!pjson::_ScanNumberSpan(aSrc, a_iStart, a_iEnd, iLength, bFloat)) {
+        return false;
+    }
+    char buf[64];
+    if(_CopyNumber(aSrc, a_iStart, iLength, buf)) {
+        char* pEnd = nullptr;
+        float fValue = strtof(buf, &pEnd);
+        if(pEnd != buf) {
+            a_rValue = fValue;
+        }
+    }
+    a_iStart += iLength;
+    return true;
+}
+//-----------------------------------------------------------------
+/*static*/
+bool pjsonBindIO::Read(const char* aSrc, size_t& a_iStart, const size_t a_iEnd, bool& a_rValue) {
+    char aChar = tolower(Peek(aSrc, a_iStart, a_iEnd));
+    if(!SkipValue(aSrc, a_iStart, a_iEnd)) {
+        return false;
+    }
+    if('t' == aChar || 'f' == aChar) {
+        a_rValue = ('t' == aChar);
+    }
+    return true;
+}
+//-----------------------------------------------------------------
+/*static*/
+bool pjsonBindIO::Read(const char* aSrc, size_t& a_iStart, const size_t a_iEnd, std::string& a_rValue) {
+    if('\"' != Peek(aSrc, a_iStart, a_iEnd)) {
+        return SkipValue(aSrc, a_iStart, a_iEnd);
+    }
+    size_t iBegin = 0;
+    size_t iLength = 0;
+    if(!pjson::_ExtractStringSpan(aSrc, a_iStart, a_iEnd, iBegin, iLength)) {
+        return false;
+    }
+    a_rValue.assign(aSrc + iBegin, iLength);
+    return true;
+}
+//-----------------------------------------------------------------
+/*static*/
+bool pjsonBindIO::Read(const char* aSrc, size_t& a_iStart, const size_t a_iEnd, pjson& a_rValue) {
+    // An explicit pjson member is the one place a tree is built
+    Peek(aSrc, a_iStart, a_iEnd);
+    size_t iBegin = a_iStart;
+    if(!SkipValue(aSrc, a_iStart, a_iEnd)) {
+        return false;
+    }
+    pjson* pResult = nullptr;
+    if(pjson::_CreateFromString(aSrc, iBegin, a_iStart, pResult)) {
+        a_rValue = std::move(*pResult);
+    }
+    delete pResult;
+    return true;
+}
+//-----------------------------------------------------------------
@@ -0,0 +1,335 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#include "pjson_cache.h"
+#include <algorithm>
+#include <mutex>
+using namespace ByteDance;
+
+//-----------------------------------------------------------------
+// Stamps are unique across all caches and nodes, so an entry never matches
+// a node that was changed, or freed and reused, since it was written
+static uint32_t _NextStamp() {
+    static std::atomic<uint32_t> s_iStamp{0};
+    uint32_t iStamp = s_iStamp.fetch_add(1, std::memory_order_relaxed) + 1;
+    if(0 == iStamp) { // wrapped; 0 means "not cached"
+        iStamp = s_iStamp.fetch_add(1, std::memory_order_relaxed) + 1;
+    }
+    return iStamp;
+}
+//-----------------------------------------------------------------
+// Slots in use, by root; a root's slot is freed with the last cache following it
+struct _CacheSlotTable {
+    std::mutex oLock;
+    std::unordered_map<const void*, std::pair<uint16_t, size_t>> mRoots; // slot, caches
+    std::vector<uint16_t> vFree;
+    uint16_t iNext = 1; // 0 marks "no slot"
+};
+static _CacheSlotTable& _SlotTable() {
+    static _CacheSlotTable* s_pTable = new _CacheSlotTable(); // outlives static caches
+    return *s_pTable;
+}
+//-----------------------------------------------------------------
+pjson::CacheSlot::~CacheSlot() {
+    _release();
+}
+//-----------------------------------------------------------------
+/*static*/
+std::atomic<uint64_t>* pjson::CacheSlot::_Epochs() {
+    static std::atomic<uint64_t> s_aEpochs[Count]; // zero initialized
+    return s_aEpochs;
+}
+//-----------------------------------------------------------------
+bool pjson::CacheSlot::follow(const pjson& aRoot) {
+    bool bKeep = (&aRoot == _pRoot);
+    if(!bKeep) {
+        _release();
+        _CacheSlotTable& rTable = _SlotTable();
+        std::lock_guard<std::mutex> oLock(rTable.oLock);
+        auto it = rTable.mRoots.find(&aRoot);
+        if(it == rTable.mRoots.end()) {
+            uint16_t iSlot = Shared;
+            if(!rTable.vFree.empty()) {
+                iSlot = rTable.vFree.back();
+                rTable.vFree.pop_back();
+            } else if(rTable.iNext < Shared) {
+                iSlot = rTable.iNext++;
+            }
+            it = rTable.mRoots.emplace(&aRoot, std::make_pair(iSlot, size_t(0))).first;
+        }
+        ++it->second.second;
+        _iSlot = it->second.first;
+        _pRoot = &aRoot;
+    }
+    uint64_t iEpoch = _Epochs()[_iSlot].load(std::memory_order_acquire);
+    uint64_t iSharedEpoch = _Epochs()[Shared].load(std::memory_order_acquire);
+    bKeep = bKeep && iEpoch == _iEpoch && iSharedEpoch == _iSharedEpoch;
+    _iEpoch = iEpoch;
+    _iSharedEpoch = iSharedEpoch;
+    return bKeep;
+}
+//-----------------------------------------------------------------
+void pjson::CacheSlot::_release() {
+    if(nullptr == _pRoot) {
+        return;
+    }
+    _CacheSlotTable& rTable = _SlotTable();
+    std::lock_guard<std::mutex> oLock(rTable.oLock);
+    auto it = rTable.mRoots.find(_pRoot);
+    if(it != rTable.mRoots.end() && 0 == --it->second.second) {
+        if(Shared != it->second.first) {
+            rTable.vFree.push_back(it->second.first); // nodes still naming it only cost a spurious start over
+        }
+        rTable.mRoots.erase(it);
+    }
+    _pRoot = nullptr;
+    _iSlot = 0;
+}
+//-----------------------------------------------------------------
+// Called whenever a container is written or hashed under a cache, whether or
+// not its own entry is kept: a cached ancestor includes its children as well
+void pjson::CacheSlot::cover(const pjson& aNode) const {
+    auto fnCover = [this](const pjson* aChild) {
+        uint16_t iSlot = aChild->_iCacheSlot.load(std::memory_order_relaxed);
+        while(iSlot != _iSlot && Shared != iSlot
+              && !aChild->_iCacheSlot.compare_exchange_weak(iSlot, (0 == iSlot) ? _iSlot : uint16_t(Shared),
+                                                             std::memory_order_relaxed)) {
+        }
+    };
+    if(jsonType::jsonArray == aNode._eType) {
+        for(const pjson* pChild : *aNode._pValueArray) {
+            fnCover(pChild);
+        }
+    } else if(jsonType::jsonMap == aNode._eType) {
+        for(auto const& it : *aNode._pValueMap) {
+            fnCover(it.second);
+        }
+    }
+    aNode._iCacheFlags.fetch_or(CacheCoversChildren, std::memory_order_relaxed);
+}
+//-----------------------------------------------------------------
+/*static*/
+uint32_t pjson::CacheSlot::Stamp(const pjson& aNode) {
+    uint32_t iStamp = aNode._iCacheStamp.load(std::memory_order_relaxed);
+    if(0 == iStamp) {
+        uint32_t iNew = _NextStamp();
+        // another cache on another thread may stamp the same unchanged node
+        iStamp = aNode._iCacheStamp.compare_exchange_strong(iStamp, iNew, std::memory_order_relaxed) ? iNew : iStamp;
+    }
+    return iStamp;
+}
+//-----------------------------------------------------------------
+/*static*/
+void pjson::CacheSlot::Touch(uint16_t a_iSlot) {
+    _Epochs()[a_iSlot].fetch_add(1, std::memory_order_release);
+}
+//-----------------------------------------------------------------
+pjson::SerializeCache::SerializeCache(const SerializeOptions& aOptions /*= SerializeOptions()*/,
+                                      size_t a_iMinBytes /*= 128*/, size_t a_iMaxDepth /*= 16*/)
+        : _oOptions(aOptions)
+        , _iMinBytes(a_iMinBytes)
+        , _iMaxDepth(a_iMaxDepth)
+{
+
+}
+//-----------------------------------------------------------------
+std::string pjson::SerializeCache::toString(const pjson& aRoot) {
+    std::string sOut;
+    toString(aRoot, sOut);
+    return sOut;
+}
+//-----------------------------------------------------------------
+void pjson::SerializeCache::toString(const pjson& aRoot, std::string& a_rOut) {
+    // A node was edited through a kept reference since the last call; its
+    // cached parents cannot be told apart from the others
+    if(!_oSlot.follow(aRoot)) {
+        clear();
+    }
+    _iDepth = 0;
+    aRoot._serialize(a_rOut, _oOptions, this);
+}
+//-----------------------------------------------------------------
+void pjson::SerializeCache::clear() {
+    _mEntries.clear();
+    _iCachedBytes = 0;
+}
+//-----------------------------------------------------------------
+size_t pjson::SerializeCache::entries() const {
+    return _mEntries.size();
+}
+//-----------------------------------------------------------------
+size_t pjson::SerializeCache::cachedBytes() const {
+    return _iCachedBytes;
+}
+//-----------------------------------------------------------------
+// Called before a container is written; true when its saved text was appended
+bool pjson::SerializeCache::_splice(const pjson& aNode, int a_iContext, std::string& a_rOut) {
+    if(_iDepth < _iMaxDepth) {
+        auto it = _mEntries.find(&aNode);
+        if(it != _mEntries.end() && it->second.iContext == a_iContext
+           && it->second.iStamp == aNode._iCacheStamp.load(std::memory_order_relaxed)) {
+            a_rOut += it->second.sText;
+            return true;
+        }
+    }
+    ++_iDepth;
+    return false;
+}
+//-----------------------------------------------------------------
+// Called after a container was written to aOut from a_iBegin on
+void pjson::SerializeCache::_store(const pjson& aNode, int a_iContext, const std::string& aOut, size_t a_iBegin) {
+    --_iDepth;
+    _oSlot.cover(aNode);
+    if(_iDepth >= _iMaxDepth) {
+        return;
+    }
+    size_t iLength = aOut.length() - a_iBegin;
+    if(iLength < _iMinBytes) {
+        _erase(&aNode); // may have been larger before
+        return;
+    }
+    Entry& rEntry = _mEntries[&aNode]; // new entries start zeroed
+    _iCachedBytes -= rEntry.sText.length();
+    rEntry.iStamp = CacheSlot::Stamp(aNode);
+    rEntry.iContext = a_iContext;
+    rEntry.sText.assign(aOut, a_iBegin, iLength);
+    _iCachedBytes += iLength;
+    _updateChildren(aNode, rEntry);
+}
+//-----------------------------------------------------------------
+// Entries of children that left the node (and so may be freed) are dropped.
+// Only the saved pointers are used, never the nodes they pointed to.
+void pjson::SerializeCache::_updateChildren(const pjson& aNode, Entry& a_rEntry) {
+    std::vector<const pjson*> vChildren;
+    if(jsonType::jsonArray == aNode._eType) {
+        for(const pjson* pChild : *aNode._pValueArray) {
+            if(jsonType::jsonArray == pChild->_eType || jsonType::jsonMap == pChild->_eType) {
+                vChildren.push_back(pChild);
+            }
+        }
+    } else if(jsonType::jsonMap == aNode._eType) {
+        for(auto const& it : *aNode._pValueMap) {
+            if(jsonType::jsonArray == it.second->_eType || jsonType::jsonMap == it.second->_eType) {
+                vChildren.push_back(it.second);
+            }
+        }
+    }
+    // An edit below the node usually leaves the same children in place
+    if(!a_rEntry.vChildren.empty() && vChildren != a_rEntry.vChildren) {
+        std::vector<const pjson*> vSorted(vChildren);
+        std::sort(vSorted.begin(), vSorted.end());
+        for(const pjson* pOld : a_rEntry.vChildren) {
+            if(!std::binary_search(vSorted.begin(), vSorted.end(), pOld)) {
+                _erase(pOld);
+            }
+        }
+    }
+    a_rEntry.vChildren.swap(vChildren);
+}
+//-----------------------------------------------------------------
+void pjson::SerializeCache::_erase(const pjson* aNode) {
+    auto it = _mEntries.find(aNode);
+    if(it == _mEntries.end()) {
+        return;
+    }
+    std::vector<const pjson*> vChildren;
+    vChildren.swap(it->second.vChildren);
+    _iCachedBytes -= it->second.sText.length();
+    _mEntries.erase(it);
+    for(const pjson* pChild : vChildren) {
+        _erase(pChild);
+    }
+}
+//-----------------------------------------------------------------
+pjson::HashCache::HashCache(size_t a_iMinChildren /*= 4*/)
+        : _iMinChildren(a_iMinChildren)
+        , _iSweepAt(1024)
+{
+
+}
+//-----------------------------------------------------------------
+uint64_t pjson::HashCache::hash(const pjson& aRoot) {
+    if(!_oSlot.follow(aRoot)) {
+        clear();
+    }
+    uint64_t iHash = aRoot._hash(this);
+    if(_mEntries.size() >= _iSweepAt) {
+        _sweep(aRoot);
+    }
+    return iHash;
+}
+//-----------------------------------------------------------------
+void pjson::HashCache::clear() {
+    _mEntries.clear();
+}
+//-----------------------------------------------------------------
+size_t pjson::HashCache::entries() const {
+    return _mEntries.size();
+}
+//-----------------------------------------------------------------
+bool pjson::HashCache::_find(const pjson& aNode, uint64_t& a_rHash) const {
+    auto it = _mEntries.find(&aNode);
+    if(it == _mEntries.end() || it->second.iStamp != aNode._iCacheStamp.load(std::memory_order_relaxed)) {
+        return false;
+    }
+    a_rHash = it->second.iHash;
+    return true;
+}
+//-----------------------------------------------------------------
+// Called after an array / object was hashed
+void pjson::HashCache::_store(const pjson& aNode, uint64_t a_iHash) {
+    _oSlot.cover(aNode);
+    size_t iChildren = (jsonType::jsonArray == aNode._eType) ? aNode._pValueArray->size() : aNode._pValueMap->size();
+    if(iChildren < _iMinChildren) {
+        return;
+    }
+    Entry& rEntry = _mEntries[&aNode];
+    rEntry.iStamp = CacheSlot::Stamp(aNode);
+    rEntry.iHash = a_iHash;
+}
+//-----------------------------------------------------------------
+// Keeps only the entries of containers still in the document and unchanged.
+// Entries are never dereferenced, only the live tree is walked.
+void pjson::HashCache::_sweep(const pjson& aRoot) {
+    std::unordered_map<const pjson*, Entry> mLive;
+    std::vector<const pjson*> vPending(1, &aRoot);
+    while(!vPending.empty()) {
+        const pjson* pNode = vPending.back();
+        vPending.pop_back();
+        auto it = _mEntries.find(pNode);
+        if(it != _mEntries.end() && it->second.iStamp == pNode->_iCacheStamp.load(std::memory_order_relaxed)) {
+            mLive.emplace(pNode, it->second);
+        }
+        if(jsonType::jsonArray == pNode->_eType) {
+            for(const pjson* pChild : *pNode->_pValueArray) {
+                if(jsonType::jsonArray == pChild->_eType || jsonType::jsonMap == pChild->_eType) {
+                    vPending.push_back(pChild);
+                }
+            }
+        } else if(jsonType::jsonMap == pNode->_eType) {
+            for(auto const& itChild : *pNode->_pValueMap) {
+                if(jsonType::jsonArray == itChild.second->_eType || jsonType::jsonMap == itChild.second->_eType) {
+                    vPending.push_back(itChild.second);
+                }
+            }
+        }
+    }
+    _mEntries.swap(mLive);
+    _iSweepAt = std::max<size_t>(1024, 2 * _mEntries.size());
+}
+//-----------------------------------------------------------------
@@ -0,0 +1,539 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#include "pjson_columns.h"
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <cstring>
+#include <thread>
+using namespace ByteDance;
+
+// A batch ends at whichever limit comes first
+static const size_t _BATCH_RECORDS = 16384;
+static const size_t _BATCH_BYTES = 8 * 1024 * 1024;
+// Fewer records than this per worker are not worth a thread
+static const size_t _MIN_RECORDS_PER_WORKER = 256;
+
+//-----------------------------------------------------------------
+// "a.b[2].c"; false on empty keys, bad brackets or wildcards
+static bool _ParseColumnPath(const std::string& aPath, std::vector<std::pair<std::string, size_t> >& a_rSteps) {
+    static const size_t iKeyStep = SIZE_MAX; // second of a key step
+    size_t i = 0;
+    const size_t iSize = aPath.size();
+    if(0 == iSize) {
+        return false;
+    }
+    while(i < iSize) {
+        if('[' == aPath[i]) {
+            size_t iClose = aPath.find(']', i);
+            if(std::string::npos == iClose || iClose == i + 1) {
+                return false;
+            }
+            size_t iIndex = 0;
+            for(size_t j = i + 1; j < iClose; ++j) {
+                if(aPath[j] < '0' || aPath[j] > '9') {
+                    return false; // also "[*]"
+                }
+                iIndex = iIndex * 10 + (aPath[j] - '0');
+            }
+            a_rSteps.emplace_back(std::string(), iIndex);
+            i = iClose + 1;
+        } else {
+            size_t iEnd = aPath.find_first_of(".[", i);
+            if(std::string::npos == iEnd) {
+                iEnd = iSize;
+            }
+            if(iEnd == i || "*" == aPath.substr(i, iEnd - i)) {
+                return false;
+            }
+            a_rSteps.emplace_back(aPath.substr(i, iEnd - i), iKeyStep);
+            i = iEnd;
+        }
+        if(i < iSize && '.' == aPath[i]) {
+            ++i;
+            if(i == iSize || '[' == aPath[i]) {
+                return false;
+            }
+        } else if(i < iSize && '[' != aPath[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+//-----------------------------------------------------------------
+// Number text into an integer: exact when it has no fraction or exponent
+static bool _ToInt64(const char* aText, size_t a_iLength, bool a_bFloat, int64_t& a_rValue) {
+    char aBuffer[64];
+    std::string sLong;
+    const char* pText = aBuffer;
+    if(a_iLength < sizeof(aBuffer)) {
+        memcpy(aBuffer, aText, a_iLength);
+        aBuffer[a_iLength] = '\0';
+    } else {
+        sLong.assign(aText, a_iLength);
+        pText = sLong.c_str();
+    }
+    if(!a_bFloat) {
+        errno = 0;
+        long long iValue = strtoll(pText, nullptr, 10);
+        if(ERANGE == errno) {
+            return false;
+        }
+        a_rValue = iValue;
+        return true;
+    }
+    double dValue = strtod(pText, nullptr);
+    if(!(dValue > -9223372036854775808.0 && dValue < 9223372036854775808.0)) {
+        return false; // also NaN
+    }
+    a_rValue = static_cast<int64_t>(dValue);
+    return true;
+}
+//-----------------------------------------------------------------
+static double _ToDouble(const char* aText, size_t a_iLength) {
+    char aBuffer[64];
+    if(a_iLength < sizeof(aBuffer)) {
+        memcpy(aBuffer, aText, a_iLength);
+        aBuffer[a_iLength] = '\0';
+        return strtod(aBuffer, nullptr);
+    }
+    return strtod(std::string(aText, a_iLength).c_str(), nullptr);
+}
+//-----------------------------------------------------------------
+const pjson::ColumnReader::Step* pjson::ColumnReader::Step::key(const char* aKey, size_t a_iLength) const {
+    for(auto const& it : vKeys) {
+        if(it.first.length() == a_iLength && 0 == memcmp(it.first.data(), aKey, a_iLength)) {
+            return it.second;
+        }
+    }
+    return nullptr;
+}
+//-----------------------------------------------------------------
+const pjson::ColumnReader::Step* pjson::ColumnReader::Step::index(size_t a_iIndex) const {
+    for(auto const& it : vIndices) {
+        if(it.first == a_iIndex) {
+            return it.second;
+        }
+    }
+    return nullptr;
+}
+//-----------------------------------------------------------------
+pjson::ColumnReader::ColumnReader() {
+    _vSteps.emplace_back(); // root
+}
+//-----------------------------------------------------------------
+bool pjson::ColumnReader::add(const std::string& aPath, Type aeType) {
+    std::vector<std::pair<std::string, size_t> > vSteps;
+    if(_iRows > 0 || !_ParseColumnPath(aPath, vSteps)) {
+        return false;
+    }
+    Step* pStep = &_vSteps.front();
+    for(auto const& rStep : vSteps) {
+        const bool bKey = !rStep.first.empty();
+        Step* pChild = const_cast<Step*>(bKey ? pStep->key(rStep.first.data(), rStep.first.length()) : pStep->index(rStep.second));
+        if(nullptr == pChild) {
+            _vSteps.emplace_back();
+            pChild = &_vSteps.back();
+            if(bKey) {
+                pStep->vKeys.emplace_back(rStep.first, pChild);
+            } else {
+                pStep->vIndices.emplace_back(rStep.second, pChild);
+            }
+        }
+        pStep = pChild;
+    }
+    pStep->vColumns.push_back(_vColumns.size());
+    _vColumns.push_back(Column(aPath, aeType));
+    return true;
+}
+//-----------------------------------------------------------------
+size_t pjson::ColumnReader::columns() const {
+    return _vColumns.size();
+}
+//-----------------------------------------------------------------
+const pjson::ColumnReader::Column& pjson::ColumnReader::column(size_t a_iIndex) const {
+    return _vColumns[a_iIndex];
+}
+//-----------------------------------------------------------------
+size_t pjson::ColumnReader::rows() const {
+    return _iRows;
+}
+//-----------------------------------------------------------------
+size_t pjson::ColumnReader::malformed() const {
+    return _iMalformed;
+}
+//-----------------------------------------------------------------
+void pjson::ColumnReader::reserve(size_t a_iRows) {
+    for(Column& rColumn : _vColumns) {
+        rColumn._vValid.reserve((a_iRows + 7) / 8);
+        if(typeString == rColumn._eType) {
+            rColumn._vOffsets.reserve(a_iRows + 1);
+        } else {
+            rColumn._vValues.reserve((a_iRows * rColumn._width() + 7) / 8);
+        }
+    }
+}
+//-----------------------------------------------------------------
+void pjson::ColumnReader::clearRows() {
+    for(Column& rColumn : _vColumns) {
+        rColumn._iRows = 0;
+        rColumn._iNulls = 0;
+        rColumn._vValid.clear();
+        rColumn._vValues.clear();
+        rColumn._vOffsets.assign((typeString == rColumn._eType) ? 1 : 0, 0);
+        rColumn._sChars.clear();
+    }
+    _iRows = 0;
+    _iMalformed = 0;
+}
+//-----------------------------------------------------------------
+bool pjson::ColumnReader::append(const char* aSrc, size_t a_iSize) {
+    _begin(1, 1);
+    const size_t iEnd = a_iSize;
+    _extractRange(aSrc, &iEnd, 0, 1, &_vSlices[0]);
+    const bool bGood = (0 == _vSlices[0].iMalformed);
+    _finish(1);
+    return bGood;
+}
+//-----------------------------------------------------------------
+bool pjson::ColumnReader::read(RecordReader& a_rReader, size_t a_iThreads) {
+    if(0 == a_iThreads) {
+        a_iThreads = std::max<size_t>(1, std::thread::hardware_concurrency());
+    }
+    std::string aText[2];
+    std::vector<size_t> aEnds[2];
+    size_t iCurrent = 0;
+    _gather(a_rReader, aText[iCurrent], aEnds[iCurrent]);
+    while(!aEnds[iCurrent].empty()) {
+        const std::string& rText = aText[iCurrent];
+        const std::vector<size_t>& rEnds = aEnds[iCurrent];
+        const size_t iRecords = rEnds.size();
+        const size_t iNext = 1 - iCurrent;
+        if(1 == a_iThreads) {
+            _begin(iRecords, 1);
+            _extractRange(rText.data(), rEnds.data(), 0, iRecords, &_vSlices[0]);
+            _gather(a_rReader, aText[iNext], aEnds[iNext]);
+        } else {
+            // the next batch is read while this one is extracted
+            const size_t iWorkers = std::max<size_t>(1, std::min(a_iThreads, iRecords / _MIN_RECORDS_PER_WORKER));
+            _begin(iRecords, iWorkers);
+            std::vector<std::thread> vWorkers;
+            for(size_t w = 0; w < iWorkers; ++w) {
+                vWorkers.emplace_back(&ColumnReader::_extractRange, this, rText.data(), rEnds.data(),
+                                      iRecords * w / iWorkers, iRecords * (w + 1) / iWorkers, &_vSlices[w]);
+            }
+            _gather(a_rReader, aText[iNext], aEnds[iNext]);
+            for(std::thread& rWorker : vWorkers) {
+                rWorker.join();
+            }
+        }
+        _finish(iRecords);
+        iCurrent = iNext;
+    }
+    return !a_rReader.failed();
+}
+//-----------------------------------------------------------------
+// Copies the next batch of records out of the reader's buffer
+void pjson::ColumnReader::_gather(RecordReader& a_rReader, std::string& a_rText, std::vector<size_t>& a_rEnds) {
+    a_rText.clear();
+    a_rEnds.clear();
+    const char* pText = nullptr;
+    size_t iLength = 0;
+    while(a_rEnds.size() < _BATCH_RECORDS && a_rText.size() < _BATCH_BYTES && a_rReader.nextText(pText, iLength)) {
+        a_rText.append(pText, iLength);
+        a_rEnds.push_back(a_rText.size());
+    }
+}
+//-----------------------------------------------------------------
+// Grows every column by a_iRecords null rows for the workers to fill in place
+void pjson::ColumnReader::_begin(size_t a_iRecords, size_t a_iWorkers) {
+    const size_t iRows = _iRows + a_iRecords;
+    for(Column& rColumn : _vColumns) {
+        if(typeString == rColumn._eType) {
+            rColumn._vOffsets.resize(iRows + 1, 0);
+        } else {
+            rColumn._vValues.resize((iRows * rColumn._width() + 7) / 8, 0);
+        }
+    }
+    _vFound.assign(a_iRecords * _vColumns.size(), 0);
+    _vSlices.resize(a_iWorkers);
+    for(Slice& rSlice : _vSlices) {
+        rSlice.vChars.resize(_vColumns.size());
+        for(std::string& rChars : rSlice.vChars) {
+            rChars.clear();
+        }
+        rSlice.iMalformed = 0;
+    }
+}
+//-----------------------------------------------------------------
+void pjson::ColumnReader::_extractRange(const char* aText, const size_t* aEnds, size_t a_iFirst, size_t a_iLast, Slice* a_pSlice) {
+    for(size_t r = a_iFirst; r < a_iLast; ++r) {
+        const size_t iBegin = (0 == r) ? 0 : aEnds[r - 1];
+        if(!_extractRecord(aText + iBegin, aEnds[r] - iBegin, r, *a_pSlice)) {
+            ++a_pSlice->iMalformed;
+        }
+    }
+}
+//-----------------------------------------------------------------
+bool pjson::ColumnReader::_extractRecord(const char* aSrc, size_t a_iSize, size_t a_iRecord, Slice& a_rSlice) {
+    size_t i = 0;
+    char aChar;
+    if(!_ScanToNext(aSrc, i, a_iSize, aChar)) {
+        return false;
+    }
+    size_t iFound = 0;
+    return _extractValue(aSrc, i, a_iSize, _vSteps.front(), a_iRecord, a_rSlice, iFound, 0);
+}
+//-----------------------------------------------------------------
+// Stores the columns ending at aStep, then walks into the value only as far
+// as its steps lead; everything else is skipped. Stops early once every
+// column of the record has its value.
+bool pjson::ColumnReader::_extractValue(const char* aSrc, size_t& a_iStart, size_t a_iEnd, const Step& aStep, size_t a_iRecord,
+                                        Slice& a_rSlice, size_t& a_rFound, size_t a_iDepth) {
+    for(size_t iColumn : aStep.vColumns) {
+        _store(iColumn, aSrc, a_iStart, a_iEnd, a_iRecord, a_rSlice, a_rFound);
+    }
+    const char aOpen = aSrc[a_iStart];
+    const bool bObject = ('{' == aOpen && !aStep.vKeys.empty());
+    const bool bArray = ('[' == aOpen && !aStep.vIndices.empty());
+    if(!bObject && !bArray) {
+        return _SkipValue(aSrc, a_iStart, a_iEnd);
+    }
+    if(a_iDepth >= GetMaxParseDepth()) {
+        return false;
+    }
+    const char aClose = bObject ? '}' : ']';
+    size_t iIndex = 0;
+    size_t iKey = 0;
+    size_t iKeyLength = 0;
+    char aChar;
+    ++a_iStart;
+    while(_ScanToNext(aSrc, a_iStart, a_iEnd, aChar)) {
+        if(aClose == aChar) {
+            ++a_iStart;
+            return true;
+        }
+        if(',' == aChar) {
+            ++a_iStart;
+            continue;
+        }
+        const Step* pChild = nullptr;
+        if(bObject) {
+            if(!_ExtractStringSpan(aSrc, a_iStart, a_iEnd, iKey, iKeyLength) || !_ScanPastColon(aSrc, a_iStart, a_iEnd)
+               || !_ScanToNext(aSrc, a_iStart, a_iEnd, aChar)) {
+                return false;
+            }
+            pChild = aStep.key(aSrc + iKey, iKeyLength);
+        } else {
+            pChild = aStep.index(iIndex++);
+        }
+        if(pChild) {
+            if(!_extractValue(aSrc, a_iStart, a_iEnd, *pChild, a_iRecord, a_rSlice, a_rFound, a_iDepth + 1)) {
+                return false;
+            }
+            if(a_rFound == _vColumns.size()) {
+                return true; // the rest of the record is not needed
+            }
+        } else if(!_SkipValue(aSrc, a_iStart, a_iEnd)) {
+            return false;
+        }
+    }
+    return false;
+}
+//-----------------------------------------------------------------
+void pjson::ColumnReader::_store(size_t a_iColumn, const char* aSrc, size_t a_iStart, size_t a_iEnd, size_t a_iRecord,
+                                 Slice& a_rSlice, size_t& a_rFound) {
+    uint8_t& rFound = _vFound[a_iRecord * _vColumns.size() + a_iColumn];
+    if(rFound) {
+        return; // repeated key: the first value stays
+    }
+    Column& rColumn = _vColumns[a_iColumn];
+    const size_t iRow = _iRows + a_iRecord;
+    const char aFirst = static_cast<char>(tolower(static_cast<unsigned char>(aSrc[a_iStart])));
+    if(typeString == rColumn._eType) {
+        size_t iBegin = 0;
+        size_t iLength = 0;
+        if('\"' != aFirst || !_ExtractStringSpan(aSrc, a_iStart, a_iEnd, iBegin, iLength)) {
+            return;
+        }
+        a_rSlice.vChars[a_iColumn].append(aSrc + iBegin, iLength);
+        rColumn._vOffsets[iRow + 1] = iLength; // a length until _finish()
+        rFound = 1;
+        ++a_rFound;
+        return;
+    }
+    char* pValue = reinterpret_cast<char*>(rColumn._vValues.data()) + iRow * rColumn._width();
+    if(typeBool == rColumn._eType) {
+        if(_MatchLiteral(aSrc, a_iStart, a_iEnd, "true", 4)) {
+            *pValue = 1;
+        } else if(_MatchLiteral(aSrc, a_iStart, a_iEnd, "false", 5)) {
+            *pValue = 0;
+        } else {
+            return;
+        }
+        rFound = 1;
+        ++a_rFound;
+        return;
+    }
+    size_t iLength = 0;
+    bool bFloat = false;
+    if(('-' != aFirst && '.' != aFirst && !isdigit(static_cast<unsigned char>(aFirst)))
+       || !_ScanNumberSpan(aSrc, a_iStart, a_iEnd, iLength, bFloat) || 0 == iLength) {
+        return;
+    }
+    const char* pText = aSrc + a_iStart;
+    switch(rColumn._eType) {
+        case typeInt32:
+        case typeInt64: {
+            int64_t iValue = 0;
+            if(!_ToInt64(pText, iLength, bFloat, iValue)) {
+                return;
+            }
+            if(typeInt64 == rColumn._eType) {
+                memcpy(pValue, &iValue, sizeof(iValue));
+            } else if(iValue < INT_MIN || iValue > INT_MAX) {
+                return;
+            } else {
+                int32_t iNarrow = static_cast<int32_t>(iValue);
+                memcpy(pValue, &iNarrow, sizeof(iNarrow));
+            }
+            break;
+        }
+        case typeFloat: {
+            float fValue = static_cast<float>(_ToDouble(pText, iLength));
+            memcpy(pValue, &fValue, sizeof(fValue));
+            break;
+        }
+        default: {
+            double dValue = _ToDouble(pText, iLength);
+            memcpy(pValue, &dValue, sizeof(dValue));
+            break;
+        }
+    }
+    rFound = 1;
+    ++a_rFound;
+}
+//-----------------------------------------------------------------
+// Single threaded: null bitmaps, string offsets and string bytes, in row order
+void pjson::ColumnReader::_finish(size_t a_iRecords) {
+    const size_t iColumns = _vColumns.size();
+    for(size_t c = 0; c < iColumns; ++c) {
+        Column& rColumn = _vColumns[c];
+        rColumn._vValid.resize((_iRows + a_iRecords + 7) / 8, 0);
+        for(size_t r = 0; r < a_iRecords; ++r) {
+            const size_t iRow = _iRows + r;
+            if(_vFound[r * iColumns + c]) {
+                rColumn._vValid[iRow / 8] |= static_cast<uint8_t>(1u << (iRow % 8));
+            } else {
+                ++rColumn._iNulls;
+            }
+        }
+        if(typeString == rColumn._eType) {
+            for(size_t r = 0; r < a_iRecords; ++r) {
+                const size_t iRow = _iRows + r;
+                rColumn._vOffsets[iRow + 1] += rColumn._vOffsets[iRow];
+            }
+            for(Slice& rSlice : _vSlices) {
+                rColumn._sChars += rSlice.vChars[c];
+            }
+        }
+        rColumn._iRows = _iRows + a_iRecords;
+    }
+    for(const Slice& rSlice : _vSlices) {
+        _iMalformed += rSlice.iMalformed;
+    }
+    _iRows += a_iRecords;
+}
+//-----------------------------------------------------------------
+pjson::ColumnReader::Column::Column(const std::string& aPath, Type aeType) : _sPath(aPath), _eType(aeType) {
+    if(typeString == _eType) {
+        _vOffsets.push_back(0);
+    }
+}
+//-----------------------------------------------------------------
+size_t pjson::ColumnReader::Column::_width() const {
+    switch(_eType) {
+        case typeBool:  { return sizeof(uint8_t); }
+        case typeInt32: { return sizeof(int32_t); }
+        case typeFloat: { return sizeof(float); }
+        default:        { return sizeof(int64_t); }
+    }
+}
+//-----------------------------------------------------------------
+const std::string& pjson::ColumnReader::Column::path() const {
+    return _sPath;
+}
+//-----------------------------------------------------------------
+pjson::ColumnReader::Type pjson::ColumnReader::Column::type() const {
+    return _eType;
+}
+//-----------------------------------------------------------------
+size_t pjson::ColumnReader::Column::size() const {
+    return _iRows;
+}
+//-----------------------------------------------------------------
+size_t pjson::ColumnReader::Column::nulls() const {
+    return _iNulls;
+}
+//-----------------------------------------------------------------
+bool pjson::ColumnReader::Column::isNull(size_t a_iRow) const {
+    return a_iRow >= _iRows || 0 == (_vValid[a_iRow / 8] & (1u << (a_iRow % 8)));
+}
+//-----------------------------------------------------------------
+const uint8_t* pjson::ColumnReader::Column::validity() const {
+    return _vValid.data();
+}
+//-----------------------------------------------------------------
+const uint8_t* pjson::ColumnReader::Column::bools() const {
+    return (typeBool == _eType) ? reinterpret_cast<const uint8_t*>(_vValues.data()) : nullptr;
+}
+//-----------------------------------------------------------------
+const int32_t* pjson::ColumnReader::Column::int32s() const {
+    return (typeInt32 == _eType) ? reinterpret_cast<const int32_t*>(_vValues.data()) : nullptr;
+}
+//-----------------------------------------------------------------
+const int64_t* pjson::ColumnReader::Column::int64s() const {
+    return (typeInt64 == _eType) ? reinterpret_cast<const int64_t*>(_vValues.data()) : nullptr;
+}
+//-----------------------------------------------------------------
+const float* pjson::ColumnReader::Column::floats() const {
+    return (typeFloat == _eType) ? reinterpret_cast<const float*>(_vValues.data()) : nullptr;
+}
+//-----------------------------------------------------------------
+const double* pjson::ColumnReader::Column::doubles() const {
+    return (typeDouble == _eType) ? reinterpret_cast<const double*>(_vValues.data()) : nullptr;
+}
+//-----------------------------------------------------------------
+const uint64_t* pjson::ColumnReader::Column::offsets() const {
+    return (typeString == _eType) ? _vOffsets.data() : nullptr;
+}
+//-----------------------------------------------------------------
+const char* pjson::ColumnReader::Column::chars() const {
+    return (typeString == _eType) ? _sChars.data() : nullptr;
+}
+//-----------------------------------------------------------------
+std::string pjson::ColumnReader::Column::getString(size_t a_iRow) const {
+    if(typeString != _eType || a_iRow >= _iRows) {
+        return std::string();
+    }
+    return _sChars.substr(_vOffsets[a_iRow], _vOffsets[a_iRow + 1] - _vOffsets[a_iRow]);
+}
+//-----------------------------------------------------------------
@@ -0,0 +1,181 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#include "pjson_context.h"
+#include "pjson_stats.h"
+using namespace ByteDance;
+
+// Storage grown past these sizes is freed rather than pooled
+static const size_t kMaxPooledStringCapacity = 4 * 1024;
+static const size_t kMaxPooledArrayCapacity = 1024;
+
+//-----------------------------------------------------------------
+template<typename T>
+static void _FreeAll(std::vector<T*>& a_rPool) {
+    for(T* pItem : a_rPool) {
+        delete pItem;
+    }
+    a_rPool.clear();
+    a_rPool.shrink_to_fit();
+}
+//-----------------------------------------------------------------
+template<typename T>
+static T* _Pop(std::vector<T*>& a_rPool) {
+    if(a_rPool.empty()) {
+        PJSON_STATS_ALLOC(sizeof(T));
+        return new T();
+    }
+    T* pItem = a_rPool.back();
+    a_rPool.pop_back();
+    return pItem;
+}
+//-----------------------------------------------------------------
+pjson::ParseContext::ParseContext(size_t a_iMaxPooled /*= 64 * 1024*/)
+        : _iMaxPooled(a_iMaxPooled)
+        , _iMaxDepth(pjson::GetMaxParseDepth())
+        , _bLazyNumbers(false)
+{
+
+}
+//-----------------------------------------------------------------
+pjson::ParseContext::~ParseContext() {
+    trim();
+}
+//-----------------------------------------------------------------
+void pjson::ParseContext::trim() {
+    _FreeAll(_vNodes);
+    _FreeAll(_vStrings);
+    _FreeAll(_vInts);
+    _FreeAll(_vFloats);
+    _FreeAll(_vBools);
+    _FreeAll(_vArrays);
+    _FreeAll(_vMaps);
+    _vPending.shrink_to_fit();
+    _vFrames.shrink_to_fit();
+}
+//-----------------------------------------------------------------
+void pjson::ParseContext::setMaxDepth(size_t a_iDepth) {
+    _iMaxDepth = a_iDepth;
+}
+//-----------------------------------------------------------------
+size_t pjson::ParseContext::maxDepth() const {
+    return _iMaxDepth;
+}
+//-----------------------------------------------------------------
+void pjson::ParseContext::setLazyNumbers(bool bEnable) {
+    _bLazyNumbers = bEnable;
+}
+//-----------------------------------------------------------------
+bool pjson::ParseContext::lazyNumbers() const {
+    return _bLazyNumbers;
+}
+//-----------------------------------------------------------------
+size_t pjson::ParseContext::pooledNodes() const {
+    return _vNodes.size();
+}
+//-----------------------------------------------------------------
+pjson* pjson::ParseContext::_acquire(jsonType aeType) {
+    pjson* pNode = _Pop(_vNodes);
+    switch(aeType) {
+        case jsonType::jsonNull:         { break; }
+        case jsonType::jsonString:       { pNode->_pValueString = _Pop(_vStrings); break; }
+        case jsonType::jsonNumberInt:    { pNode->_pValueInt = _Pop(_vInts); break; }
+        case jsonType::jsonNumberFloat:  { pNode->_pValueFloat = _Pop(_vFloats); break; }
+        case jsonType::jsonBoolean:      { pNode->_pValueBool = _Pop(_vBools); break; }
+        case jsonType::jsonArray:        { pNode->_pValueArray = _Pop(_vArrays); break; }
+        case jsonType::jsonMap:          { pNode->_pValueMap = _Pop(_vMaps); break; }
+    } //end switch
+    pNode->_eType = aeType;
+    return pNode;
+}
+//-----------------------------------------------------------------
+pjson* pjson::ParseContext::_acquireRawNumber(jsonType aeType) {
+    pjson* pNode = _Pop(_vNodes);
+    pNode->_pValueString = _Pop(_vStrings);
+    pNode->_eType = aeType;
+    pNode->_iFlags = FlagRawNumber;
+    return pNode;
+}
+//-----------------------------------------------------------------
+void pjson::ParseContext::recycle(pjson* aRoot) {
+    if(nullptr == aRoot) {
+        return;
+    }
+    // Iterative, so deep trees cannot overflow the stack
+    _vPending.push_back(aRoot);
+    while(!_vPending.empty()) {
+        pjson* pNode = _vPending.back();
+        _vPending.pop_back();
+        _release(pNode);
+    }
+}
+//-----------------------------------------------------------------
+void pjson::ParseContext::_release(pjson* aNode) {
+    if(aNode->isCopyOnWrite()) {
+        // The value may be shared with other trees
+        aNode->reset();
+    }
+
+    jsonType eType = aNode->_eType;
+    if(aNode->_iFlags & FlagRawNumber) {
+        eType = jsonType::jsonString; // the text goes back to the string pool
+    }
+    switch(eType) {
+        case jsonType::jsonNull:         { break; }
+        case jsonType::jsonString:       {
+            if(aNode->_pValueString->capacity() > kMaxPooledStringCapacity) {
+                delete aNode->_pValueString;
+            } else {
+                aNode->_pValueString->clear(); // keeps capacity
+                _push(_vStrings, aNode->_pValueString);
+            }
+            break;
+        }
+        case jsonType::jsonNumberInt:    { _push(_vInts, aNode->_pValueInt); break; }
+        case jsonType::jsonNumberFloat:  { _push(_vFloats, aNode->_pValueFloat); break; }
+        case jsonType::jsonBoolean:      { _push(_vBools, aNode->_pValueBool); break; }
+        case jsonType::jsonArray:        {
+            PJSONARRAY* pArray = aNode->_pValueArray;
+            _vPending.insert(_vPending.end(), pArray->begin(), pArray->end());
+            if(pArray->capacity() > kMaxPooledArrayCapacity) {
+                delete pArray;
+            } else {
+                pArray->clear(); // keeps capacity
+                _push(_vArrays, pArray);
+            }
+            break;
+        }
+        case jsonType::jsonMap:          {
+            PJSONMAP* pMap = aNode->_pValueMap;
+            for(auto const& it : *pMap) {
+                _vPending.push_back(it.second);
+            }
+            pMap->clear();
+            _push(_vMaps, pMap);
+            break;
+        }
+    } //end switch
+    aNode->_eType = jsonType::jsonNull;
+    aNode->_pValueRaw = nullptr;
+    aNode->_iFlags = 0;
+    aNode->_iCacheFlags.store(0, std::memory_order_relaxed);
+    aNode->_iCacheSlot.store(0, std::memory_order_relaxed);
+    aNode->_iCacheStamp.store(0, std::memory_order_relaxed);
+    _push(_vNodes, aNode);
+}
+//-----------------------------------------------------------------
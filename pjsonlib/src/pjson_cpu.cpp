@@ -0,0 +1,928 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#include "pjson_cpu.h"
+#include "pjson_simd.h"
+#include <cstdint>
+#include <cstdlib>
+#include <cstring>
+
+#if !defined(PJSON_NO_SIMD) && !defined(PJSON_SIMD_X86) && !defined(PJSON_SIMD_NEON)
+#if defined(__x86_64__) || defined(__i386__) || defined(_M_X64)
+#define PJSON_SIMD_X86
+#elif (defined(__aarch64__) || defined(_M_ARM64)) && defined(PJSON_ENABLE_NEON)
+// NEON is opt-in: AArch64 uses the scalar kernels unless PJSON_ENABLE_NEON is set
+#define PJSON_SIMD_NEON
+#endif
+#endif
+
+#if defined(PJSON_SIMD_X86)
+#include <immintrin.h>
+#if defined(_MSC_VER) && !defined(__clang__)
+#include <intrin.h>
+#endif
+#elif defined(PJSON_SIMD_NEON)
+#include <arm_neon.h>
+#endif
+
+// GCC / Clang compile each x86 kernel for its own instruction set, so the
+// library itself needs no -m flags; MSVC accepts the intrinsics as they are
+#if defined(__GNUC__) || defined(__clang__)
+#define PJSON_TARGET(ISA) __attribute__((target(ISA)))
+#else
+#define PJSON_TARGET(ISA)
+#endif
+using namespace ByteDance;
+
+static const uint64_t _Ones = 0x0101010101010101ULL;
+static const uint64_t _Highs = 0x8080808080808080ULL;
+
+//-----------------------------------------------------------------
+static inline size_t _CountTrailingZeros(uint64_t aMask) {
+#if defined(_MSC_VER) && !defined(__clang__)
+    unsigned long iIndex;
+    _BitScanForward64(&iIndex, aMask);
+    return iIndex;
+#else
+    return __builtin_ctzll(aMask);
+#endif
+}
+//-----------------------------------------------------------------
+// Non-zero if any byte of aWord is zero
+static inline uint64_t _HasZeroByte(uint64_t aWord) {
+    return (aWord - _Ones) & ~aWord & _Highs;
+}
+//-----------------------------------------------------------------
+// Non-zero if any byte of aWord is below 0x20
+static inline uint64_t _HasControlByte(uint64_t aWord) {
+    return (aWord - _Ones * 0x20) & ~aWord & _Highs;
+}
+
+//==[Scalar]===============================================================
+// Portable reference kernels. The find kernels test eight bytes at a time
+// and then locate the hit byte by byte.
+//-----------------------------------------------------------------
+static inline bool _IsQuote(unsigned char aChar) {
+    return '\"' == aChar || '\\' == aChar;
+}
+//-----------------------------------------------------------------
+static inline bool _IsStringEnd(unsigned char aChar) {
+    return _IsQuote(aChar) || aChar < 0x20;
+}
+//-----------------------------------------------------------------
+static inline bool _IsStringSpecial(unsigned char aChar) {
+    return _IsStringEnd(aChar) || aChar >= 0x80;
+}
+//-----------------------------------------------------------------
+static inline bool _IsEscape(unsigned char aChar) {
+    return _IsStringSpecial(aChar) || '/' == aChar;
+}
+//-----------------------------------------------------------------
+static inline bool _IsSpace(unsigned char aChar) {
+    return ' ' == aChar || '\t' == aChar || '\r' == aChar || '\n' == aChar;
+}
+//-----------------------------------------------------------------
+static inline uint64_t _WordQuote(uint64_t aWord) {
+    return _HasZeroByte(aWord ^ (_Ones * '\"')) | _HasZeroByte(aWord ^ (_Ones * '\\'));
+}
+//-----------------------------------------------------------------
+static inline uint64_t _WordStringEnd(uint64_t aWord) {
+    return _WordQuote(aWord) | _HasControlByte(aWord);
+}
+//-----------------------------------------------------------------
+static inline uint64_t _WordStringSpecial(uint64_t aWord) {
+    return _WordStringEnd(aWord) | (aWord & _Highs);
+}
+//-----------------------------------------------------------------
+static inline uint64_t _WordEscape(uint64_t aWord) {
+    return _WordStringSpecial(aWord) | _HasZeroByte(aWord ^ (_Ones * '/'));
+}
+//-----------------------------------------------------------------
+template<uint64_t (*fnWord)(uint64_t), bool (*fnByte)(unsigned char)>
+static size_t _FindScalar(const char* aSrc, size_t a_iLength) {
+    size_t i = 0;
+    for(; i + 8 <= a_iLength; i += 8) {
+        uint64_t iWord;
+        memcpy(&iWord, aSrc + i, 8);
+        if(fnWord(iWord)) {
+            break;
+        }
+    }
+    for(; i < a_iLength; ++i) {
+        if(fnByte(static_cast<unsigned char>(aSrc[i]))) {
+            break;
+        }
+    }
+    return i;
+}
+//-----------------------------------------------------------------
+static size_t _FindQuoteScalar(const char* aSrc, size_t a_iLength) {
+    return _FindScalar<_WordQuote, _IsQuote>(aSrc, a_iLength);
+}
+//-----------------------------------------------------------------
+static size_t _FindStringEndScalar(const char* aSrc, size_t a_iLength) {
+    return _FindScalar<_WordStringEnd, _IsStringEnd>(aSrc, a_iLength);
+}
+//-----------------------------------------------------------------
+static size_t _FindStringSpecialScalar(const char* aSrc, size_t a_iLength) {
+    return _FindScalar<_WordStringSpecial, _IsStringSpecial>(aSrc, a_iLength);
+}
+//-----------------------------------------------------------------
+static size_t _FindEscapeScalar(const char* aSrc, size_t a_iLength) {
+    return _FindScalar<_WordEscape, _IsEscape>(aSrc, a_iLength);
+}
+//-----------------------------------------------------------------
+static size_t _SkipSpaceScalar(const char* aSrc, size_t a_iLength) {
+    size_t i = 0;
+    while(i < a_iLength && _IsSpace(static_cast<unsigned char>(aSrc[i]))) {
+        ++i;
+    }
+    return i;
+}
+//-----------------------------------------------------------------
+// Length of the multi-byte sequence at a_iPos, 0 if it is not valid UTF-8
+// (RFC 3629: no overlongs, no surrogates, nothing above U+10FFFF)
+static size_t _Utf8Sequence(const unsigned char* aSrc, size_t a_iPos, size_t a_iLength) {
+    unsigned char cLead = aSrc[a_iPos];
+    size_t iFollow = 0;
+    unsigned char cMin = 0x80;
+    unsigned char cMax = 0xBF;
+    if(cLead >= 0xC2 && cLead <= 0xDF) {
+        iFollow = 1;
+    } else if(cLead >= 0xE0 && cLead <= 0xEF) {
+        iFollow = 2;
+        if(0xE0 == cLead) {
+            cMin = 0xA0;
+        } else if(0xED == cLead) {
+            cMax = 0x9F;
+        }
+    } else if(cLead >= 0xF0 && cLead <= 0xF4) {
+        iFollow = 3;
+        if(0xF0 == cLead) {
+            cMin = 0x90;
+        } else if(0xF4 == cLead) {
+            cMax = 0x8F;
+        }
+    } else {
+        return 0;
+    }
+    if(a_iPos + iFollow >= a_iLength) {
+        return 0;
+    }
+    for(size_t i = 1; i <= iFollow; ++i) {
+        unsigned char cNext = aSrc[a_iPos + i];
+        if(cNext < cMin || cNext > cMax) {
+            return 0;
+        }
+        cMin = 0x80;
+        cMax = 0xBF;
+    }
+    return iFollow + 1;
+}
+//-----------------------------------------------------------------
+static bool _ValidUtf8Scalar(const char* aSrc, size_t a_iLength) {
+    const unsigned char* pSrc = reinterpret_cast<const unsigned char*>(aSrc);
+    size_t i = 0;
+    while(i < a_iLength) {
+        if(i + 8 <= a_iLength) {
+            uint64_t iWord;
+            memcpy(&iWord, pSrc + i, 8);
+            if(0 == (iWord & _Highs)) {
+                i += 8;
+                continue;
+            }
+        }
+        if(pSrc[i] < 0x80) {
+            ++i;
+            continue;
+        }
+        size_t iSequence = _Utf8Sequence(pSrc, i, a_iLength);
+        if(0 == iSequence) {
+            return false;
+        }
+        i += iSequence;
+    }
+    return true;
+}
+//-----------------------------------------------------------------
+static const char _Base64Chars[] = "ABCDEFGHIJKLMNOPQRSTUVWXYZabcdefghijklmnopqrstuvwxyz0123456789+/";
+
+// Sextet of every alphabet character, 0xFF for anything else
+struct _Base64Table {
+    unsigned char aValues[256];
+    _Base64Table() {
+        memset(aValues, 0xFF, sizeof(aValues));
+        for(unsigned char i = 0; i < 64; ++i) {
+            aValues[static_cast<unsigned char>(_Base64Chars[i])] = i;
+        }
+    }
+};
+static const _Base64Table& _Base64Values() {
+    static const _Base64Table oTable;
+    return oTable;
+}
+//-----------------------------------------------------------------
+static size_t _Base64EncodeScalar(const unsigned char* aSrc, size_t a_iLength, char* aDest) {
+    size_t i = 0;
+    for(; i + 3 <= a_iLength; i += 3) {
+        uint32_t iTriplet = (uint32_t(aSrc[i]) << 16) | (uint32_t(aSrc[i + 1]) << 8) | aSrc[i + 2];
+        *aDest++ = _Base64Chars[(iTriplet >> 18) & 0x3F];
+        *aDest++ = _Base64Chars[(iTriplet >> 12) & 0x3F];
+        *aDest++ = _Base64Chars[(iTriplet >> 6) & 0x3F];
+        *aDest++ = _Base64Chars[iTriplet & 0x3F];
+    }
+    return i;
+}
+//-----------------------------------------------------------------
+static size_t _Base64DecodeScalar(const char* aSrc, size_t a_iLength, unsigned char* aDest) {
+    const unsigned char* aValues = _Base64Values().aValues;
+    size_t i = 0;
+    for(; i + 4 <= a_iLength; i += 4) {
+        uint32_t a = aValues[static_cast<unsigned char>(aSrc[i])];
+        uint32_t b = aValues[static_cast<unsigned char>(aSrc[i + 1])];
+        uint32_t c = aValues[static_cast<unsigned char>(aSrc[i + 2])];
+        uint32_t d = aValues[static_cast<unsigned char>(aSrc[i + 3])];
+        if((a | b | c | d) & 0x80) {
+            break;
+        }
+        uint32_t iTriplet = (a << 18) | (b << 12) | (c << 6) | d;
+        *aDest++ = static_cast<unsigned char>(iTriplet >> 16);
+        *aDest++ = static_cast<unsigned char>(iTriplet >> 8);
+        *aDest++ = static_cast<unsigned char>(iTriplet);
+    }
+    return i;
+}
+
+// Vector find kernel: MASK turns one loaded block into a bit mask of the
+// bytes of interest (SHIFT bits per byte); the tail goes to the scalar kernel
+#define PJSON_FIND_KERNEL(NAME, ISA, WIDTH, LOAD, MASK, SHIFT)                          \
+    PJSON_TARGET_##ISA static size_t _##NAME##ISA(const char* aSrc, size_t a_iLength) { \
+        size_t i = 0;                                                                   \
+        for(; i + WIDTH <= a_iLength; i += WIDTH) {                                     \
+            uint64_t iMask = MASK(LOAD(aSrc + i));                                      \
+            if(0 != iMask) {                                                            \
+                PJSON_LEAVE_##ISA();                                                    \
+                return i + (_CountTrailingZeros(iMask) >> SHIFT);                       \
+            }                                                                           \
+        }                                                                               \
+        PJSON_LEAVE_##ISA();                                                            \
+        return i + _##NAME##Scalar(aSrc + i, a_iLength - i);                            \
+    }
+
+#if defined(PJSON_SIMD_X86) || defined(PJSON_SIMD_NEON)
+// UTF-8 validation by table lookup (Keiser and Lemire, "Validating UTF-8 in
+// less than one instruction per byte"). Each byte is classified by the high
+// nibble of its predecessor, the low nibble of its predecessor and its own
+// high nibble; a bit set in all three lookups is an error.
+enum : unsigned char {
+    Utf8TooShort = 1 << 0,    // lead byte or ASCII followed by a lead byte or ASCII
+    Utf8TooLong = 1 << 1,     // ASCII followed by a continuation
+    Utf8Overlong3 = 1 << 2,   // 11100000 100_____
+    Utf8TooLarge = 1 << 3,    // above U+10FFFF
+    Utf8Surrogate = 1 << 4,   // 11101101 101_____
+    Utf8Overlong2 = 1 << 5,   // 1100000_ 10______
+    Utf8TooLarge1000 = 1 << 6,
+    Utf8Overlong4 = 1 << 6,   // 11110000 1000____
+    Utf8TwoConts = 1 << 7,    // continuation after a continuation, checked against the lead
+    Utf8Carry = Utf8TooShort | Utf8TooLong | Utf8TwoConts
+};
+static const unsigned char _Utf8Byte1High[16] = {
+    // 0_______ ASCII
+    Utf8TooLong, Utf8TooLong, Utf8TooLong, Utf8TooLong, Utf8TooLong, Utf8TooLong, Utf8TooLong, Utf8TooLong,
+    // 10______ continuation
+    Utf8TwoConts, Utf8TwoConts, Utf8TwoConts, Utf8TwoConts,
+    // 1100____, 1101____ two byte leads
+    Utf8TooShort | Utf8Overlong2,
+    Utf8TooShort,
+    // 1110____ three byte lead
+    Utf8TooShort | Utf8Overlong3 | Utf8Surrogate,
+    // 1111____ four byte lead
+    Utf8TooShort | Utf8TooLarge | Utf8TooLarge1000 | Utf8Overlong4
+};
+static const unsigned char _Utf8Byte1Low[16] = {
+    Utf8Carry | Utf8Overlong3 | Utf8Overlong2 | Utf8Overlong4, // ____0000
+    Utf8Carry | Utf8Overlong2,                                  // ____0001
+    Utf8Carry,
+    Utf8Carry,
+    Utf8Carry | Utf8TooLarge,                                   // ____0100
+    Utf8Carry | Utf8TooLarge | Utf8TooLarge1000,
+    Utf8Carry | Utf8TooLarge | Utf8TooLarge1000,
+    Utf8Carry | Utf8TooLarge | Utf8TooLarge1000,
+    Utf8Carry | Utf8TooLarge | Utf8TooLarge1000,
+    Utf8Carry | Utf8TooLarge | Utf8TooLarge1000,
+    Utf8Carry | Utf8TooLarge | Utf8TooLarge1000,
+    Utf8Carry | Utf8TooLarge | Utf8TooLarge1000,
+    Utf8Carry | Utf8TooLarge | Utf8TooLarge1000,
+    Utf8Carry | Utf8TooLarge | Utf8TooLarge1000 | Utf8Surrogate, // ____1101
+    Utf8Carry | Utf8TooLarge | Utf8TooLarge1000,
+    Utf8Carry | Utf8TooLarge | Utf8TooLarge1000
+};
+static const unsigned char _Utf8Byte2High[16] = {
+    // ________ 0_______ ASCII
+    Utf8TooShort, Utf8TooShort, Utf8TooShort, Utf8TooShort, Utf8TooShort, Utf8TooShort, Utf8TooShort, Utf8TooShort,
+    // ________ 1000____
+    Utf8TooLong | Utf8Overlong2 | Utf8TwoConts | Utf8Overlong3 | Utf8TooLarge1000 | Utf8Overlong4,
+    // ________ 1001____
+    Utf8TooLong | Utf8Overlong2 | Utf8TwoConts | Utf8Overlong3 | Utf8TooLarge,
+    // ________ 101_____
+    Utf8TooLong | Utf8Overlong2 | Utf8TwoConts | Utf8Surrogate | Utf8TooLarge,
+    Utf8TooLong | Utf8Overlong2 | Utf8TwoConts | Utf8Surrogate | Utf8TooLarge,
+    // ________ 11______ lead
+    Utf8TooShort, Utf8TooShort, Utf8TooShort, Utf8TooShort
+};
+// A block ending in these bytes still needs continuations from the next one
+static const unsigned char _Utf8IncompleteMax[32] = {
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF,
+    0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xEF, 0xDF, 0xBF
+};
+#endif
+
+#if defined(PJSON_SIMD_X86)
+#define PJSON_TARGET_SSE2 PJSON_TARGET("sse2")
+#define PJSON_TARGET_AVX2 PJSON_TARGET("avx2")
+#define PJSON_TARGET_AVX512 PJSON_TARGET("avx2,avx512f,avx512bw")
+// The rest of the library is SSE code: a kernel that used the upper halves of
+// the ymm / zmm registers must clear them on every way out, including before
+// the scalar tail, or every later SSE instruction pays for the transition.
+// The compiler does not always insert this for target() functions.
+#define PJSON_LEAVE_SSE2()
+#define PJSON_LEAVE_AVX2() _mm256_zeroupper()
+#define PJSON_LEAVE_AVX512() _mm256_zeroupper()
+//==[SSE2]=================================================================
+//-----------------------------------------------------------------
+PJSON_TARGET_SSE2 static inline __m128i _LoadSSE2(const char* aSrc) {
+    return _mm_loadu_si128(reinterpret_cast<const __m128i*>(aSrc));
+}
+//-----------------------------------------------------------------
+PJSON_TARGET_SSE2 static inline uint32_t _BitsSSE2(__m128i aMatch) {
+    return static_cast<uint32_t>(_mm_movemask_epi8(aMatch));
+}
+//-----------------------------------------------------------------
+PJSON_TARGET_SSE2 static inline uint32_t _MaskQuoteSSE2(__m128i aBlock) {
+    return _BitsSSE2(_mm_or_si128(_mm_cmpeq_epi8(aBlock, _mm_set1_epi8('\"')),
+                                  _mm_cmpeq_epi8(aBlock, _mm_set1_epi8('\\'))));
+}
+//-----------------------------------------------------------------
+PJSON_TARGET_SSE2 static inline uint32_t _MaskStringEndSSE2(__m128i aBlock) {
+    // no unsigned compare in SSE2: byte <= 0x1F exactly when min(byte, 0x1F) == byte
+    __m128i vControl = _mm_cmpeq_epi8(_mm_min_epu8(aBlock, _mm_set1_epi8(0x1F)), aBlock);
+    return _MaskQuoteSSE2(aBlock) | _BitsSSE2(vControl);
+}
+//-----------------------------------------------------------------
+PJSON_TARGET_SSE2 static inline uint32_t _MaskStringSpecialSSE2(__m128i aBlock) {
+    return _MaskStringEndSSE2(aBlock) | _BitsSSE2(aBlock);
+}
+//-----------------------------------------------------------------
+PJSON_TARGET_SSE2 static inline uint32_t _MaskEscapeSSE2(__m128i aBlock) {
+    return _MaskStringSpecialSSE2(aBlock) | _BitsSSE2(_mm_cmpeq_epi8(aBlock, _mm_set1_epi8('/')));
+}
+//-----------------------------------------------------------------
+PJSON_TARGET_SSE2 static inline uint32_t _MaskSpaceSSE2(__m128i aBlock) {
+    __m128i vSpace = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(aBlock, _mm_set1_epi8(' ')),
+                                               _mm_cmpeq_epi8(aBlock, _mm_set1_epi8('\t'))),
+                                  _mm_or_si128(_mm_cmpeq_epi8(aBlock, _mm_set1_epi8('\r')),
+                                               _mm_cmpeq_epi8(aBlock, _mm_set1_epi8('\n'))));
+    return _BitsSSE2(vSpace) ^ 0xFFFF;
+}
+//-----------------------------------------------------------------
+PJSON_FIND_KERNEL(FindQuote, SSE2, 16, _LoadSSE2, _MaskQuoteSSE2, 0)
+PJSON_FIND_KERNEL(FindStringEnd, SSE2, 16, _LoadSSE2, _MaskStringEndSSE2, 0)
+PJSON_FIND_KERNEL(FindStringSpecial, SSE2, 16, _LoadSSE2, _MaskStringSpecialSSE2, 0)
+PJSON_FIND_KERNEL(FindEscape, SSE2, 16, _LoadSSE2, _MaskEscapeSSE2, 0)
+PJSON_FIND_KERNEL(SkipSpace, SSE2, 16, _LoadSSE2, _MaskSpaceSSE2, 0)
+//-----------------------------------------------------------------
+// SSE2 has no byte shuffle for the lookup validator: skips ASCII sixteen
+// bytes at a time and checks the other sequences one by one
+PJSON_TARGET_SSE2 static bool _ValidUtf8SSE2(const char* aSrc, size_t a_iLength) {
+    const unsigned char* pSrc = reinterpret_cast<const unsigned char*>(aSrc);
+    size_t i = 0;
+    while(i + 16 <= a_iLength) {
+        uint32_t iHigh = _BitsSSE2(_LoadSSE2(aSrc + i));
+        if(0 == iHigh) {
+            i += 16;
+            continue;
+        }
+        i += _CountTrailingZeros(iHigh);
+        size_t iSequence = _Utf8Sequence(pSrc, i, a_iLength);
+        if(0 == iSequence) {
+            return false;
+        }
+        i += iSequence;
+    }
+    return _ValidUtf8Scalar(aSrc + i, a_iLength - i);
+}
+
+//==[AVX2]=================================================================
+//-----------------------------------------------------------------
+PJSON_TARGET_AVX2 static inline __m256i _LoadAVX2(const char* aSrc) {
+    return _mm256_loadu_si256(reinterpret_cast<const __m256i*>(aSrc));
+}
+//-----------------------------------------------------------------
+PJSON_TARGET_AVX2 static inline uint32_t _BitsAVX2(__m256i aMatch) {
+    return static_cast<uint32_t>(_mm256_movemask_epi8(aMatch));
+}
+//-----------------------------------------------------------------
+PJSON_TARGET_AVX2 static inline uint32_t _MaskQuoteAVX2(__m256i aBlock) {
+    return _BitsAVX2(_mm256_or_si256(_mm256_cmpeq_epi8(aBlock, _mm256_set1_epi8('\"')),
+                                     _mm256_cmpeq_epi8(aBlock, _mm256_set1_epi8('\\'))));
+}
+//-----------------------------------------------------------------
+PJSON_TARGET_AVX2 static inline uint32_t _MaskStringEndAVX2(__m256i aBlock) {
+    __m256i vControl = _mm256_cmpeq_epi8(_mm256_min_epu8(aBlock, _mm256_set1_epi8(0x1F)), aBlock);
+    return _MaskQuoteAVX2(aBlock) | _BitsAVX2(vControl);
+}
+//-----------------------------------------------------------------
+PJSON_TARGET_AVX2 static inline uint32_t _MaskStringSpecialAVX2(__m256i aBlock) {
+    return _MaskStringEndAVX2(aBlock) | _BitsAVX2(aBlock);
+}
+//-----------------------------------------------------------------
+PJSON_TARGET_AVX2 static inline uint32_t _MaskEscapeAVX2(__m256i aBlock) {
+    return _MaskStringSpecialAVX2(aBlock) | _BitsAVX2(_mm256_cmpeq_epi8(aBlock, _mm256_set1_epi8('/')));
+}
+//-----------------------------------------------------------------
+PJSON_TARGET_AVX2 static inline uint32_t _MaskSpaceAVX2(__m256i aBlock) {
+    __m256i vSpace = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(aBlock, _mm256_set1_epi8(' ')),
+                                                     _mm256_cmpeq_epi8(aBlock, _mm256_set1_epi8('\t'))),
+                                     _mm256_or_si256(_mm256_cmpeq_epi8(aBlock, _mm256_set1_epi8('\r')),
+                                                     _mm256_cmpeq_epi8(aBlock, _mm256_set1_epi8('\n'))));
+    return ~_BitsAVX2(vSpace);
+}
+//-----------------------------------------------------------------
+PJSON_FIND_KERNEL(FindQuote, AVX2, 32, _LoadAVX2, _MaskQuoteAVX2, 0)
+PJSON_FIND_KERNEL(FindStringEnd, AVX2, 32, _LoadAVX2, _MaskStringEndAVX2, 0)
+PJSON_FIND_KERNEL(FindStringSpecial, AVX2, 32, _LoadAVX2, _MaskStringSpecialAVX2, 0)
+PJSON_FIND_KERNEL(FindEscape, AVX2, 32, _LoadAVX2, _MaskEscapeAVX2, 0)
+PJSON_FIND_KERNEL(SkipSpace, AVX2, 32, _LoadAVX2, _MaskSpaceAVX2, 0)
+
+// Running state of the lookup validator
+struct _Utf8StateAVX2 {
+    __m256i vPrevious;   // last block checked
+    __m256i vIncomplete; // non-zero when vPrevious ends inside a sequence
+    __m256i vError;
+};
+//-----------------------------------------------------------------
+PJSON_TARGET_AVX2 static inline __m256i _Table16AVX2(const unsigned char (&aTable)[16]) {
+    return _mm256_broadcastsi128_si256(_mm_loadu_si128(reinterpret_cast<const __m128i*>(aTable)));
+}
+//-----------------------------------------------------------------
+PJSON_TARGET_AVX2 static inline __m256i _HighNibblesAVX2(__m256i aBlock) {
+    return _mm256_and_si256(_mm256_srli_epi16(aBlock, 4), _mm256_set1_epi8(0x0F));
+}
+//-----------------------------------------------------------------
+// aBlock shifted back by N bytes, with the last N bytes of aPrevious in front
+template<int N>
+PJSON_TARGET_AVX2 static inline __m256i _PreviousAVX2(__m256i aBlock, __m256i aPrevious) {
+    return _mm256_alignr_epi8(aBlock, _mm256_permute2x128_si256(aPrevious, aBlock, 0x21), 16 - N);
+}
+//-----------------------------------------------------------------
+PJSON_TARGET_AVX2 static inline void _Utf8BlockAVX2(__m256i aBlock, _Utf8StateAVX2& a_rState) {
+    if(0 == _BitsAVX2(aBlock)) {
+        // ASCII only: fine unless the previous block left a sequence open
+        a_rState.vError = _mm256_or_si256(a_rState.vError, a_rState.vIncomplete);
+        a_rState.vPrevious = aBlock;
+        a_rState.vIncomplete = _mm256_setzero_si256();
+        return;
+    }
+    __m256i vPrev1 = _PreviousAVX2<1>(aBlock, a_rState.vPrevious);
+    __m256i vSpecial = _mm256_and_si256(
+        _mm256_and_si256(_mm256_shuffle_epi8(_Table16AVX2(_Utf8Byte1High), _HighNibblesAVX2(vPrev1)),
+                         _mm256_shuffle_epi8(_Table16AVX2(_Utf8Byte1Low), _mm256_and_si256(vPrev1, _mm256_set1_epi8(0x0F)))),
+        _mm256_shuffle_epi8(_Table16AVX2(_Utf8Byte2High), _HighNibblesAVX2(aBlock)));
+    // the third and fourth bytes of a sequence must be continuations
+    __m256i vThird = _mm256_subs_epu8(_PreviousAVX2<2>(aBlock, a_rState.vPrevious), _mm256_set1_epi8(0xE0 - 0x80));
+    __m256i vFourth = _mm256_subs_epu8(_PreviousAVX2<3>(aBlock, a_rState.vPrevious), _mm256_set1_epi8(0xF0 - 0x80));
+    __m256i vMust23 = _mm256_and_si256(_mm256_or_si256(vThird, vFourth), _mm256_set1_epi8(char(0x80)));
+    a_rState.vError = _mm256_or_si256(a_rState.vError, _mm256_xor_si256(vMust23, vSpecial));
+    a_rState.vPrevious = aBlock;
+    a_rState.vIncomplete = _mm256_subs_epu8(aBlock, _LoadAVX2(reinterpret_cast<const char*>(_Utf8IncompleteMax)));
+}
+//-----------------------------------------------------------------
+PJSON_TARGET_AVX2 static bool _ValidUtf8AVX2(const char* aSrc, size_t a_iLength) {
+    _Utf8StateAVX2 oState;
+    oState.vPrevious = oState.vIncomplete = oState.vError = _mm256_setzero_si256();
+    size_t i = 0;
+    for(; i + 32 <= a_iLength; i += 32) {
+        _Utf8BlockAVX2(_LoadAVX2(aSrc + i), oState);
+    }
+    // the zero padding also closes the last block: an open sequence fails against it
+    char aLast[32] = {0};
+    for(size_t k = 0; i + k < a_iLength; ++k) {
+        aLast[k] = aSrc[i + k];
+    }
+    _Utf8BlockAVX2(_LoadAVX2(aLast), oState);
+    bool bValid = _mm256_testz_si256(oState.vError, oState.vError);
+    PJSON_LEAVE_AVX2();
+    return bValid;
+}
+//-----------------------------------------------------------------
+// Base64 with byte shuffles (Mula and Lemire, "Faster Base64 Encoding and
+// Decoding using AVX2 Instructions"), twelve bytes per sixteen characters
+PJSON_TARGET_AVX2 static size_t _Base64EncodeAVX2(const unsigned char* aSrc, size_t a_iLength, char* aDest) {
+    const __m128i vSpread = _mm_set_epi8(10, 11, 9, 10, 7, 8, 6, 7, 4, 5, 3, 4, 1, 2, 0, 1);
+    const __m128i vOffsets = _mm_setr_epi8('a' - 26, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52,
+                                           '0' - 52, '0' - 52, '0' - 52, '0' - 52, '0' - 52, '+' - 62,
+                                           '/' - 63, 'A', 0, 0);
+    size_t i = 0;
+    for(; i + 16 <= a_iLength; i += 12) {
+        // every three input bytes become four sextets, one per output byte
+        __m128i vIn = _mm_shuffle_epi8(_mm_loadu_si128(reinterpret_cast<const __m128i*>(aSrc + i)), vSpread);
+        __m128i vHigh = _mm_mulhi_epu16(_mm_and_si128(vIn, _mm_set1_epi32(0x0FC0FC00)), _mm_set1_epi32(0x04000040));
+        __m128i vLow = _mm_mullo_epi16(_mm_and_si128(vIn, _mm_set1_epi32(0x003F03F0)), _mm_set1_epi32(0x01000010));
+        __m128i vSextets = _mm_or_si128(vHigh, vLow);
+        // map each sextet range to the offset of its alphabet run
+        __m128i vRange = _mm_subs_epu8(vSextets, _mm_set1_epi8(51));
+        __m128i vUpper = _mm_cmpgt_epi8(_mm_set1_epi8(26), vSextets);
+        vRange = _mm_or_si128(vRange, _mm_and_si128(vUpper, _mm_set1_epi8(13)));
+        __m128i vChars = _mm_add_epi8(_mm_shuffle_epi8(vOffsets, vRange), vSextets);
+        _mm_storeu_si128(reinterpret_cast<__m128i*>(aDest), vChars);
+        aDest += 16;
+    }
+    return i + _Base64EncodeScalar(aSrc + i, a_iLength - i, aDest);
+}
+//-----------------------------------------------------------------
+PJSON_TARGET_AVX2 static size_t _Base64DecodeAVX2(const char* aSrc, size_t a_iLength, unsigned char* aDest) {
+    const __m128i vLowClasses = _mm_setr_epi8(0x15, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x11,
+                                              0x11, 0x11, 0x13, 0x1A, 0x1B, 0x1B, 0x1B, 0x1A);
+    const __m128i vHighClasses = _mm_setr_epi8(0x10, 0x10, 0x01, 0x02, 0x04, 0x08, 0x04, 0x08,
+                                               0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x10);
+    const __m128i vRolls = _mm_setr_epi8(0, 16, 19, 4, -65, -65, -71, -71, 0, 0, 0, 0, 0, 0, 0, 0);
+    const __m128i vSlash = _mm_set1_epi8(0x2F);
+    size_t i = 0;
+    for(; i + 16 <= a_iLength; i += 16) {
+        __m128i vIn = _mm_loadu_si128(reinterpret_cast<const __m128i*>(aSrc + i));
+        __m128i vHighNibbles = _mm_and_si128(_mm_srli_epi32(vIn, 4), vSlash); // bit 7 clear is all pshufb needs
+        __m128i vLowNibbles = _mm_and_si128(vIn, vSlash);
+        // a character is in the alphabet when its two nibble classes share no bit
+        if(!_mm_testz_si128(_mm_shuffle_epi8(vLowClasses, vLowNibbles), _mm_shuffle_epi8(vHighClasses, vHighNibbles))) {
+            break;
+        }
+        __m128i vRoll = _mm_shuffle_epi8(vRolls, _mm_add_epi8(_mm_cmpeq_epi8(vIn, vSlash), vHighNibbles));
+        __m128i vSextets = _mm_add_epi8(vIn, vRoll);
+        // pack four sextets into three bytes per 32 bit lane, then drop the gaps
+        __m128i vPairs = _mm_maddubs_epi16(vSextets, _mm_set1_epi32(0x01400140));
+        __m128i vOut = _mm_madd_epi16(vPairs, _mm_set1_epi32(0x00011000));
+        vOut = _mm_shuffle_epi8(vOut, _mm_setr_epi8(2, 1, 0, 6, 5, 4, 10, 9, 8, 14, 13, 12, -1, -1, -1, -1));
+        _mm_storel_epi64(reinterpret_cast<__m128i*>(aDest), vOut);
+        uint32_t iLast = static_cast<uint32_t>(_mm_cvtsi128_si32(_mm_srli_si128(vOut, 8)));
+        memcpy(aDest + 8, &iLast, 4);
+        aDest += 12;
+    }
+    return i + _Base64DecodeScalar(aSrc + i, a_iLength - i, aDest);
+}
+
+//==[AVX-512]==============================================================
+//-----------------------------------------------------------------
+PJSON_TARGET_AVX512 static inline __m512i _LoadAVX512(const char* aSrc) {
+    return _mm512_loadu_si512(reinterpret_cast<const void*>(aSrc));
+}
+//-----------------------------------------------------------------
+PJSON_TARGET_AVX512 static inline uint64_t _MaskQuoteAVX512(__m512i aBlock) {
+    return _mm512_cmpeq_epi8_mask(aBlock, _mm512_set1_epi8('\"')) | _mm512_cmpeq_epi8_mask(aBlock, _mm512_set1_epi8('\\'));
+}
+//-----------------------------------------------------------------
+PJSON_TARGET_AVX512 static inline uint64_t _MaskStringEndAVX512(__m512i aBlock) {
+    return _MaskQuoteAVX512(aBlock) | _mm512_cmplt_epu8_mask(aBlock, _mm512_set1_epi8(0x20));
+}
+//-----------------------------------------------------------------
+PJSON_TARGET_AVX512 static inline uint64_t _MaskStringSpecialAVX512(__m512i aBlock) {
+    return _MaskStringEndAVX512(aBlock) | _mm512_movepi8_mask(aBlock);
+}
+//-----------------------------------------------------------------
+PJSON_TARGET_AVX512 static inline uint64_t _MaskEscapeAVX512(__m512i aBlock) {
+    return _MaskStringSpecialAVX512(aBlock) | _mm512_cmpeq_epi8_mask(aBlock, _mm512_set1_epi8('/'));
+}
+//-----------------------------------------------------------------
+PJSON_TARGET_AVX512 static inline uint64_t _MaskSpaceAVX512(__m512i aBlock) {
+    return ~(_mm512_cmpeq_epi8_mask(aBlock, _mm512_set1_epi8(' ')) | _mm512_cmpeq_epi8_mask(aBlock, _mm512_set1_epi8('\t'))
+             | _mm512_cmpeq_epi8_mask(aBlock, _mm512_set1_epi8('\r')) | _mm512_cmpeq_epi8_mask(aBlock, _mm512_set1_epi8('\n')));
+}
+//-----------------------------------------------------------------
+PJSON_FIND_KERNEL(FindQuote, AVX512, 64, _LoadAVX512, _MaskQuoteAVX512, 0)
+PJSON_FIND_KERNEL(FindStringEnd, AVX512, 64, _LoadAVX512, _MaskStringEndAVX512, 0)
+PJSON_FIND_KERNEL(FindStringSpecial, AVX512, 64, _LoadAVX512, _MaskStringSpecialAVX512, 0)
+PJSON_FIND_KERNEL(FindEscape, AVX512, 64, _LoadAVX512, _MaskEscapeAVX512, 0)
+PJSON_FIND_KERNEL(SkipSpace, AVX512, 64, _LoadAVX512, _MaskSpaceAVX512, 0)
+#endif // PJSON_SIMD_X86
+
+#if defined(PJSON_SIMD_NEON)
+#define PJSON_TARGET_NEON
+#define PJSON_LEAVE_NEON()
+//==[NEON]=================================================================
+//-----------------------------------------------------------------
+static inline uint8x16_t _LoadNEON(const char* aSrc) {
+    return vld1q_u8(reinterpret_cast<const uint8_t*>(aSrc));
+}
+//-----------------------------------------------------------------
+// Four bits per matching byte (NEON has no movemask)
+static inline uint64_t _BitsNEON(uint8x16_t aMatch) {
+    return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(aMatch), 4)), 0);
+}
+//-----------------------------------------------------------------
+static inline uint8x16_t _MatchQuoteNEON(uint8x16_t aBlock) {
+    return vorrq_u8(vceqq_u8(aBlock, vdupq_n_u8('\"')), vceqq_u8(aBlock, vdupq_n_u8('\\')));
+}
+//-----------------------------------------------------------------
+static inline uint8x16_t _MatchStringEndNEON(uint8x16_t aBlock) {
+    return vorrq_u8(_MatchQuoteNEON(aBlock), vcltq_u8(aBlock, vdupq_n_u8(0x20)));
+}
+//-----------------------------------------------------------------
+static inline uint8x16_t _MatchStringSpecialNEON(uint8x16_t aBlock) {
+    return vorrq_u8(_MatchStringEndNEON(aBlock), vcgeq_u8(aBlock, vdupq_n_u8(0x80)));
+}
+//-----------------------------------------------------------------
+static inline uint64_t _MaskQuoteNEON(uint8x16_t aBlock) {
+    return _BitsNEON(_MatchQuoteNEON(aBlock));
+}
+//-----------------------------------------------------------------
+static inline uint64_t _MaskStringEndNEON(uint8x16_t aBlock) {
+    return _BitsNEON(_MatchStringEndNEON(aBlock));
+}
+//-----------------------------------------------------------------
+static inline uint64_t _MaskStringSpecialNEON(uint8x16_t aBlock) {
+    return _BitsNEON(_MatchStringSpecialNEON(aBlock));
+}
+//-----------------------------------------------------------------
+static inline uint64_t _MaskEscapeNEON(uint8x16_t aBlock) {
+    return _BitsNEON(vorrq_u8(_MatchStringSpecialNEON(aBlock), vceqq_u8(aBlock, vdupq_n_u8('/'))));
+}
+//-----------------------------------------------------------------
+static inline uint64_t _MaskSpaceNEON(uint8x16_t aBlock) {
+    uint8x16_t vSpace = vorrq_u8(vorrq_u8(vceqq_u8(aBlock, vdupq_n_u8(' ')), vceqq_u8(aBlock, vdupq_n_u8('\t'))),
+                                 vorrq_u8(vceqq_u8(aBlock, vdupq_n_u8('\r')), vceqq_u8(aBlock, vdupq_n_u8('\n'))));
+    return _BitsNEON(vmvnq_u8(vSpace));
+}
+//-----------------------------------------------------------------
+PJSON_FIND_KERNEL(FindQuote, NEON, 16, _LoadNEON, _MaskQuoteNEON, 2)
+PJSON_FIND_KERNEL(FindStringEnd, NEON, 16, _LoadNEON, _MaskStringEndNEON, 2)
+PJSON_FIND_KERNEL(FindStringSpecial, NEON, 16, _LoadNEON, _MaskStringSpecialNEON, 2)
+PJSON_FIND_KERNEL(FindEscape, NEON, 16, _LoadNEON, _MaskEscapeNEON, 2)
+PJSON_FIND_KERNEL(SkipSpace, NEON, 16, _LoadNEON, _MaskSpaceNEON, 2)
+//-----------------------------------------------------------------
+// Same lookup validator as _Utf8BlockAVX2, sixteen bytes at a time
+struct _Utf8StateNEON {
+    uint8x16_t vPrevious;
+    uint8x16_t vIncomplete;
+    uint8x16_t vError;
+};
+//-----------------------------------------------------------------
+static inline void _Utf8BlockNEON(uint8x16_t aBlock, _Utf8StateNEON& a_rState) {
+    if(vmaxvq_u8(aBlock) < 0x80) {
+        a_rState.vError = vorrq_u8(a_rState.vError, a_rState.vIncomplete);
+        a_rState.vPrevious = aBlock;
+        a_rState.vIncomplete = vdupq_n_u8(0);
+        return;
+    }
+    uint8x16_t vPrev1 = vextq_u8(a_rState.vPrevious, aBlock, 15);
+    uint8x16_t vSpecial = vandq_u8(
+        vandq_u8(vqtbl1q_u8(vld1q_u8(_Utf8Byte1High), vshrq_n_u8(vPrev1, 4)),
+                 vqtbl1q_u8(vld1q_u8(_Utf8Byte1Low), vandq_u8(vPrev1, vdupq_n_u8(0x0F)))),
+        vqtbl1q_u8(vld1q_u8(_Utf8Byte2High), vshrq_n_u8(aBlock, 4)));
+    uint8x16_t vThird = vqsubq_u8(vextq_u8(a_rState.vPrevious, aBlock, 14), vdupq_n_u8(0xE0 - 0x80));
+    uint8x16_t vFourth = vqsubq_u8(vextq_u8(a_rState.vPrevious, aBlock, 13), vdupq_n_u8(0xF0 - 0x80));
+    uint8x16_t vMust23 = vandq_u8(vorrq_u8(vThird, vFourth), vdupq_n_u8(0x80));
+    a_rState.vError = vorrq_u8(a_rState.vError, veorq_u8(vMust23, vSpecial));
+    a_rState.vPrevious = aBlock;
+    a_rState.vIncomplete = vqsubq_u8(aBlock, vld1q_u8(_Utf8IncompleteMax + 16));
+}
+//-----------------------------------------------------------------
+static bool _ValidUtf8NEON(const char* aSrc, size_t a_iLength) {
+    _Utf8StateNEON oState;
+    oState.vPrevious = oState.vIncomplete = oState.vError = vdupq_n_u8(0);
+    size_t i = 0;
+    for(; i + 16 <= a_iLength; i += 16) {
+        _Utf8BlockNEON(_LoadNEON(aSrc + i), oState);
+    }
+    char aLast[16] = {0};
+    if(i < a_iLength) {
+        memcpy(aLast, aSrc + i, a_iLength - i);
+    }
+    _Utf8BlockNEON(_LoadNEON(aLast), oState);
+    return 0 == vmaxvq_u8(oState.vError);
+}
+//-----------------------------------------------------------------
+static inline uint8x16x4_t _Load64NEON(const unsigned char* aTable) {
+    uint8x16x4_t vTable;
+    vTable.val[0] = vld1q_u8(aTable);
+    vTable.val[1] = vld1q_u8(aTable + 16);
+    vTable.val[2] = vld1q_u8(aTable + 32);
+    vTable.val[3] = vld1q_u8(aTable + 48);
+    return vTable;
+}
+//-----------------------------------------------------------------
+// Base64 with de-interleaving loads: 48 bytes per 64 characters
+static size_t _Base64EncodeNEON(const unsigned char* aSrc, size_t a_iLength, char* aDest) {
+    const uint8x16x4_t vAlphabet = _Load64NEON(reinterpret_cast<const unsigned char*>(_Base64Chars));
+    const uint8x16_t vMask6 = vdupq_n_u8(0x3F);
+    size_t i = 0;
+    for(; i + 48 <= a_iLength; i += 48) {
+        uint8x16x3_t vIn = vld3q_u8(aSrc + i);
+        uint8x16x4_t vOut;
+        vOut.val[0] = vshrq_n_u8(vIn.val[0], 2);
+        vOut.val[1] = vandq_u8(vorrq_u8(vshlq_n_u8(vIn.val[0], 4), vshrq_n_u8(vIn.val[1], 4)), vMask6);
+        vOut.val[2] = vandq_u8(vorrq_u8(vshlq_n_u8(vIn.val[1], 2), vshrq_n_u8(vIn.val[2], 6)), vMask6);
+        vOut.val[3] = vandq_u8(vIn.val[2], vMask6);
+        for(int k = 0; k < 4; ++k) {
+            vOut.val[k] = vqtbl4q_u8(vAlphabet, vOut.val[k]);
+        }
+        vst4q_u8(reinterpret_cast<uint8_t*>(aDest), vOut);
+        aDest += 64;
+    }
+    return i + _Base64EncodeScalar(aSrc + i, a_iLength - i, aDest);
+}
+//-----------------------------------------------------------------
+static size_t _Base64DecodeNEON(const char* aSrc, size_t a_iLength, unsigned char* aDest) {
+    const unsigned char* aValues = _Base64Values().aValues;
+    const uint8x16x4_t vLow = _Load64NEON(aValues);       // characters 0..63
+    const uint8x16x4_t vHigh = _Load64NEON(aValues + 64); // characters 64..127
+    size_t i = 0;
+    for(; i + 64 <= a_iLength; i += 64) {
+        uint8x16x4_t vIn = vld4q_u8(reinterpret_cast<const uint8_t*>(aSrc + i));
+        uint8x16_t vInvalid = vdupq_n_u8(0);
+        for(int k = 0; k < 4; ++k) {
+            // out of range lookups keep 0xFF, so bytes >= 0x80 stay invalid
+            uint8x16_t vSextets = vqtbx4q_u8(vdupq_n_u8(0xFF), vLow, vIn.val[k]);
+            vSextets = vqtbx4q_u8(vSextets, vHigh, vsubq_u8(vIn.val[k], vdupq_n_u8(64)));
+            vInvalid = vorrq_u8(vInvalid, vSextets);
+            vIn.val[k] = vSextets;
+        }
+        if(vmaxvq_u8(vInvalid) > 0x3F) {
+            break;
+        }
+        uint8x16x3_t vOut;
+        vOut.val[0] = vorrq_u8(vshlq_n_u8(vIn.val[0], 2), vshrq_n_u8(vIn.val[1], 4));
+        vOut.val[1] = vorrq_u8(vshlq_n_u8(vIn.val[1], 4), vshrq_n_u8(vIn.val[2], 2));
+        vOut.val[2] = vorrq_u8(vshlq_n_u8(vIn.val[2], 6), vIn.val[3]);
+        vst3q_u8(aDest, vOut);
+        aDest += 48;
+    }
+    return i + _Base64DecodeScalar(aSrc + i, a_iLength - i, aDest);
+}
+#endif // PJSON_SIMD_NEON
+
+//==[Dispatch]=============================================================
+static const pjsonKernels _ScalarKernels = {
+    _FindQuoteScalar, _FindStringEndScalar, _FindStringSpecialScalar, _FindEscapeScalar, _SkipSpaceScalar,
+    _ValidUtf8Scalar, _Base64EncodeScalar, _Base64DecodeScalar, pjson::Cpu::levelScalar
+};
+#if defined(PJSON_SIMD_X86)
+static const pjsonKernels _SSE2Kernels = {
+    _FindQuoteSSE2, _FindStringEndSSE2, _FindStringSpecialSSE2, _FindEscapeSSE2, _SkipSpaceSSE2,
+    _ValidUtf8SSE2, _Base64EncodeScalar, _Base64DecodeScalar, pjson::Cpu::levelSSE2
+};
+static const pjsonKernels _AVX2Kernels = {
+    _FindQuoteAVX2, _FindStringEndAVX2, _FindStringSpecialAVX2, _FindEscapeAVX2, _SkipSpaceAVX2,
+    _ValidUtf8AVX2, _Base64EncodeAVX2, _Base64DecodeAVX2, pjson::Cpu::levelAVX2
+};
+static const pjsonKernels _AVX512Kernels = {
+    _FindQuoteAVX512, _FindStringEndAVX512, _FindStringSpecialAVX512, _FindEscapeAVX512, _SkipSpaceAVX512,
+    _ValidUtf8AVX2, _Base64EncodeAVX2, _Base64DecodeAVX2, pjson::Cpu::levelAVX512
+};
+#endif
+#if defined(PJSON_SIMD_NEON)
+static const pjsonKernels _NEONKernels = {
+    _FindQuoteNEON, _FindStringEndNEON, _FindStringSpecialNEON, _FindEscapeNEON, _SkipSpaceNEON,
+    _ValidUtf8NEON, _Base64EncodeNEON, _Base64DecodeNEON, pjson::Cpu::levelNEON
+};
+#endif
+
+std::atomic<const pjsonKernels*> pjsonKernels::_pActive{nullptr};
+
+//-----------------------------------------------------------------
+static pjson::Cpu::Level _DetectLevel() {
+#if defined(PJSON_SIMD_X86) && defined(_MSC_VER) && !defined(__clang__)
+    int aRegs[4];
+    __cpuid(aRegs, 0);
+    int iMaxLeaf = aRegs[0];
+    __cpuid(aRegs, 1);
+    bool bSSE2 = 0 != (aRegs[3] & (1 << 26));
+    bool bAVX = 0 != (aRegs[2] & (1 << 28)) && 0 != (aRegs[2] & (1 << 27)); // AVX and OSXSAVE
+    unsigned long long iEnabled = bAVX ? _xgetbv(0) : 0; // register state the OS saves
+    bool bAVX2 = false;
+    bool bAVX512 = false;
+    if(iMaxLeaf >= 7) {
+        __cpuidex(aRegs, 7, 0);
+        bAVX2 = bAVX && 0 != (aRegs[1] & (1 << 5)) && 0x6 == (iEnabled & 0x6);
+        bAVX512 = bAVX2 && 0 != (aRegs[1] & (1 << 16)) && 0 != (aRegs[1] & (1 << 30)) && 0xE6 == (iEnabled & 0xE6);
+    }
+    return bAVX512 ? pjson::Cpu::levelAVX512 : bAVX2 ? pjson::Cpu::levelAVX2
+         : bSSE2 ? pjson::Cpu::levelSSE2 : pjson::Cpu::levelScalar;
+#elif defined(PJSON_SIMD_X86)
+    __builtin_cpu_init();
+    // these also check that the OS saves the wider registers
+    if(__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512bw")) {
+        return pjson::Cpu::levelAVX512;
+    } else if(__builtin_cpu_supports("avx2")) {
+        return pjson::Cpu::levelAVX2;
+    } else if(__builtin_cpu_supports("sse2")) {
+        return pjson::Cpu::levelSSE2;
+    }
+    return pjson::Cpu::levelScalar;
+#elif defined(PJSON_SIMD_NEON)
+    return pjson::Cpu::levelNEON; // part of every AArch64 core
+#else
+    return pjson::Cpu::levelScalar;
+#endif
+}
+//-----------------------------------------------------------------
+static const pjsonKernels& _KernelsFor(pjson::Cpu::Level a_eLevel) {
+    switch(a_eLevel) {
+#if defined(PJSON_SIMD_X86)
+        case pjson::Cpu::levelSSE2:   { return _SSE2Kernels; }
+        case pjson::Cpu::levelAVX2:   { return _AVX2Kernels; }
+        case pjson::Cpu::levelAVX512: { return _AVX512Kernels; }
+#endif
+#if defined(PJSON_SIMD_NEON)
+        case pjson::Cpu::levelNEON:   { return _NEONKernels; }
+#endif
+        default:                      { return _ScalarKernels; }
+    }
+}
+//-----------------------------------------------------------------
+// a_eLevel, or the next lower level this CPU supports
+static pjson::Cpu::Level _ClampLevel(pjson::Cpu::Level a_eLevel) {
+    while(!pjson::Cpu::IsSupported(a_eLevel)) {
+        a_eLevel = (pjson::Cpu::levelNEON == a_eLevel) ? pjson::Cpu::levelScalar
+                                                       : static_cast<pjson::Cpu::Level>(a_eLevel - 1);
+    }
+    return a_eLevel;
+}
+//-----------------------------------------------------------------
+/*static*/
+const pjsonKernels& pjsonKernels::_Select() {
+    // runs once; a SetLevel() that got in first is kept
+    static const pjsonKernels* s_pInitial = [] {
+        pjson::Cpu::Level eLevel = pjson::Cpu::Detected();
+        if(const char* pForced = getenv("PJSON_CPU_LEVEL")) {
+            for(int i = pjson::Cpu::levelScalar; i <= pjson::Cpu::levelNEON; ++i) {
+                pjson::Cpu::Level eForced = static_cast<pjson::Cpu::Level>(i);
+                if(0 == strcmp(pForced, pjson::Cpu::Name(eForced))) {
+                    eLevel = _ClampLevel(eForced);
+                    break;
+                }
+            }
+        }
+        return &_KernelsFor(eLevel);
+    }();
+    const pjsonKernels* pExpected = nullptr;
+    _pActive.compare_exchange_strong(pExpected, s_pInitial, std::memory_order_acq_rel);
+    return *_pActive.load(std::memory_order_acquire);
+}
+// Select at load time, so no caller pays for the detection
+static const pjsonKernels& _InitialKernels = pjsonKernels::Active();
+
+//-----------------------------------------------------------------
+/*static*/
+pjson::Cpu::Level pjson::Cpu::Detected() {
+    static const Level s_eDetected = _DetectLevel();
+    return s_eDetected;
+}
+//-----------------------------------------------------------------
+/*static*/
+pjson::Cpu::Level pjson::Cpu::Active() {
+    return pjsonKernels::Active().eLevel;
+}
+//-----------------------------------------------------------------
+/*static*/
+bool pjson::Cpu::IsSupported(Level a_eLevel) {
+    Level eDetected = Detected();
+    switch(a_eLevel) {
+        case levelScalar: { return true; }
+        case levelNEON:   { return levelNEON == eDetected; }
+        default:          { return levelNEON != eDetected && a_eLevel <= eDetected; }
+    }
+}
+//-----------------------------------------------------------------
+/*static*/
+pjson::Cpu::Level pjson::Cpu::SetLevel(Level a_eLevel) {
+    const pjsonKernels& rKernels = _KernelsFor(_ClampLevel(a_eLevel));
+    pjsonKernels::_pActive.store(&rKernels, std::memory_order_release);
+    return rKernels.eLevel;
+}
+//-----------------------------------------------------------------
+/*static*/
+const char* pjson::Cpu::Name(Level a_eLevel) {
+    switch(a_eLevel) {
+        case levelScalar: { return "scalar"; }
+        case levelSSE2:   { return "sse2"; }
+        case levelAVX2:   { return "avx2"; }
+        case levelAVX512: { return "avx512"; }
+        case levelNEON:   { return "neon"; }
+        default:          { return "unknown"; }
+    }
+}
+//-----------------------------------------------------------------
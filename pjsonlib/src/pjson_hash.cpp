@@ -0,0 +1,207 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#include "pjson_cache.h"
+#include <cstring>
+using namespace ByteDance;
+
+// Fixed constants keep hash() stable across runs, builds and platforms
+static const uint64_t _K0 = 0x9E3779B97F4A7C15ULL;
+static const uint64_t _K1 = 0xC2B2AE3D27D4EB4FULL;
+static const uint64_t _K2 = 0x165667B19E3779F9ULL;
+
+enum : uint64_t {
+    HashSeedNull = 1,
+    HashSeedBoolean,
+    HashSeedNumber, // ints and floats share a seed so 1 and 1.0 hash alike
+    HashSeedString,
+    HashSeedArray,
+    HashSeedMap,
+    HashSeedKey
+};
+
+//-----------------------------------------------------------------
+static inline uint64_t _Rotl(uint64_t aValue, int a_iBits) {
+    return (aValue << a_iBits) | (aValue >> (64 - a_iBits));
+}
+//-----------------------------------------------------------------
+// Final avalanche (MurmurHash3 fmix64)
+static inline uint64_t _Mix(uint64_t aValue) {
+    aValue ^= aValue >> 33;
+    aValue *= 0xFF51AFD7ED558CCDULL;
+    aValue ^= aValue >> 33;
+    aValue *= 0xC4CEB9FE1A85EC53ULL;
+    aValue ^= aValue >> 33;
+    return aValue;
+}
+//-----------------------------------------------------------------
+// Little endian on every platform
+static inline uint64_t _Load64(const unsigned char* aBytes) {
+    uint64_t iValue = 0;
+    for(int i = 7; i >= 0; --i) {
+        iValue = (iValue << 8) | aBytes[i];
+    }
+    return iValue;
+}
+//-----------------------------------------------------------------
+static uint64_t _HashBytes(const std::string& aStr, uint64_t a_iSeed) {
+    const unsigned char* pBytes = reinterpret_cast<const unsigned char*>(aStr.data());
+    size_t iLength = aStr.length();
+    uint64_t iHash = _Mix(a_iSeed) + iLength * _K0;
+    for(; iLength >= 8; iLength -= 8, pBytes += 8) {
+        iHash = _Rotl(iHash ^ (_Load64(pBytes) * _K1), 31) * _K0;
+    }
+    uint64_t iTail = 0;
+    for(size_t i = 0; i < iLength; ++i) {
+        iTail |= uint64_t(pBytes[i]) << (8 * i);
+    }
+    return _Mix(iHash ^ (iTail * _K2));
+}
+//-----------------------------------------------------------------
+static inline bool _IsNumber(pjson::jsonType aeType) {
+    return pjson::jsonNumberInt == aeType || pjson::jsonNumberFloat == aeType;
+}
+//-----------------------------------------------------------------
+// The value numbers are compared and hashed by across types
+static inline double _NumberKey(const pjson& aValue) {
+    double dValue = (pjson::jsonNumberInt == aValue.getType()) ? double(aValue.getInt64()) : aValue.getDouble();
+    return (0.0 == dValue) ? 0.0 : dValue; // -0.0 == 0.0
+}
+//-----------------------------------------------------------------
+/*static*/
+bool pjson::_isEqual(const pjson& aLeft, const pjson& aRight, bool a_bNumeric /*= false*/) {
+    if(&aLeft == &aRight) {
+        return true;
+    }
+    if(a_bNumeric && _IsNumber(aLeft._eType) && _IsNumber(aRight._eType)) {
+        if(jsonType::jsonNumberInt == aLeft._eType && jsonType::jsonNumberInt == aRight._eType) {
+            return aLeft.getInt64() == aRight.getInt64();
+        }
+        return _NumberKey(aLeft) == _NumberKey(aRight);
+    }
+    if(aLeft._eType != aRight._eType) {
+        return false;
+    }
+    if(aLeft._pValueRaw == aRight._pValueRaw) {
+        return true; // shared value (or both null)
+    }
+    if((aLeft._iFlags | aRight._iFlags) & FlagRawNumber) {
+        if(aLeft._iFlags & aRight._iFlags & FlagRawNumber) {
+            return *aLeft._pValueString == *aRight._pValueString; // forwarded text must match exactly
+        }
+        if(jsonType::jsonNumberInt == aLeft._eType) {
+            return aLeft.getInt64() == aRight.getInt64();
+        }
+        return aLeft.getDouble() == aRight.getDouble();
+    }
+    switch(aLeft._eType) {
+        case jsonType::jsonNull:         { return true; }
+        case jsonType::jsonString:       { return *aLeft._pValueString == *aRight._pValueString; }
+        case jsonType::jsonNumberInt:    { return *aLeft._pValueInt == *aRight._pValueInt; }
+        case jsonType::jsonNumberFloat:  { return *aLeft._pValueFloat == *aRight._pValueFloat; }
+        case jsonType::jsonBoolean:      { return *aLeft._pValueBool == *aRight._pValueBool; }
+        case jsonType::jsonArray:        {
+            if(aLeft._pValueArray->size() != aRight._pValueArray->size()) {
+                return false;
+            }
+            for(size_t i = 0; i < aLeft._pValueArray->size(); ++i) {
+                if(!_isEqual(*(*aLeft._pValueArray)[i], *(*aRight._pValueArray)[i], a_bNumeric)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case jsonType::jsonMap:          {
+            if(aLeft._pValueMap->size() != aRight._pValueMap->size()) {
+                return false;
+            }
+            // Both maps are sorted, so equal maps line up key by key
+            auto itRight = aRight._pValueMap->begin();
+            for(auto const& it : *aLeft._pValueMap) {
+                if(it.first != itRight->first || !_isEqual(*it.second, *itRight->second, a_bNumeric)) {
+                    return false;
+                }
+                ++itRight;
+            }
+            return true;
+        }
+    } //end switch
+    return false;
+}
+//-----------------------------------------------------------------
+bool pjson::equals(const pjson& aOther, bool a_bNumericEquality /*= false*/) const {
+    return _isEqual(*this, aOther, a_bNumericEquality);
+}
+//-----------------------------------------------------------------
+bool pjson::operator==(const pjson& aOther) const {
+    return _isEqual(*this, aOther);
+}
+//-----------------------------------------------------------------
+bool pjson::operator!=(const pjson& aOther) const {
+    return !_isEqual(*this, aOther);
+}
+//-----------------------------------------------------------------
+uint64_t pjson::hash() const {
+    return _hash(nullptr);
+}
+//-----------------------------------------------------------------
+// With a_pCache, arrays and objects it holds a current hash for are not walked
+uint64_t pjson::_hash(HashCache* a_pCache) const {
+    uint64_t iHash = 0;
+    switch(_eType) {
+        case jsonType::jsonNull:         { iHash = _Mix(HashSeedNull); break; }
+        case jsonType::jsonBoolean:      { iHash = _Mix(HashSeedBoolean * _K0 + (*_pValueBool ? 1 : 2)); break; }
+        case jsonType::jsonString:       { iHash = _HashBytes(*_pValueString, HashSeedString); break; }
+        case jsonType::jsonNumberInt:
+        case jsonType::jsonNumberFloat:  {
+            double dKey = _NumberKey(*this);
+            uint64_t iBits = 0;
+            memcpy(&iBits, &dKey, sizeof(iBits));
+            iHash = _Mix(HashSeedNumber * _K0 ^ _Mix(iBits));
+            break;
+        }
+        case jsonType::jsonArray:        {
+            if(a_pCache && a_pCache->_find(*this, iHash)) {
+                return iHash;
+            }
+            iHash = _Mix(HashSeedArray) + _pValueArray->size() * _K0;
+            for(const pjson* pElement : *_pValueArray) {
+                iHash = _Rotl(iHash ^ pElement->_hash(a_pCache), 29) * _K1; // order matters
+            }
+            iHash = _Mix(iHash);
+            break;
+        }
+        case jsonType::jsonMap:          {
+            if(a_pCache && a_pCache->_find(*this, iHash)) {
+                return iHash;
+            }
+            // Entries are summed, so the result does not depend on key order
+            uint64_t iSum = 0;
+            for(auto const& it : *_pValueMap) {
+                iSum += _Mix(_HashBytes(it.first, HashSeedKey) ^ _Rotl(it.second->_hash(a_pCache), 23) * _K2);
+            }
+            iHash = _Mix(_Mix(HashSeedMap) ^ (iSum + _pValueMap->size() * _K0));
+            break;
+        }
+    } //end switch
+    if(a_pCache && (jsonType::jsonArray == _eType || jsonType::jsonMap == _eType)) {
+        a_pCache->_store(*this, iHash);
+    }
+    return iHash;
+}
+//-----------------------------------------------------------------
@@ -0,0 +1,606 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#include "pjson_image.h"
+#include <climits>
+#include <cstddef>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <unordered_map>
+#ifndef _WIN32
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+using namespace ByteDance;
+
+// Layout, all records 8 byte aligned, all offsets from the start of the image:
+//   header   magic[8], version u32, byte order u32, image size u64, root Slot
+//   Slot     type u32, flags u32, payload u64 (value, or offset of its record)
+//   string   length u64, bytes, '\0'            (also the text of raw numbers)
+//   array    count u64, Slot[count]
+//   object   count u64, { key offset u64, Slot }[count], sorted by key
+struct _Slot {
+    uint32_t iType;
+    uint32_t iFlags;
+    uint64_t iPayload;
+};
+struct _Member {
+    uint64_t iKey;
+    _Slot oValue;
+};
+struct _Header {
+    char aMagic[8];
+    uint32_t iVersion;
+    uint32_t iByteOrder;
+    uint64_t iSize;
+    _Slot oRoot;
+};
+static const char _ImageMagic[8] = {'P', 'J', 'S', 'O', 'N', 'I', 'M', 'G'};
+static const uint32_t _ImageVersion = 1;
+static const uint32_t _ImageByteOrder = 0x01020304;
+static const uint32_t _SlotRawNumber = 1;
+static const uint64_t _RootSlot = offsetof(_Header, oRoot);
+
+//-----------------------------------------------------------------
+// Views only ever hold slot offsets that were checked against the image
+static const _Slot* _SlotAt(const char* aBase, uint64_t a_iSlot) {
+    return (0 == a_iSlot) ? nullptr : reinterpret_cast<const _Slot*>(aBase + a_iSlot);
+}
+//-----------------------------------------------------------------
+static size_t _Align8(size_t a_iSize) {
+    return (a_iSize + 7) & ~static_cast<size_t>(7);
+}
+//-----------------------------------------------------------------
+// Lays a tree out depth first; each container's slots are written as soon
+// as its children have been placed
+class pjson::Image::Builder {
+public:
+    explicit Builder(std::string& a_rOut) : _rOut(a_rOut) {}
+
+    void write(const pjson& aRoot) {
+        _rOut.assign(sizeof(_Header), '\0');
+        _Header oHeader;
+        memcpy(oHeader.aMagic, _ImageMagic, sizeof(_ImageMagic));
+        oHeader.iVersion = _ImageVersion;
+        oHeader.iByteOrder = _ImageByteOrder;
+        oHeader.iSize = 0;
+        oHeader.oRoot = _slot(aRoot);
+        oHeader.iSize = _rOut.size();
+        memcpy(&_rOut[0], &oHeader, sizeof(oHeader));
+    }
+
+private:
+    uint64_t _reserve(size_t a_iBytes) {
+        uint64_t iOffset = _rOut.size();
+        _rOut.resize(iOffset + _Align8(a_iBytes), '\0');
+        return iOffset;
+    }
+    uint64_t _text(const char* aText, size_t a_iLength) {
+        uint64_t iOffset = _reserve(sizeof(uint64_t) + a_iLength + 1);
+        uint64_t iLength = a_iLength;
+        memcpy(&_rOut[iOffset], &iLength, sizeof(iLength));
+        memcpy(&_rOut[iOffset + sizeof(iLength)], aText, a_iLength);
+        return iOffset;
+    }
+    uint64_t _key(const std::string& aKey) {
+        auto it = _mKeys.find(aKey);
+        if(it != _mKeys.end()) {
+            return it->second;
+        }
+        uint64_t iOffset = _text(aKey.data(), aKey.length());
+        _mKeys.emplace(aKey, iOffset);
+        return iOffset;
+    }
+    _Slot _slot(const pjson& aNode) {
+        _Slot oSlot;
+        oSlot.iType = static_cast<uint32_t>(aNode.getType());
+        oSlot.iFlags = 0;
+        oSlot.iPayload = 0;
+        switch(aNode.getType()) {
+            case pjson::jsonNull: {
+                break;
+            }
+            case pjson::jsonString: {
+                std::string sValue = aNode.getString();
+                oSlot.iPayload = _text(sValue.data(), sValue.length());
+                break;
+            }
+            case pjson::jsonNumberInt:
+            case pjson::jsonNumberFloat: {
+                if(aNode.isRawNumber()) {
+                    oSlot.iFlags = _SlotRawNumber;
+                    oSlot.iPayload = _text(aNode._pValueString->data(), aNode._pValueString->length());
+                } else if(pjson::jsonNumberInt == aNode.getType()) {
+                    oSlot.iPayload = static_cast<uint64_t>(static_cast<int64_t>(aNode.getInt()));
+                } else {
+                    float fValue = aNode.getFloat();
+                    uint32_t iBits = 0;
+                    memcpy(&iBits, &fValue, sizeof(iBits));
+                    oSlot.iPayload = iBits;
+                }
+                break;
+            }
+            case pjson::jsonBoolean: {
+                oSlot.iPayload = aNode.getBool() ? 1 : 0;
+                break;
+            }
+            case pjson::jsonArray: {
+                const pjson::PJSONARRAY& rArray = *aNode.getArray();
+                uint64_t iCount = rArray.size();
+                uint64_t iOffset = _reserve(sizeof(uint64_t) + rArray.size() * sizeof(_Slot));
+                memcpy(&_rOut[iOffset], &iCount, sizeof(iCount));
+                for(size_t i = 0; i < rArray.size(); ++i) {
+                    _Slot oItem = _slot(*rArray[i]);
+                    memcpy(&_rOut[iOffset + sizeof(uint64_t) + i * sizeof(_Slot)], &oItem, sizeof(oItem));
+                }
+                oSlot.iPayload = iOffset;
+                break;
+            }
+            case pjson::jsonMap: {
+                const pjson::PJSONMAP& rMap = *aNode.getMap();
+                uint64_t iCount = rMap.size();
+                uint64_t iOffset = _reserve(sizeof(uint64_t) + rMap.size() * sizeof(_Member));
+                memcpy(&_rOut[iOffset], &iCount, sizeof(iCount));
+                size_t i = 0;
+                for(const auto& rMember : rMap) { // std::map order is the byte order the lookups expect
+                    _Member oMember;
+                    oMember.iKey = _key(rMember.first);
+                    oMember.oValue = _slot(*rMember.second);
+                    memcpy(&_rOut[iOffset + sizeof(uint64_t) + i * sizeof(_Member)], &oMember, sizeof(oMember));
+                    ++i;
+                }
+                oSlot.iPayload = iOffset;
+                break;
+            }
+        }
+        return oSlot;
+    }
+
+private:
+    std::string& _rOut;
+    std::unordered_map<std::string, uint64_t> _mKeys;
+};
+//-----------------------------------------------------------------
+/*static*/
+void pjson::Image::Create(const pjson& aRoot, std::string& a_rOut) {
+    Builder oBuilder(a_rOut);
+    oBuilder.write(aRoot);
+}
+//-----------------------------------------------------------------
+/*static*/
+bool pjson::Image::Save(const pjson& aRoot, const char* aPath) {
+    std::string sImage;
+    Create(aRoot, sImage);
+    FILE* pFile = fopen(aPath, "wb");
+    if(nullptr == pFile) {
+        return false;
+    }
+    bool bOk = 1 == fwrite(sImage.data(), sImage.size(), 1, pFile);
+    bOk = (0 == fclose(pFile)) && bOk;
+    return bOk;
+}
+//-----------------------------------------------------------------
+/*static*/
+bool pjson::Image::_IsValid(const char* aData, size_t a_iSize) {
+    if(nullptr == aData || 0 != (reinterpret_cast<uintptr_t>(aData) & 7) || a_iSize < sizeof(_Header)) {
+        return false;
+    }
+    const _Header* pHeader = reinterpret_cast<const _Header*>(aData);
+    return 0 == memcmp(pHeader->aMagic, _ImageMagic, sizeof(_ImageMagic))
+           && _ImageVersion == pHeader->iVersion
+           && _ImageByteOrder == pHeader->iByteOrder
+           && a_iSize == pHeader->iSize;
+}
+//-----------------------------------------------------------------
+/*static*/
+pjson::Image* pjson::Image::Open(const char* aPath) {
+#ifndef _WIN32
+    int iFile = open(aPath, O_RDONLY);
+    if(iFile < 0) {
+        return nullptr;
+    }
+    struct stat oStat;
+    void* pMapping = MAP_FAILED;
+    if(0 == fstat(iFile, &oStat) && oStat.st_size >= static_cast<off_t>(sizeof(_Header))) {
+        pMapping = mmap(nullptr, static_cast<size_t>(oStat.st_size), PROT_READ, MAP_SHARED, iFile, 0);
+    }
+    close(iFile); // the mapping keeps the file
+    if(MAP_FAILED == pMapping) {
+        return nullptr;
+    }
+    const size_t iSize = static_cast<size_t>(oStat.st_size);
+    if(!_IsValid(static_cast<const char*>(pMapping), iSize)) {
+        munmap(pMapping, iSize);
+        return nullptr;
+    }
+    return new Image(static_cast<const char*>(pMapping), iSize, true);
+#else
+    // No mapping here: the image is read into memory, and still used without parsing
+    FILE* pFile = fopen(aPath, "rb");
+    if(nullptr == pFile) {
+        return nullptr;
+    }
+    Image* pImage = new Image(nullptr, 0, false);
+    char aBuffer[64 * 1024];
+    size_t iRead = 0;
+    while((iRead = fread(aBuffer, 1, sizeof(aBuffer), pFile)) > 0) {
+        pImage->_sOwned.append(aBuffer, iRead);
+    }
+    fclose(pFile);
+    pImage->_pData = pImage->_sOwned.data();
+    pImage->_iSize = pImage->_sOwned.size();
+    if(!_IsValid(pImage->_pData, pImage->_iSize)) {
+        delete pImage;
+        return nullptr;
+    }
+    return pImage;
+#endif
+}
+//-----------------------------------------------------------------
+/*static*/
+pjson::Image* pjson::Image::FromBuffer(const char* aData, size_t a_iSize) {
+    if(!_IsValid(aData, a_iSize)) {
+        return nullptr;
+    }
+    return new Image(aData, a_iSize, false);
+}
+//-----------------------------------------------------------------
+pjson::Image::Image(const char* aData, size_t a_iSize, bool a_bMapped)
+        : _pData(aData)
+        , _iSize(a_iSize)
+        , _bMapped(a_bMapped)
+{
+
+}
+//-----------------------------------------------------------------
+pjson::Image::~Image() {
+#ifndef _WIN32
+    if(_bMapped) {
+        munmap(const_cast<char*>(_pData), _iSize);
+    }
+#endif
+}
+//-----------------------------------------------------------------
+pjson::Image::View pjson::Image::root() const {
+    return View(_pData, _iSize, _RootSlot);
+}
+//-----------------------------------------------------------------
+size_t pjson::Image::size() const {
+    return _iSize;
+}
+//-----------------------------------------------------------------
+bool pjson::Image::isMapped() const {
+    return _bMapped;
+}
+//-----------------------------------------------------------------
+pjson::Image::View::View()
+        : _pBase(nullptr)
+        , _iSize(0)
+        , _iSlot(0)
+{
+
+}
+//-----------------------------------------------------------------
+pjson::Image::View::View(const char* aBase, uint64_t a_iSize, uint64_t a_iSlot)
+        : _pBase(aBase)
+        , _iSize(a_iSize)
+        , _iSlot(a_iSlot)
+{
+
+}
+//-----------------------------------------------------------------
+// A counted record at a_iOffset, checked to lie inside the image
+const char* pjson::Image::View::_record(uint64_t a_iOffset, size_t a_iItemSize, uint64_t& a_rCount) const {
+    if(0 != (a_iOffset & 7) || a_iOffset < sizeof(_Header) || a_iOffset > _iSize - sizeof(uint64_t)) {
+        return nullptr;
+    }
+    memcpy(&a_rCount, _pBase + a_iOffset, sizeof(a_rCount));
+    if(a_rCount > (_iSize - a_iOffset - sizeof(uint64_t)) / a_iItemSize) {
+        return nullptr;
+    }
+    return _pBase + a_iOffset + sizeof(uint64_t);
+}
+//-----------------------------------------------------------------
+// A string record, including its terminator
+const char* pjson::Image::View::_text(uint64_t a_iOffset, size_t& a_rLength) const {
+    uint64_t iLength = 0;
+    const char* pText = _record(a_iOffset, 1, iLength);
+    if(nullptr == pText || iLength >= _iSize - (pText - _pBase) || '\0' != pText[iLength]) {
+        a_rLength = 0;
+        return nullptr;
+    }
+    a_rLength = static_cast<size_t>(iLength);
+    return pText;
+}
+//-----------------------------------------------------------------
+pjson::jsonType pjson::Image::View::getType() const {
+    const _Slot* pSlot = _SlotAt(_pBase, _iSlot);
+    if(nullptr == pSlot || pSlot->iType > jsonMap) {
+        return jsonNull;
+    }
+    return static_cast<jsonType>(pSlot->iType);
+}
+//-----------------------------------------------------------------
+bool pjson::Image::View::isNull() const {
+    return jsonNull == getType();
+}
+//-----------------------------------------------------------------
+size_t pjson::Image::View::size() const {
+    uint64_t iCount = 0;
+    switch(getType()) {
+        case jsonArray: { return _record(_SlotAt(_pBase, _iSlot)->iPayload, sizeof(_Slot), iCount) ? static_cast<size_t>(iCount) : 0; }
+        case jsonMap:   { return _record(_SlotAt(_pBase, _iSlot)->iPayload, sizeof(_Member), iCount) ? static_cast<size_t>(iCount) : 0; }
+        default:        { return 0; }
+    }
+}
+//-----------------------------------------------------------------
+pjson::Image::View pjson::Image::View::at(int index) const {
+    uint64_t iCount = 0;
+    const char* pItems = (jsonArray == getType()) ? _record(_SlotAt(_pBase, _iSlot)->iPayload, sizeof(_Slot), iCount) : nullptr;
+    if(nullptr == pItems || index < 0 || static_cast<uint64_t>(index) >= iCount) {
+        return View();
+    }
+    return View(_pBase, _iSize, (pItems - _pBase) + static_cast<uint64_t>(index) * sizeof(_Slot));
+}
+//-----------------------------------------------------------------
+// Binary search over the sorted members, comparing like std::string
+pjson::Image::View pjson::Image::View::_find(const char* aKey, size_t a_iLength) const {
+    uint64_t iCount = 0;
+    const char* pMembers = (jsonMap == getType()) ? _record(_SlotAt(_pBase, _iSlot)->iPayload, sizeof(_Member), iCount) : nullptr;
+    if(nullptr == pMembers) {
+        return View();
+    }
+    uint64_t iLow = 0;
+    uint64_t iHigh = iCount;
+    while(iLow < iHigh) {
+        uint64_t iMid = iLow + (iHigh - iLow) / 2;
+        const _Member* pMember = reinterpret_cast<const _Member*>(pMembers) + iMid;
+        size_t iLength = 0;
+        const char* pKey = _text(pMember->iKey, iLength);
+        if(nullptr == pKey) {
+            return View();
+        }
+        int iCompare = memcmp(pKey, aKey, (iLength < a_iLength) ? iLength : a_iLength);
+        if(0 == iCompare) {
+            iCompare = (iLength < a_iLength) ? -1 : (iLength > a_iLength) ? 1 : 0;
+        }
+        if(0 == iCompare) {
+            return View(_pBase, _iSize, (reinterpret_cast<const char*>(&pMember->oValue) - _pBase));
+        }
+        if(iCompare < 0) {
+            iLow = iMid + 1;
+        } else {
+            iHigh = iMid;
+        }
+    }
+    return View();
+}
+//-----------------------------------------------------------------
+pjson::Image::View pjson::Image::View::at(const char* aSkey) const {
+    return _find(aSkey, strlen(aSkey));
+}
+//-----------------------------------------------------------------
+pjson::Image::View pjson::Image::View::at(const std::string& aString) const {
+    return _find(aString.data(), aString.length());
+}
+//-----------------------------------------------------------------
+pjson::Image::View pjson::Image::View::operator[](int index) const {
+    return at(index);
+}
+//-----------------------------------------------------------------
+pjson::Image::View pjson::Image::View::operator[](const char* aSkey) const {
+    return at(aSkey);
+}
+//-----------------------------------------------------------------
+pjson::Image::View pjson::Image::View::operator[](const std::string& aString) const {
+    return at(aString);
+}
+//-----------------------------------------------------------------
+bool pjson::Image::View::hasKey(const char* aKey) const {
+    return 0 != _find(aKey, strlen(aKey))._iSlot;
+}
+//-----------------------------------------------------------------
+bool pjson::Image::View::hasKey(const std::string& aKey) const {
+    return 0 != _find(aKey.data(), aKey.length())._iSlot;
+}
+//-----------------------------------------------------------------
+const char* pjson::Image::View::keyAt(size_t a_iIndex, size_t& a_rLength) const {
+    uint64_t iCount = 0;
+    const char* pMembers = (jsonMap == getType()) ? _record(_SlotAt(_pBase, _iSlot)->iPayload, sizeof(_Member), iCount) : nullptr;
+    a_rLength = 0;
+    if(nullptr == pMembers || a_iIndex >= iCount) {
+        return nullptr;
+    }
+    return _text(reinterpret_cast<const _Member*>(pMembers)[a_iIndex].iKey, a_rLength);
+}
+//-----------------------------------------------------------------
+pjson::Image::View pjson::Image::View::valueAt(size_t a_iIndex) const {
+    uint64_t iCount = 0;
+    const char* pMembers = (jsonMap == getType()) ? _record(_SlotAt(_pBase, _iSlot)->iPayload, sizeof(_Member), iCount) : nullptr;
+    if(nullptr == pMembers || a_iIndex >= iCount) {
+        return View();
+    }
+    const _Member* pMember = reinterpret_cast<const _Member*>(pMembers) + a_iIndex;
+    return View(_pBase, _iSize, (reinterpret_cast<const char*>(&pMember->oValue) - _pBase));
+}
+//-----------------------------------------------------------------
+bool pjson::Image::View::isRawNumber() const {
+    const _Slot* pSlot = _SlotAt(_pBase, _iSlot);
+    return pSlot && (jsonNumberInt == getType() || jsonNumberFloat == getType()) && (pSlot->iFlags & _SlotRawNumber);
+}
+//-----------------------------------------------------------------
+float pjson::Image::View::getFloat() const {
+    if(isRawNumber()) {
+        return static_cast<float>(getDouble());
+    }
+    switch(getType()) {
+        case jsonNumberInt:   { return float(static_cast<int64_t>(_SlotAt(_pBase, _iSlot)->iPayload)); }
+        case jsonNumberFloat: {
+            uint32_t iBits = static_cast<uint32_t>(_SlotAt(_pBase, _iSlot)->iPayload);
+            float fValue;
+            memcpy(&fValue, &iBits, sizeof(fValue));
+            return fValue;
+        }
+        default:              { return 0.0f; }
+    }
+}
+//-----------------------------------------------------------------
+int pjson::Image::View::getInt() const {
+    if(isRawNumber()) {
+        if(jsonNumberFloat == getType()) {
+            return int(getDouble());
+        }
+        int64_t iValue = getInt64();
+        return (iValue > INT_MAX) ? INT_MAX : (iValue < INT_MIN) ? INT_MIN : static_cast<int>(iValue);
+    }
+    switch(getType()) {
+        case jsonNumberInt:   { return static_cast<int>(static_cast<int64_t>(_SlotAt(_pBase, _iSlot)->iPayload)); }
+        case jsonNumberFloat: { return int(getFloat()); }
+        default:              { return 0; }
+    }
+}
+//-----------------------------------------------------------------
+int64_t pjson::Image::View::getInt64() const {
+    if(isRawNumber()) {
+        if(jsonNumberFloat == getType()) {
+            return static_cast<int64_t>(getDouble());
+        }
+        size_t iLength = 0;
+        const char* pText = _text(_SlotAt(_pBase, _iSlot)->iPayload, iLength);
+        return pText ? strtoll(pText, nullptr, 10) : 0; // terminated in the image
+    }
+    switch(getType()) {
+        case jsonNumberInt:   { return static_cast<int64_t>(_SlotAt(_pBase, _iSlot)->iPayload); }
+        case jsonNumberFloat: { return static_cast<int64_t>(getFloat()); }
+        default:              { return 0; }
+    }
+}
+//-----------------------------------------------------------------
+double pjson::Image::View::getDouble() const {
+    if(isRawNumber()) {
+        size_t iLength = 0;
+        const char* pText = _text(_SlotAt(_pBase, _iSlot)->iPayload, iLength);
+        return pText ? strtod(pText, nullptr) : 0.0;
+    }
+    switch(getType()) {
+        case jsonNumberInt:   { return static_cast<double>(static_cast<int64_t>(_SlotAt(_pBase, _iSlot)->iPayload)); }
+        case jsonNumberFloat: { return getFloat(); }
+        default:              { return 0.0; }
+    }
+}
+//-----------------------------------------------------------------
+bool pjson::Image::View::getBool() const {
+    switch(getType()) {
+        case jsonString: {
+            size_t iLength = 0;
+            return nullptr != getStringData(iLength) && iLength > 0;
+        }
+        case jsonNumberInt:   { return 0 != getInt64(); }
+        case jsonNumberFloat: { return isRawNumber() ? (0.0 != getDouble()) : (0.0f != getFloat()); }
+        case jsonBoolean:     { return 0 != _SlotAt(_pBase, _iSlot)->iPayload; }
+        default:              { return false; }
+    }
+}
+//-----------------------------------------------------------------
+const char* pjson::Image::View::getStringData(size_t& a_rLength) const {
+    a_rLength = 0;
+    if(jsonString != getType()) {
+        return nullptr;
+    }
+    return _text(_SlotAt(_pBase, _iSlot)->iPayload, a_rLength);
+}
+//-----------------------------------------------------------------
+std::string pjson::Image::View::getString() const {
+    size_t iLength = 0;
+    const char* pText = getStringData(iLength);
+    return pText ? std::string(pText, iLength) : std::string();
+}
+//-----------------------------------------------------------------
+pjson* pjson::Image::View::toPjson() const {
+    pjson* pResult = new pjson();
+    // Every value of a sound image has a slot of its own
+    size_t iBudget = static_cast<size_t>(_iSize / sizeof(_Slot));
+    if(!_materialize(*pResult, 0, iBudget)) {
+        pResult->reset(); // offsets that loop back in a corrupt image
+    }
+    return pResult;
+}
+//-----------------------------------------------------------------
+// Depth limited like parsing, and false once more values were reached than
+// the image has slots for, which stops offset cycles in a corrupt image
+bool pjson::Image::View::_materialize(pjson& a_rOut, size_t a_iDepth, size_t& a_rBudget) const {
+    if(0 == a_rBudget) {
+        return false;
+    }
+    --a_rBudget;
+    const jsonType eType = getType();
+    if((jsonArray == eType || jsonMap == eType) && a_iDepth >= GetMaxParseDepth()) {
+        return true;
+    }
+    if(isRawNumber()) {
+        size_t iLength = 0;
+        const char* pText = _text(_SlotAt(_pBase, _iSlot)->iPayload, iLength);
+        a_rOut._setRawNumber(eType, pText ? pText : "0", pText ? iLength : 1);
+        return true;
+    }
+    a_rOut.resetTo(eType);
+    switch(eType) {
+        case jsonString:      { *a_rOut._pValueString = getString(); break; }
+        case jsonNumberInt:   { *a_rOut._pValueInt = getInt(); break; }
+        case jsonNumberFloat: { *a_rOut._pValueFloat = getFloat(); break; }
+        case jsonBoolean:     { *a_rOut._pValueBool = getBool(); break; }
+        case jsonArray: {
+            const size_t iCount = size();
+            a_rOut._pValueArray->reserve(iCount);
+            for(size_t i = 0; i < iCount; ++i) {
+                pjson* pItem = new pjson();
+                a_rOut._pValueArray->push_back(pItem);
+                if(!at(static_cast<int>(i))._materialize(*pItem, a_iDepth + 1, a_rBudget)) {
+                    return false;
+                }
+            }
+            break;
+        }
+        case jsonMap: {
+            const size_t iCount = size();
+            for(size_t i = 0; i < iCount; ++i) {
+                size_t iLength = 0;
+                const char* pKey = keyAt(i, iLength);
+                pjson* pValue = new pjson();
+                // Keys arrive sorted, so every insert goes at the end
+                auto it = a_rOut._pValueMap->emplace_hint(a_rOut._pValueMap->end(), std::string(pKey ? pKey : "", iLength), pValue);
+                if(it->second != pValue) { // duplicate key in a corrupt image
+                    delete pValue;
+                    continue;
+                }
+                if(!valueAt(i)._materialize(*pValue, a_iDepth + 1, a_rBudget)) {
+                    return false;
+                }
+            }
+            break;
+        }
+        default: {
+            break;
+        }
+    }
+    return true;
+}
+//-----------------------------------------------------------------
@@ -0,0 +1,260 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#include "pjson_index.h"
+#include "pjson_stream.h"
+#include <cctype>
+#include <cstring>
+#include <sys/stat.h>
+using namespace ByteDance;
+
+// Sidecar layout: magic, data file size, data file mtime (ns), data file
+// fingerprint, offset count, offsets
+static const char _SidecarMagic[8] = {'P', 'J', 'S', 'O', 'N', 'I', 'X', '2'};
+// Bytes hashed at each end of the data file for its fingerprint
+static const size_t _FingerprintChunk = 64 * 1024;
+
+//-----------------------------------------------------------------
+static bool _ReadAt(FILE* a_pFile, uint64_t a_iOffset, size_t a_iLength, std::string& a_rOut) {
+#ifdef _WIN32
+    if(0 != _fseeki64(a_pFile, static_cast<__int64>(a_iOffset), SEEK_SET)) {
+#else
+    if(0 != fseeko(a_pFile, static_cast<off_t>(a_iOffset), SEEK_SET)) {
+#endif
+        return false;
+    }
+    a_rOut.resize(a_iLength);
+    size_t iRead = a_iLength ? fread(&a_rOut[0], 1, a_iLength, a_pFile) : 0;
+    a_rOut.resize(iRead);
+    return iRead == a_iLength;
+}
+//-----------------------------------------------------------------
+// Modification time in nanoseconds where the platform keeps them
+static int64_t _FileTime(const struct stat& aStat) {
+#if defined(__APPLE__)
+    return static_cast<int64_t>(aStat.st_mtimespec.tv_sec) * 1000000000 + aStat.st_mtimespec.tv_nsec;
+#elif defined(_WIN32)
+    return static_cast<int64_t>(aStat.st_mtime) * 1000000000;
+#else
+    return static_cast<int64_t>(aStat.st_mtim.tv_sec) * 1000000000 + aStat.st_mtim.tv_nsec;
+#endif
+}
+//-----------------------------------------------------------------
+// FNV-1a over the first and the last chunk of the file, so a rewrite that
+// keeps the size and lands within the clock's resolution is still noticed
+static bool _Fingerprint(FILE* a_pFile, uint64_t a_iFileSize, uint64_t& a_rFingerprint) {
+    std::string sChunk;
+    uint64_t iHash = 0xCBF29CE484222325ULL;
+    uint64_t iHead = (a_iFileSize < _FingerprintChunk) ? a_iFileSize : _FingerprintChunk;
+    uint64_t iTail = (a_iFileSize - iHead < _FingerprintChunk) ? a_iFileSize - iHead : _FingerprintChunk;
+    for(int i = 0; i < 2; ++i) {
+        uint64_t iOffset = (0 == i) ? 0 : a_iFileSize - iTail;
+        if(!_ReadAt(a_pFile, iOffset, static_cast<size_t>((0 == i) ? iHead : iTail), sChunk)) {
+            return false;
+        }
+        for(unsigned char c : sChunk) {
+            iHash = (iHash ^ c) * 0x100000001B3ULL;
+        }
+    }
+    a_rFingerprint = iHash;
+    return true;
+}
+//-----------------------------------------------------------------
+/*static*/
+pjson::ArrayIndex* pjson::ArrayIndex::Open(const char* aPath, const char* aSidecarPath /*= nullptr*/) {
+    struct stat oStat;
+    if(0 != stat(aPath, &oStat)) {
+        return nullptr;
+    }
+    FILE* pFile = fopen(aPath, "rb");
+    if(nullptr == pFile) {
+        return nullptr;
+    }
+    ArrayIndex* pIndex = new ArrayIndex(pFile, static_cast<uint64_t>(oStat.st_size), _FileTime(oStat));
+    if(!_Fingerprint(pFile, pIndex->_iFileSize, pIndex->_iFingerprint)) {
+        delete pIndex;
+        return nullptr;
+    }
+    if(aSidecarPath && pIndex->_load(aSidecarPath)) {
+        return pIndex;
+    }
+    if(!pIndex->_build()) {
+        delete pIndex;
+        return nullptr;
+    }
+    if(aSidecarPath) {
+        pIndex->save(aSidecarPath); // best effort; the index in memory is complete
+    }
+    return pIndex;
+}
+//-----------------------------------------------------------------
+pjson::ArrayIndex::ArrayIndex(FILE* a_pFile, uint64_t a_iFileSize, int64_t a_iFileTime)
+        : _pFile(a_pFile)
+        , _iFileSize(a_iFileSize)
+        , _iFileTime(a_iFileTime)
+{
+
+}
+//-----------------------------------------------------------------
+pjson::ArrayIndex::~ArrayIndex() {
+    fclose(_pFile);
+}
+//-----------------------------------------------------------------
+// One pass with the streaming record scanner; nothing is parsed
+bool pjson::ArrayIndex::_build() {
+    _vOffsets.clear();
+    rewind(_pFile);
+    InputStream* pSource = InputStream::FromFile(_pFile);
+    bool bOk = false;
+    {
+        RecordReader oReader(*pSource, RecordReader::modeArray, 1024 * 1024);
+        const char* pText = nullptr;
+        size_t iLength = 0;
+        uint64_t iEnd = 0;
+        while(oReader.nextText(pText, iLength)) {
+            _vOffsets.push_back(oReader.offset());
+            iEnd = oReader.offset() + iLength;
+        }
+        _vOffsets.push_back(iEnd);
+        bOk = !oReader.failed();
+    }
+    delete pSource;
+    return bOk;
+}
+//-----------------------------------------------------------------
+bool pjson::ArrayIndex::_load(const char* aSidecarPath) {
+    FILE* pSidecar = fopen(aSidecarPath, "rb");
+    if(nullptr == pSidecar) {
+        return false;
+    }
+    char aMagic[sizeof(_SidecarMagic)];
+    uint64_t iFileSize = 0;
+    int64_t iFileTime = 0;
+    uint64_t iFingerprint = 0;
+    uint64_t iCount = 0;
+    bool bOk = 1 == fread(aMagic, sizeof(aMagic), 1, pSidecar)
+               && 0 == memcmp(aMagic, _SidecarMagic, sizeof(aMagic))
+               && 1 == fread(&iFileSize, sizeof(iFileSize), 1, pSidecar)
+               && 1 == fread(&iFileTime, sizeof(iFileTime), 1, pSidecar)
+               && 1 == fread(&iFingerprint, sizeof(iFingerprint), 1, pSidecar)
+               && 1 == fread(&iCount, sizeof(iCount), 1, pSidecar)
+               && iFileSize == _iFileSize && iFileTime == _iFileTime && iFingerprint == _iFingerprint // else stale
+               && iCount > 0 && iCount <= _iFileSize + 1;
+    if(bOk) {
+        _vOffsets.resize(static_cast<size_t>(iCount));
+        bOk = iCount == fread(_vOffsets.data(), sizeof(uint64_t), _vOffsets.size(), pSidecar);
+        for(size_t i = 1; bOk && i < _vOffsets.size(); ++i) {
+            bOk = _vOffsets[i - 1] <= _vOffsets[i];
+        }
+        bOk = bOk && _vOffsets.back() <= _iFileSize;
+    }
+    fclose(pSidecar);
+    if(!bOk) {
+        _vOffsets.clear();
+    }
+    return bOk;
+}
+//-----------------------------------------------------------------
+bool pjson::ArrayIndex::save(const char* aSidecarPath) const {
+    FILE* pSidecar = fopen(aSidecarPath, "wb");
+    if(nullptr == pSidecar) {
+        return false;
+    }
+    uint64_t iCount = _vOffsets.size();
+    bool bOk = 1 == fwrite(_SidecarMagic, sizeof(_SidecarMagic), 1, pSidecar)
+               && 1 == fwrite(&_iFileSize, sizeof(_iFileSize), 1, pSidecar)
+               && 1 == fwrite(&_iFileTime, sizeof(_iFileTime), 1, pSidecar)
+               && 1 == fwrite(&_iFingerprint, sizeof(_iFingerprint), 1, pSidecar)
+               && 1 == fwrite(&iCount, sizeof(iCount), 1, pSidecar)
+               && _vOffsets.size() == fwrite(_vOffsets.data(), sizeof(uint64_t), _vOffsets.size(), pSidecar);
+    return (0 == fclose(pSidecar)) && bOk;
+}
+//-----------------------------------------------------------------
+size_t pjson::ArrayIndex::size() const {
+    return _vOffsets.empty() ? 0 : _vOffsets.size() - 1;
+}
+//-----------------------------------------------------------------
+bool pjson::ArrayIndex::text(size_t a_iIndex, std::string& a_rOut) {
+    if(a_iIndex >= size()
+       || !_ReadAt(_pFile, _vOffsets[a_iIndex], static_cast<size_t>(_vOffsets[a_iIndex + 1] - _vOffsets[a_iIndex]), a_rOut)) {
+        return false;
+    }
+    // up to the next element: drop the separator
+    size_t iLength = a_rOut.length();
+    while(iLength > 0 && (isspace(static_cast<unsigned char>(a_rOut[iLength - 1])) || ',' == a_rOut[iLength - 1])) {
+        --iLength;
+    }
+    a_rOut.resize(iLength);
+    return true;
+}
+//-----------------------------------------------------------------
+pjson* pjson::ArrayIndex::parse(size_t a_iIndex) {
+    if(!text(a_iIndex, _sBuffer)) {
+        return nullptr;
+    }
+    return CreateFromString(_sBuffer.data(), _sBuffer.size());
+}
+//-----------------------------------------------------------------
+pjson* pjson::ArrayIndex::parse(size_t a_iIndex, ParseContext& a_rContext) {
+    if(!text(a_iIndex, _sBuffer)) {
+        return nullptr;
+    }
+    return CreateFromString(_sBuffer.data(), _sBuffer.size(), a_rContext);
+}
+//-----------------------------------------------------------------
+pjson::ArrayIndex::Ptr pjson::ArrayIndex::get(size_t a_iIndex) {
+    auto it = _mCache.find(a_iIndex);
+    if(it != _mCache.end()) {
+        _lRecent.splice(_lRecent.begin(), _lRecent, it->second.second);
+        return it->second.first;
+    }
+    Ptr pElement(parse(a_iIndex));
+    if(pElement && _iCacheSize > 0) {
+        _lRecent.push_front(a_iIndex);
+        _mCache[a_iIndex] = std::make_pair(pElement, _lRecent.begin());
+        while(_mCache.size() > _iCacheSize) {
+            evict(_lRecent.back());
+        }
+    }
+    return pElement;
+}
+//-----------------------------------------------------------------
+void pjson::ArrayIndex::setCacheSize(size_t a_iElements) {
+    _iCacheSize = a_iElements;
+    while(_mCache.size() > _iCacheSize) {
+        evict(_lRecent.back());
+    }
+}
+//-----------------------------------------------------------------
+size_t pjson::ArrayIndex::cached() const {
+    return _mCache.size();
+}
+//-----------------------------------------------------------------
+void pjson::ArrayIndex::evict(size_t a_iIndex) {
+    auto it = _mCache.find(a_iIndex);
+    if(it != _mCache.end()) {
+        _lRecent.erase(it->second.second);
+        _mCache.erase(it); // callers holding the Ptr keep the tree alive
+    }
+}
+//-----------------------------------------------------------------
+void pjson::ArrayIndex::evictAll() {
+    _mCache.clear();
+    _lRecent.clear();
+}
+//-----------------------------------------------------------------
@@ -0,0 +1,498 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#include "pjson.h"
+#include <algorithm>
+using namespace ByteDance;
+
+//-----------------------------------------------------------------
+// JSON Pointer (RFC 6901) token: "~" -> "~0", "/" -> "~1"
+static void _AppendPointerToken(std::string& a_rPath, const std::string& aToken) {
+    a_rPath += '/';
+    for(char c : aToken) {
+        if('~' == c) {
+            a_rPath += "~0";
+        } else if('/' == c) {
+            a_rPath += "~1";
+        } else {
+            a_rPath += c;
+        }
+    }
+}
+//-----------------------------------------------------------------
+static bool _ParsePointer(const std::string& aPointer, std::vector<std::string>& a_rTokens) {
+    a_rTokens.clear();
+    if(aPointer.empty()) {
+        return true; // whole document
+    }
+    if('/' != aPointer[0]) {
+        return false;
+    }
+    for(size_t i = 0; i < aPointer.length(); ++i) {
+        char c = aPointer[i];
+        if('/' == c) {
+            a_rTokens.push_back(std::string());
+        } else if('~' == c) {
+            char cNext = (i + 1 < aPointer.length()) ? aPointer[++i] : '\0';
+            if('0' == cNext) {
+                a_rTokens.back() += '~';
+            } else if('1' == cNext) {
+                a_rTokens.back() += '/';
+            } else {
+                return false;
+            }
+        } else {
+            a_rTokens.back() += c;
+        }
+    }
+    return true;
+}
+//-----------------------------------------------------------------
+static bool _ParseIndex(const std::string& aToken, size_t& a_rIndex) {
+    if(aToken.empty() || (aToken.length() > 1 && '0' == aToken[0]) || aToken.length() > 18) {
+        return false;
+    }
+    size_t iIndex = 0;
+    for(char c : aToken) {
+        if(c < '0' || c > '9') {
+            return false;
+        }
+        iIndex = iIndex * 10 + (c - '0');
+    }
+    a_rIndex = iIndex;
+    return true;
+}
+//-----------------------------------------------------------------
+static pjson& _AddOperation(pjson& a_rPatch, const char* aOp, const std::string& aPath) {
+    pjson& rOperation = a_rPatch[static_cast<int>(a_rPatch.getArray()->size())];
+    rOperation["op"] = aOp;
+    rOperation["path"] = aPath;
+    return rOperation;
+}
+//-----------------------------------------------------------------
+/*static*/
+pjson* pjson::CreatePatch(const pjson& aFrom, const pjson& aTo) {
+    pjson* pPatch = new pjson();
+    pPatch->resetTo(jsonType::jsonArray);
+    std::string sPath;
+    _diff(aFrom, aTo, sPath, *pPatch);
+    return pPatch;
+}
+//-----------------------------------------------------------------
+/*static*/
+void pjson::_diff(const pjson& aFrom, const pjson& aTo, std::string& a_rPath, pjson& a_rPatch) {
+    if(aFrom._eType == aTo._eType && aFrom._pValueRaw == aTo._pValueRaw) {
+        return; // identical subtree, nothing to walk
+    }
+    if(aFrom._eType != aTo._eType
+       || (aFrom._eType != jsonType::jsonArray && aFrom._eType != jsonType::jsonMap)) {
+        if(!_isEqual(aFrom, aTo)) {
+            _AddOperation(a_rPatch, "replace", a_rPath)["value"].copyFrom(aTo);
+        }
+        return;
+    }
+
+    size_t iPathLength = a_rPath.length();
+    if(aFrom._eType == jsonType::jsonMap) {
+        // Both maps are sorted, walk them side by side
+        auto itFrom = aFrom._pValueMap->begin();
+        auto itTo = aTo._pValueMap->begin();
+        while(itFrom != aFrom._pValueMap->end() || itTo != aTo._pValueMap->end()) {
+            int iOrder = 0;
+            if(itFrom == aFrom._pValueMap->end()) {
+                iOrder = 1;
+            } else if(itTo == aTo._pValueMap->end()) {
+                iOrder = -1;
+            } else {
+                iOrder = itFrom->first.compare(itTo->first);
+            }
+
+            if(iOrder < 0) {
+                _AppendPointerToken(a_rPath, itFrom->first);
+                _AddOperation(a_rPatch, "remove", a_rPath);
+                ++itFrom;
+            } else if(iOrder > 0) {
+                _AppendPointerToken(a_rPath, itTo->first);
+                _AddOperation(a_rPatch, "add", a_rPath)["value"].copyFrom(*itTo->second);
+                ++itTo;
+            } else {
+                _AppendPointerToken(a_rPath, itFrom->first);
+                _diff(*itFrom->second, *itTo->second, a_rPath, a_rPatch);
+                ++itFrom;
+                ++itTo;
+            }
+            a_rPath.resize(iPathLength);
+        }
+        return;
+    }
+
+    const PJSONARRAY& rFrom = *aFrom._pValueArray;
+    const PJSONARRAY& rTo = *aTo._pValueArray;
+    size_t iCommon = (rFrom.size() < rTo.size()) ? rFrom.size() : rTo.size();
+    for(size_t i = 0; i < iCommon; ++i) {
+        a_rPath += '/';
+        a_rPath += std::to_string(i);
+        _diff(*rFrom[i], *rTo[i], a_rPath, a_rPatch);
+        a_rPath.resize(iPathLength);
+    }
+    // Remove from the back so earlier indices stay valid
+    for(size_t i = rFrom.size(); i > iCommon; --i) {
+        a_rPath += '/';
+        a_rPath += std::to_string(i - 1);
+        _AddOperation(a_rPatch, "remove", a_rPath);
+        a_rPath.resize(iPathLength);
+    }
+    for(size_t i = iCommon; i < rTo.size(); ++i) {
+        a_rPath += '/';
+        a_rPath += std::to_string(i);
+        _AddOperation(a_rPatch, "add", a_rPath)["value"].copyFrom(*rTo[i]);
+        a_rPath.resize(iPathLength);
+    }
+}
+//-----------------------------------------------------------------
+/*static*/
+pjson* pjson::CreateMergePatch(const pjson& aFrom, const pjson& aTo) {
+    pjson* pPatch = new pjson();
+    if(!_mergeDiff(aFrom, aTo, *pPatch)) {
+        pPatch->resetTo(jsonType::jsonMap); // {} : no change
+    }
+    return pPatch;
+}
+//-----------------------------------------------------------------
+// Returns false when there is no difference. Note a merge patch cannot
+// express "set to null": null always means "remove the key".
+/*static*/
+bool pjson::_mergeDiff(const pjson& aFrom, const pjson& aTo, pjson& a_rPatch) {
+    if(aFrom._eType == aTo._eType && aFrom._pValueRaw == aTo._pValueRaw) {
+        return false;
+    }
+    if(aFrom._eType != jsonType::jsonMap || aTo._eType != jsonType::jsonMap) {
+        if(_isEqual(aFrom, aTo)) {
+            return false;
+        }
+        a_rPatch.copyFrom(aTo);
+        return true;
+    }
+
+    a_rPatch.resetTo(jsonType::jsonMap);
+    PJSONMAP& rPatch = *a_rPatch._pValueMap;
+    auto itFrom = aFrom._pValueMap->begin();
+    auto itTo = aTo._pValueMap->begin();
+    while(itFrom != aFrom._pValueMap->end() || itTo != aTo._pValueMap->end()) {
+        int iOrder = 0;
+        if(itFrom == aFrom._pValueMap->end()) {
+            iOrder = 1;
+        } else if(itTo == aTo._pValueMap->end()) {
+            iOrder = -1;
+        } else {
+            iOrder = itFrom->first.compare(itTo->first);
+        }
+
+        if(iOrder < 0) {
+            rPatch.emplace_hint(rPatch.end(), itFrom->first, new pjson()); // null removes
+            ++itFrom;
+        } else if(iOrder > 0) {
+            pjson* pValue = new pjson();
+            pValue->copyFrom(*itTo->second);
+            rPatch.emplace_hint(rPatch.end(), itTo->first, pValue);
+            ++itTo;
+        } else {
+            pjson* pValue = new pjson();
+            if(_mergeDiff(*itFrom->second, *itTo->second, *pValue)) {
+                rPatch.emplace_hint(rPatch.end(), itTo->first, pValue);
+            } else {
+                delete pValue;
+            }
+            ++itFrom;
+            ++itTo;
+        }
+    }
+    return !rPatch.empty();
+}
+//-----------------------------------------------------------------
+void pjson::applyMergePatch(const pjson& aPatch) {
+    if(aPatch._eType != jsonType::jsonMap) {
+        copyFrom(aPatch);
+        return;
+    }
+    _resetIfneeded(jsonType::jsonMap);
+    for(auto const& it : *aPatch._pValueMap) {
+        if(it.second->_eType == jsonType::jsonNull) {
+            PJSONMAP::iterator itFound = _pValueMap->find(it.first);
+            if(itFound != _pValueMap->end()) {
+                delete itFound->second;
+                _pValueMap->erase(itFound);
+            }
+        } else {
+            at(it.first).applyMergePatch(*it.second);
+        }
+    }
+}
+//-----------------------------------------------------------------
+// One step that reverts a change made by applyPatch(): the inverse operation
+// on the same path, with the value the change took out
+struct pjson::PatchUndo {
+    enum Kind { Add, Remove, Replace };
+    PatchUndo(Kind aeKind, const std::vector<std::string>& aPath) : eKind(aeKind), vPath(aPath) {}
+
+    Kind eKind;
+    std::vector<std::string> vPath;
+    pjson oValue;
+    bool bCarried = false; // Add what undoing the next step took out (a move's source)
+};
+//-----------------------------------------------------------------
+bool pjson::applyPatch(const pjson& aPatch) {
+    if(aPatch._eType != jsonType::jsonArray) {
+        return false;
+    }
+    // A failed patch is undone step by step, so no copy of the document is taken.
+    // An operation records at most two steps (move), so the log never reallocates.
+    std::vector<PatchUndo> vUndo;
+    vUndo.reserve(2 * aPatch._pValueArray->size());
+    for(const pjson* pOperation : *aPatch._pValueArray) {
+        if(!_applyPatchOperation(*pOperation, vUndo)) {
+            _undoPatch(vUndo);
+            return false;
+        }
+    }
+    return true;
+}
+//-----------------------------------------------------------------
+void pjson::_undoPatch(std::vector<PatchUndo>& a_rUndo) {
+    pjson oCarried; // taken out by the last Remove / Replace step
+    for(auto it = a_rUndo.rbegin(); it != a_rUndo.rend(); ++it) {
+        switch(it->eKind) {
+            case PatchUndo::Add: {
+                _patchAdd(it->vPath, it->bCarried ? oCarried : it->oValue, nullptr);
+                break;
+            }
+            case PatchUndo::Remove: {
+                _patchRemove(it->vPath, oCarried);
+                break;
+            }
+            case PatchUndo::Replace: {
+                pjson* pTarget = _resolvePointer(it->vPath, it->vPath.size(), true);
+                oCarried = std::move(*pTarget);
+                *pTarget = std::move(it->oValue);
+                break;
+            }
+        }
+    }
+}
+//-----------------------------------------------------------------
+pjson* pjson::_resolvePointer(const std::vector<std::string>& aTokens, size_t a_iCount, bool bMutable) {
+    pjson* pNode = this;
+    for(size_t i = 0; i < a_iCount; ++i) {
+        if(bMutable) {
+            pNode->_detach();
+        }
+        if(pNode->_eType == jsonType::jsonMap) {
+            PJSONMAP::iterator it = pNode->_pValueMap->find(aTokens[i]);
+            if(it == pNode->_pValueMap->end()) {
+                return nullptr;
+            }
+            pNode = it->second;
+        } else if(pNode->_eType == jsonType::jsonArray) {
+            size_t iIndex = 0;
+            if(!_ParseIndex(aTokens[i], iIndex) || iIndex >= pNode->_pValueArray->size()) {
+                return nullptr;
+            }
+            pNode = (*pNode->_pValueArray)[iIndex];
+        } else {
+            return nullptr;
+        }
+    }
+    if(bMutable) {
+        pNode->_detach();
+    }
+    return pNode;
+}
+//-----------------------------------------------------------------
+// Takes the value at aPath out of its parent into a_rTaken
+bool pjson::_patchRemove(const std::vector<std::string>& aPath, pjson& a_rTaken) {
+    if(aPath.empty()) {
+        return false;
+    }
+    pjson* pParent = _resolvePointer(aPath, aPath.size() - 1, true);
+    if(!pParent) {
+        return false;
+    }
+    const std::string& sLast = aPath.back();
+    if(pParent->_eType == jsonType::jsonMap) {
+        PJSONMAP::iterator it = pParent->_pValueMap->find(sLast);
+        if(it == pParent->_pValueMap->end()) {
+            return false;
+        }
+        a_rTaken = std::move(*it->second);
+        delete it->second;
+        pParent->_pValueMap->erase(it);
+        return true;
+    }
+    size_t iIndex = 0;
+    if(pParent->_eType != jsonType::jsonArray
+       || !_ParseIndex(sLast, iIndex) || iIndex >= pParent->_pValueArray->size()) {
+        return false;
+    }
+    a_rTaken = std::move(*(*pParent->_pValueArray)[iIndex]);
+    delete (*pParent->_pValueArray)[iIndex];
+    pParent->_pValueArray->erase(pParent->_pValueArray->begin() + iIndex);
+    return true;
+}
+//-----------------------------------------------------------------
+// JSON Patch "add" of a_rValue; a_rValue is left untouched when it fails.
+// The step that reverts it goes to a_pUndo, if given.
+bool pjson::_patchAdd(const std::vector<std::string>& aPath, pjson& a_rValue, std::vector<PatchUndo>* a_pUndo) {
+    if(aPath.empty()) {
+        if(a_pUndo) {
+            a_pUndo->emplace_back(PatchUndo::Replace, aPath);
+            a_pUndo->back().oValue = std::move(*this);
+        }
+        *this = std::move(a_rValue);
+        return true;
+    }
+    pjson* pParent = _resolvePointer(aPath, aPath.size() - 1, true);
+    if(!pParent) {
+        return false;
+    }
+    const std::string& sLast = aPath.back();
+    if(pParent->_eType == jsonType::jsonMap) {
+        PJSONMAP::iterator it = pParent->_pValueMap->find(sLast);
+        if(it != pParent->_pValueMap->end()) {
+            if(a_pUndo) {
+                a_pUndo->emplace_back(PatchUndo::Replace, aPath);
+                a_pUndo->back().oValue = std::move(*it->second);
+            }
+            *it->second = std::move(a_rValue);
+        } else {
+            pParent->_pValueMap->emplace(sLast, new pjson(std::move(a_rValue)));
+            if(a_pUndo) {
+                a_pUndo->emplace_back(PatchUndo::Remove, aPath);
+            }
+        }
+        return true;
+    }
+    if(pParent->_eType != jsonType::jsonArray) {
+        return false;
+    }
+    size_t iIndex = pParent->_pValueArray->size();
+    if("-" != sLast && (!_ParseIndex(sLast, iIndex) || iIndex > pParent->_pValueArray->size())) {
+        return false;
+    }
+    pParent->_pValueArray->insert(pParent->_pValueArray->begin() + iIndex, new pjson(std::move(a_rValue)));
+    if(a_pUndo) {
+        a_pUndo->emplace_back(PatchUndo::Remove, aPath);
+        a_pUndo->back().vPath.back() = std::to_string(iIndex); // "-" appended here
+    }
+    return true;
+}
+//-----------------------------------------------------------------
+bool pjson::_applyPatchOperation(const pjson& aOperation, std::vector<PatchUndo>& a_rUndo) {
+    if(aOperation._eType != jsonType::jsonMap) {
+        return false;
+    }
+    auto fnMember = [&aOperation](const char* aKey) -> const pjson* {
+        PJSONMAP::const_iterator it = aOperation._pValueMap->find(aKey);
+        return (it != aOperation._pValueMap->end()) ? it->second : nullptr;
+    };
+    auto fnPointer = [&fnMember](const char* aKey, std::vector<std::string>& a_rTokens) -> bool {
+        const pjson* pPointer = fnMember(aKey);
+        return pPointer && pPointer->_eType == jsonType::jsonString
+               && _ParsePointer(*pPointer->_pValueString, a_rTokens);
+    };
+
+    const pjson* pOp = fnMember("op");
+    std::vector<std::string> vPath;
+    if(!pOp || pOp->_eType != jsonType::jsonString || !fnPointer("path", vPath)) {
+        return false;
+    }
+    const std::string& sOp = *pOp->_pValueString;
+
+    if("test" == sOp) {
+        const pjson* pValue = fnMember("value");
+        const pjson* pTarget = _resolvePointer(vPath, vPath.size(), false);
+        return pValue && pTarget && _isEqual(*pTarget, *pValue);
+    }
+
+    pjson oValue;
+    if("remove" == sOp) {
+        if(!_patchRemove(vPath, oValue)) {
+            return false;
+        }
+        a_rUndo.emplace_back(PatchUndo::Add, vPath);
+        a_rUndo.back().oValue = std::move(oValue);
+        return true;
+    }
+
+    // add / replace / copy / move : work out the new value first
+    bool bMove = ("move" == sOp);
+    if("add" == sOp || "replace" == sOp) {
+        const pjson* pValue = fnMember("value");
+        if(!pValue) {
+            return false;
+        }
+        oValue.copyFrom(*pValue);
+    } else if("copy" == sOp || bMove) {
+        std::vector<std::string> vFrom;
+        if(!fnPointer("from", vFrom)) {
+            return false;
+        }
+        if(bMove) {
+            if(vFrom == vPath) {
+                return nullptr != _resolvePointer(vFrom, vFrom.size(), false);
+            }
+            if(vFrom.size() < vPath.size() && std::equal(vFrom.begin(), vFrom.end(), vPath.begin())) {
+                return false; // cannot move a value into its own child
+            }
+            if(!_patchRemove(vFrom, oValue)) {
+                return false;
+            }
+            // Put back whatever undoing the add below takes out of vPath
+            a_rUndo.emplace_back(PatchUndo::Add, vFrom);
+            a_rUndo.back().bCarried = true;
+        } else {
+            const pjson* pSource = _resolvePointer(vFrom, vFrom.size(), false);
+            if(!pSource) {
+                return false;
+            }
+            oValue.copyFrom(*pSource);
+        }
+    } else {
+        return false;
+    }
+
+    if("replace" == sOp) {
+        pjson* pTarget = _resolvePointer(vPath, vPath.size(), true);
+        if(!pTarget) {
+            return false;
+        }
+        a_rUndo.emplace_back(PatchUndo::Replace, vPath);
+        a_rUndo.back().oValue = std::move(*pTarget);
+        *pTarget = std::move(oValue);
+        return true;
+    }
+
+    if(!_patchAdd(vPath, oValue, &a_rUndo)) {
+        if(bMove) {
+            a_rUndo.back().oValue = std::move(oValue); // the source goes back as it was
+            a_rUndo.back().bCarried = false;
+        }
+        return false;
+    }
+    return true;
+}
+//-----------------------------------------------------------------
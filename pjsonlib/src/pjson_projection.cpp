@@ -0,0 +1,228 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#include "pjson_projection.h"
+#include <cstring>
+using namespace ByteDance;
+
+namespace {
+    // One parsed path step
+    struct _Step {
+        enum Kind { stepKey, stepAnyKey, stepIndex, stepAnyIndex };
+        Kind eKind;
+        std::string sKey;
+        size_t iIndex;
+    };
+}
+//-----------------------------------------------------------------
+// "a.b[*].c", "[2].x", "*.id"; false on empty keys or bad brackets
+static bool _ParsePath(const std::string& aPath, std::vector<_Step>& a_rSteps) {
+    size_t i = 0;
+    const size_t iSize = aPath.size();
+    while(i < iSize) {
+        _Step oStep;
+        if('[' == aPath[i]) {
+            size_t iClose = aPath.find(']', i);
+            if(std::string::npos == iClose || iClose == i + 1) {
+                return false;
+            }
+            if("*" == aPath.substr(i + 1, iClose - i - 1)) {
+                oStep.eKind = _Step::stepAnyIndex;
+            } else {
+                oStep.eKind = _Step::stepIndex;
+                oStep.iIndex = 0;
+                for(size_t j = i + 1; j < iClose; ++j) {
+                    if(aPath[j] < '0' || aPath[j] > '9') {
+                        return false;
+                    }
+                    oStep.iIndex = oStep.iIndex * 10 + (aPath[j] - '0');
+                }
+            }
+            i = iClose + 1;
+        } else {
+            size_t iEnd = aPath.find_first_of(".[", i);
+            if(std::string::npos == iEnd) {
+                iEnd = iSize;
+            }
+            if(iEnd == i) {
+                return false; // "a..b" or ".a"
+            }
+            oStep.sKey = aPath.substr(i, iEnd - i);
+            oStep.eKind = ("*" == oStep.sKey) ? _Step::stepAnyKey : _Step::stepKey;
+            i = iEnd;
+        }
+        a_rSteps.push_back(oStep);
+        if(i < iSize && '.' == aPath[i]) {
+            ++i;
+            if(i == iSize || '[' == aPath[i]) {
+                return false; // "a." or "a.[0]"
+            }
+        } else if(i < iSize && '[' != aPath[i]) {
+            return false; // "[0]x"
+        }
+    }
+    return true;
+}
+//-----------------------------------------------------------------
+const pjson::ProjectionNode* pjson::ProjectionNode::key(const char* aKey, size_t a_iLength) const {
+    for(auto const& it : vKeys) {
+        if(it.first.length() == a_iLength && 0 == memcmp(it.first.data(), aKey, a_iLength)) {
+            return it.second;
+        }
+    }
+    return pAnyKey;
+}
+//-----------------------------------------------------------------
+const pjson::ProjectionNode* pjson::ProjectionNode::index(size_t a_iIndex) const {
+    for(auto const& it : vIndices) {
+        if(it.first == a_iIndex) {
+            return it.second;
+        }
+    }
+    return pAnyIndex;
+}
+//-----------------------------------------------------------------
+pjson::Projection::Projection() {
+    _newNode(); // root
+}
+//-----------------------------------------------------------------
+pjson::Projection::Projection(std::initializer_list<const char*> aPaths) {
+    _newNode();
+    for(const char* aPath : aPaths) {
+        add(aPath);
+    }
+}
+//-----------------------------------------------------------------
+pjson::Projection::Projection(const std::vector<std::string>& aPaths) {
+    _newNode();
+    for(const std::string& sPath : aPaths) {
+        add(sPath);
+    }
+}
+//-----------------------------------------------------------------
+pjson::Projection::Projection(const Projection& aFrom) {
+    _newNode();
+    for(const std::string& sPath : aFrom._vPaths) {
+        add(sPath);
+    }
+}
+//-----------------------------------------------------------------
+pjson::Projection& pjson::Projection::operator=(const Projection& aFrom) {
+    if(&aFrom != this) {
+        clear();
+        for(const std::string& sPath : aFrom._vPaths) {
+            add(sPath);
+        }
+    }
+    return *this;
+}
+//-----------------------------------------------------------------
+pjson::ProjectionNode* pjson::Projection::_newNode() {
+    _vNodes.emplace_back();
+    return &_vNodes.back();
+}
+//-----------------------------------------------------------------
+pjson::ProjectionNode* pjson::Projection::_clone(const ProjectionNode* aNode) {
+    ProjectionNode* pCopy = _newNode();
+    pCopy->bKeepAll = aNode->bKeepAll;
+    for(auto const& it : aNode->vKeys) {
+        pCopy->vKeys.emplace_back(it.first, _clone(it.second));
+    }
+    for(auto const& it : aNode->vIndices) {
+        pCopy->vIndices.emplace_back(it.first, _clone(it.second));
+    }
+    pCopy->pAnyKey = aNode->pAnyKey ? _clone(aNode->pAnyKey) : nullptr;
+    pCopy->pAnyIndex = aNode->pAnyIndex ? _clone(aNode->pAnyIndex) : nullptr;
+    return pCopy;
+}
+//-----------------------------------------------------------------
+bool pjson::Projection::add(const std::string& aPath) {
+    std::vector<_Step> vSteps;
+    if(!_ParsePath(aPath, vSteps)) {
+        return false;
+    }
+    _vPaths.push_back(aPath);
+    // Walk every node the path reaches: a wildcard step also continues
+    // into the named siblings, and a new named child starts as a copy of
+    // the wildcard, so a named child always covers the wildcard paths.
+    std::vector<ProjectionNode*> vCurrent(1, &_vNodes.front());
+    for(const _Step& rStep : vSteps) {
+        std::vector<ProjectionNode*> vNext;
+        for(ProjectionNode* pNode : vCurrent) {
+            if(pNode->bKeepAll) {
+                continue; // already keeps everything below
+            }
+            switch(rStep.eKind) {
+                case _Step::stepKey: {
+                    ProjectionNode* pChild = const_cast<ProjectionNode*>(pNode->key(rStep.sKey.data(), rStep.sKey.length()));
+                    if(nullptr == pChild || pChild == pNode->pAnyKey) {
+                        pChild = pNode->pAnyKey ? _clone(pNode->pAnyKey) : _newNode();
+                        pNode->vKeys.emplace_back(rStep.sKey, pChild);
+                    }
+                    vNext.push_back(pChild);
+                    break;
+                }
+                case _Step::stepIndex: {
+                    ProjectionNode* pChild = const_cast<ProjectionNode*>(pNode->index(rStep.iIndex));
+                    if(nullptr == pChild || pChild == pNode->pAnyIndex) {
+                        pChild = pNode->pAnyIndex ? _clone(pNode->pAnyIndex) : _newNode();
+                        pNode->vIndices.emplace_back(rStep.iIndex, pChild);
+                    }
+                    vNext.push_back(pChild);
+                    break;
+                }
+                case _Step::stepAnyKey: {
+                    if(nullptr == pNode->pAnyKey) {
+                        pNode->pAnyKey = _newNode();
+                    }
+                    vNext.push_back(pNode->pAnyKey);
+                    for(auto const& it : pNode->vKeys) {
+                        vNext.push_back(it.second);
+                    }
+                    break;
+                }
+                case _Step::stepAnyIndex: {
+                    if(nullptr == pNode->pAnyIndex) {
+                        pNode->pAnyIndex = _newNode();
+                    }
+                    vNext.push_back(pNode->pAnyIndex);
+                    for(auto const& it : pNode->vIndices) {
+                        vNext.push_back(it.second);
+                    }
+                    break;
+                }
+            }
+        }
+        vCurrent.swap(vNext);
+    }
+    for(ProjectionNode* pNode : vCurrent) {
+        pNode->bKeepAll = true;
+    }
+    return true;
+}
+//-----------------------------------------------------------------
+void pjson::Projection::clear() {
+    _vNodes.clear();
+    _vPaths.clear();
+    _newNode();
+}
+//-----------------------------------------------------------------
+size_t pjson::Projection::size() const {
+    return _vPaths.size();
+}
+//-----------------------------------------------------------------
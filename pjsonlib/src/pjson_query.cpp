@@ -0,0 +1,1919 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#include "pjson_query.h"
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <deque>
+#include <memory>
+#include <unordered_map>
+using namespace ByteDance;
+
+//==[Compiled form]========================================================
+struct _QueryExpr;
+class _QueryRegex;
+
+struct _QuerySelector {
+    enum Kind { selName, selWildcard, selIndex, selSlice, selFilter };
+    Kind eKind = selName;
+    std::string sName;        // escaped the way keys are stored
+    int64_t iIndex = 0;       // also the slice start
+    int64_t iEnd = 0;
+    int64_t iStep = 1;
+    bool bHasStart = false;
+    bool bHasEnd = false;
+    const _QueryExpr* pFilter = nullptr;
+};
+
+struct _QuerySegment {
+    bool bDescendant = false; // ..
+    std::vector<_QuerySelector> vSelectors;
+};
+
+struct _QueryPath {
+    bool bRelative = false; // @ rather than $
+    std::vector<_QuerySegment> vSegments;
+
+    // At most one result: only single names and indices
+    bool isSingular() const {
+        for(const _QuerySegment& rSegment : vSegments) {
+            if(rSegment.bDescendant || 1 != rSegment.vSelectors.size()) {
+                return false;
+            }
+            _QuerySelector::Kind eKind = rSegment.vSelectors[0].eKind;
+            if(_QuerySelector::selName != eKind && _QuerySelector::selIndex != eKind) {
+                return false;
+            }
+        }
+        return true;
+    }
+};
+
+struct _QueryExpr {
+    enum Kind { exprOr, exprAnd, exprNot, exprCompare, exprExists, exprLiteral, exprPath, exprFunction };
+    enum Op { opEq, opNe, opLt, opLe, opGt, opGe };
+    enum Function { fnLength, fnCount, fnMatch, fnSearch, fnValue };
+    enum Literal { litNull, litBool, litNumber, litString };
+    Kind eKind = exprLiteral;
+    Op eOp = opEq;
+    Function eFunction = fnLength;
+    Literal eLiteral = litNull;
+    bool bValue = false;
+    double dValue = 0.0;
+    std::string sValue; // decoded
+    _QueryPath oPath;   // exprExists, exprPath
+    std::vector<const _QueryExpr*> vArgs;
+    std::shared_ptr<const _QueryRegex> pRegex; // match() / search() with a literal pattern
+    bool bBadRegex = false;
+
+    bool returnsLogical() const { return exprFunction != eKind || fnMatch == eFunction || fnSearch == eFunction; }
+};
+
+struct pjson::Query::Program {
+    _QueryPath oPath;
+    std::deque<_QueryExpr> vExprs; // a deque keeps the pointers in vArgs / pFilter stable
+};
+
+//-----------------------------------------------------------------
+static void _AppendUtf8(std::string& a_rOut, uint32_t a_iCode) {
+    if(a_iCode < 0x80) {
+        a_rOut += static_cast<char>(a_iCode);
+    } else if(a_iCode < 0x800) {
+        a_rOut += static_cast<char>(0xC0 | (a_iCode >> 6));
+        a_rOut += static_cast<char>(0x80 | (a_iCode & 0x3F));
+    } else if(a_iCode < 0x10000) {
+        a_rOut += static_cast<char>(0xE0 | (a_iCode >> 12));
+        a_rOut += static_cast<char>(0x80 | ((a_iCode >> 6) & 0x3F));
+        a_rOut += static_cast<char>(0x80 | (a_iCode & 0x3F));
+    } else {
+        a_rOut += static_cast<char>(0xF0 | (a_iCode >> 18));
+        a_rOut += static_cast<char>(0x80 | ((a_iCode >> 12) & 0x3F));
+        a_rOut += static_cast<char>(0x80 | ((a_iCode >> 6) & 0x3F));
+        a_rOut += static_cast<char>(0x80 | (a_iCode & 0x3F));
+    }
+}
+//-----------------------------------------------------------------
+static bool _ReadHex4(const char* aSrc, size_t a_iLength, size_t a_iAt, uint32_t& a_rCode) {
+    if(a_iAt + 4 > a_iLength) {
+        return false;
+    }
+    a_rCode = 0;
+    for(size_t i = a_iAt; i < a_iAt + 4; ++i) {
+        char c = aSrc[i];
+        uint32_t iDigit = ('0' <= c && '9' >= c) ? (c - '0') : ('a' <= c && 'f' >= c) ? (c - 'a' + 10)
+                        : ('A' <= c && 'F' >= c) ? (c - 'A' + 10) : 16;
+        if(16 == iDigit) {
+            return false;
+        }
+        a_rCode = (a_rCode << 4) | iDigit;
+    }
+    return true;
+}
+//-----------------------------------------------------------------
+// Decodes JSON string escapes (\uXXXX to UTF-8); malformed escapes are kept as written
+static void _Unescape(const char* aSrc, size_t a_iLength, std::string& a_rOut) {
+    a_rOut.clear();
+    a_rOut.reserve(a_iLength);
+    for(size_t i = 0; i < a_iLength; ++i) {
+        char c = aSrc[i];
+        if('\\' != c || i + 1 >= a_iLength) {
+            a_rOut += c;
+            continue;
+        }
+        char e = aSrc[++i];
+        switch(e) {
+            case 'b': { a_rOut += '\b'; break; }
+            case 'f': { a_rOut += '\f'; break; }
+            case 'n': { a_rOut += '\n'; break; }
+            case 'r': { a_rOut += '\r'; break; }
+            case 't': { a_rOut += '\t'; break; }
+            case 'u': {
+                uint32_t iCode = 0;
+                if(!_ReadHex4(aSrc, a_iLength, i + 1, iCode)) {
+                    a_rOut += "\\u";
+                    break;
+                }
+                i += 4;
+                uint32_t iLow = 0;
+                if(iCode >= 0xD800 && iCode <= 0xDBFF && i + 2 < a_iLength && '\\' == aSrc[i + 1] && 'u' == aSrc[i + 2]
+                   && _ReadHex4(aSrc, a_iLength, i + 3, iLow) && iLow >= 0xDC00 && iLow <= 0xDFFF) {
+                    iCode = 0x10000 + ((iCode - 0xD800) << 10) + (iLow - 0xDC00);
+                    i += 6;
+                }
+                _AppendUtf8(a_rOut, iCode);
+                break;
+            }
+            default: { a_rOut += e; break; } // \" \\ \/
+        }
+    }
+}
+//-----------------------------------------------------------------
+// The escaped form keys are compared in: only what JSON requires is escaped
+static std::string _EscapeName(const std::string& aName) {
+    std::string sOut;
+    for(char c : aName) {
+        switch(c) {
+            case '\"': { sOut += "\\\""; break; }
+            case '\\': { sOut += "\\\\"; break; }
+            case '\b': { sOut += "\\b"; break; }
+            case '\f': { sOut += "\\f"; break; }
+            case '\n': { sOut += "\\n"; break; }
+            case '\r': { sOut += "\\r"; break; }
+            case '\t': { sOut += "\\t"; break; }
+            default: {
+                if(static_cast<unsigned char>(c) < 0x20) {
+                    char aBuffer[8];
+                    snprintf(aBuffer, sizeof(aBuffer), "\\u%04x", static_cast<unsigned char>(c));
+                    sOut += aBuffer;
+                } else {
+                    sOut += c;
+                }
+                break;
+            }
+        }
+    }
+    return sOut;
+}
+//-----------------------------------------------------------------
+// Trees hold non-raw floats in single precision: widen through the shortest
+// decimal that reads back as the same float, so 8.95 still equals 8.95
+static double _WidenFloat(float a_fValue) {
+    char aBuffer[32];
+    for(int iDigits = 6; iDigits <= 9; ++iDigits) {
+        snprintf(aBuffer, sizeof(aBuffer), "%.*g", iDigits, a_fValue);
+        double dValue = strtod(aBuffer, nullptr);
+        if(static_cast<float>(dValue) == a_fValue) {
+            return dValue;
+        }
+    }
+    return a_fValue;
+}
+//-----------------------------------------------------------------
+static size_t _CodePoints(const std::string& aText) {
+    size_t iCount = 0;
+    for(char c : aText) {
+        iCount += (0x80 != (static_cast<unsigned char>(c) & 0xC0)) ? 1 : 0;
+    }
+    return iCount;
+}
+//-----------------------------------------------------------------
+// The code point at a_rAt, which moves past it; a stray byte stands for itself
+static uint32_t _NextCodePoint(const std::string& aText, size_t& a_rAt) {
+    const unsigned char c = static_cast<unsigned char>(aText[a_rAt++]);
+    size_t iMore = (0xF0 == (c & 0xF8)) ? 3 : (0xE0 == (c & 0xF0)) ? 2 : (0xC0 == (c & 0xE0)) ? 1 : 0;
+    if(0 == iMore || a_rAt + iMore > aText.size()) {
+        return c;
+    }
+    uint32_t iCode = c & (0x3F >> iMore);
+    for(size_t i = 0; i < iMore; ++i) {
+        iCode = (iCode << 6) | (static_cast<unsigned char>(aText[a_rAt++]) & 0x3F);
+    }
+    return iCode;
+}
+
+//==[I-Regexp]=============================================================
+// RFC 9485 patterns for match() and search(), compiled to a Thompson NFA.
+// Matching keeps the set of live states and steps it once per code point,
+// so it takes time linear in the text, never backtracks and never recurses.
+// Unicode category escapes (\p{..}, \P{..}) are not supported and make the
+// pattern invalid.
+class _QueryRegex {
+public:
+    // Scratch space for matches, reused by one thread
+    struct Threads {
+        std::vector<uint32_t> vCurrent;
+        std::vector<uint32_t> vNext;
+        std::vector<uint32_t> vStack;
+        std::vector<size_t> vSeen; // step each state was last added in
+        size_t iStep = 0;
+    };
+
+    bool compile(const std::string& aPattern);
+    // The whole text (match()) or any substring of it (search())
+    bool matches(const std::string& aText, bool a_bWhole, Threads& a_rThreads) const;
+
+private:
+    static const uint32_t kUnbounded = 0xFFFFFFFF;
+    static const size_t kMaxStates = 1 << 16; // {m,n} repeats are expanded
+
+    struct Class {
+        std::vector<std::pair<uint32_t, uint32_t> > vRanges;
+        bool bNegated = false;
+
+        bool has(uint32_t a_iCode) const {
+            for(const std::pair<uint32_t, uint32_t>& rRange : vRanges) {
+                if(a_iCode >= rRange.first && a_iCode <= rRange.second) {
+                    return !bNegated;
+                }
+            }
+            return bNegated;
+        }
+    };
+    // The pattern as parsed; an empty nodeConcat matches the empty string
+    struct Node {
+        enum Kind { nodeClass, nodeConcat, nodeAlternate, nodeRepeat };
+        Kind eKind = nodeConcat;
+        size_t iClass = 0;
+        uint32_t iMin = 0;
+        uint32_t iMax = 0;
+        std::vector<size_t> vChildren;
+    };
+    struct State {
+        enum Op { opClass, opSplit, opJump, opMatch };
+        Op eOp;
+        uint32_t iNext;
+        uint32_t iAlt;   // opSplit: the other way
+        size_t iClass;   // opClass
+    };
+
+    bool _alternation(size_t& a_rNode, size_t a_iDepth);
+    bool _branch(size_t& a_rNode, size_t a_iDepth);
+    bool _atom(size_t& a_rNode, size_t a_iDepth);
+    bool _quantifier(size_t& a_rNode);
+    bool _number(uint32_t& a_rValue);
+    bool _classExpression(Class& a_rClass);
+    bool _escape(uint32_t& a_rCode);
+    size_t _newNode(Node::Kind aeKind);
+    size_t _newClass(uint32_t a_iLow, uint32_t a_iHigh, bool a_bNegated);
+    bool _emit(size_t a_iNode);
+    uint32_t _push(State::Op aeOp);
+    void _add(uint32_t a_iState, std::vector<uint32_t>& a_rList, Threads& a_rThreads) const;
+
+    bool _more() const { return _i < _vPattern.size(); }
+    uint32_t _peek() const { return _more() ? _vPattern[_i] : 0; }
+
+private:
+    // while compiling
+    std::vector<uint32_t> _vPattern;
+    size_t _i = 0;
+    std::vector<Node> _vNodes;
+    size_t _iEmitted = 0; // _emit() calls; repeated empty groups add no states
+    // compiled
+    std::vector<Class> _vClasses;
+    std::vector<State> _vStates;
+};
+//-----------------------------------------------------------------
+bool _QueryRegex::compile(const std::string& aPattern) {
+    for(size_t i = 0; i < aPattern.size();) {
+        _vPattern.push_back(_NextCodePoint(aPattern, i));
+    }
+    size_t iRoot = 0;
+    bool bValid = _alternation(iRoot, 0) && !_more() && _emit(iRoot);
+    if(bValid) {
+        _push(State::opMatch);
+    }
+    _vPattern.clear();
+    _vPattern.shrink_to_fit();
+    _vNodes.clear();
+    _vNodes.shrink_to_fit();
+    return bValid;
+}
+//-----------------------------------------------------------------
+bool _QueryRegex::_alternation(size_t& a_rNode, size_t a_iDepth) {
+    if(a_iDepth > pjson::GetMaxParseDepth()) {
+        return false;
+    }
+    size_t iBranch = 0;
+    if(!_branch(iBranch, a_iDepth)) {
+        return false;
+    }
+    if('|' != _peek()) {
+        a_rNode = iBranch;
+        return true;
+    }
+    a_rNode = _newNode(Node::nodeAlternate);
+    _vNodes[a_rNode].vChildren.push_back(iBranch);
+    while('|' == _peek()) {
+        ++_i;
+        if(!_branch(iBranch, a_iDepth)) {
+            return false;
+        }
+        _vNodes[a_rNode].vChildren.push_back(iBranch);
+    }
+    return true;
+}
+//-----------------------------------------------------------------
+bool _QueryRegex::_branch(size_t& a_rNode, size_t a_iDepth) {
+    a_rNode = _newNode(Node::nodeConcat);
+    while(_more() && '|' != _peek() && ')' != _peek()) {
+        size_t iPiece = 0;
+        if(!_atom(iPiece, a_iDepth) || !_quantifier(iPiece)) {
+            return false;
+        }
+        _vNodes[a_rNode].vChildren.push_back(iPiece);
+    }
+    return true;
+}
+//-----------------------------------------------------------------
+bool _QueryRegex::_atom(size_t& a_rNode, size_t a_iDepth) {
+    uint32_t c = _vPattern[_i++];
+    switch(c) {
+        case '(': {
+            if(!_alternation(a_rNode, a_iDepth + 1) || ')' != _peek()) {
+                return false;
+            }
+            ++_i;
+            return true;
+        }
+        case '[': {
+            Class oClass;
+            if(!_classExpression(oClass)) {
+                return false;
+            }
+            a_rNode = _newNode(Node::nodeClass);
+            _vNodes[a_rNode].iClass = _vClasses.size();
+            _vClasses.push_back(oClass);
+            return true;
+        }
+        case '.': {
+            // any character but a line break
+            a_rNode = _newNode(Node::nodeClass);
+            _vNodes[a_rNode].iClass = _newClass('\n', '\n', true);
+            _vClasses.back().vRanges.push_back(std::make_pair(uint32_t('\r'), uint32_t('\r')));
+            return true;
+        }
+        case '\\': {
+            if(!_escape(c)) {
+                return false;
+            }
+            break;
+        }
+        case ')': case '*': case '+': case '?': case '{': case '}': case ']': {
+            return false;
+        }
+        default: {
+            break;
+        }
+    }
+    a_rNode = _newNode(Node::nodeClass);
+    _vNodes[a_rNode].iClass = _newClass(c, c, false);
+    return true;
+}
+//-----------------------------------------------------------------
+bool _QueryRegex::_quantifier(size_t& a_rNode) {
+    uint32_t iMin = 0;
+    uint32_t iMax = 0;
+    switch(_peek()) {
+        case '*': { ++_i; iMin = 0; iMax = kUnbounded; break; }
+        case '+': { ++_i; iMin = 1; iMax = kUnbounded; break; }
+        case '?': { ++_i; iMin = 0; iMax = 1; break; }
+        case '{': {
+            ++_i;
+            if(!_number(iMin)) {
+                return false;
+            }
+            iMax = iMin;
+            if(',' == _peek()) {
+                ++_i;
+                iMax = kUnbounded;
+                if('}' != _peek() && (!_number(iMax) || iMax < iMin)) {
+                    return false;
+                }
+            }
+            if('}' != _peek()) {
+                return false;
+            }
+            ++_i;
+            break;
+        }
+        default: {
+            return true;
+        }
+    }
+    size_t iRepeat = _newNode(Node::nodeRepeat);
+    _vNodes[iRepeat].iMin = iMin;
+    _vNodes[iRepeat].iMax = iMax;
+    _vNodes[iRepeat].vChildren.push_back(a_rNode);
+    a_rNode = iRepeat;
+    return true;
+}
+//-----------------------------------------------------------------
+bool _QueryRegex::_number(uint32_t& a_rValue) {
+    if(_peek() < '0' || _peek() > '9') {
+        return false;
+    }
+    a_rValue = 0;
+    while(_peek() >= '0' && _peek() <= '9') {
+        a_rValue = a_rValue * 10 + (_vPattern[_i++] - '0');
+        if(a_rValue > kMaxStates) {
+            return false; // could never be expanded
+        }
+    }
+    return true;
+}
+//-----------------------------------------------------------------
+// After '[': [^] ('-' / item) item* ['-'] ']', where an item is a character
+// or a range of them
+bool _QueryRegex::_classExpression(Class& a_rClass) {
+    if('^' == _peek()) {
+        ++_i;
+        a_rClass.bNegated = true;
+    }
+    if('-' == _peek()) {
+        ++_i;
+        a_rClass.vRanges.push_back(std::make_pair(uint32_t('-'), uint32_t('-')));
+    }
+    auto fnChar = [this](uint32_t& a_rCode) {
+        a_rCode = _vPattern[_i++];
+        if('[' == a_rCode || ']' == a_rCode || '-' == a_rCode) {
+            return false;
+        }
+        return ('\\' != a_rCode) || _escape(a_rCode);
+    };
+    while(_more()) {
+        if(']' == _peek()) {
+            ++_i;
+            return !a_rClass.vRanges.empty();
+        }
+        if('-' == _peek()) { // only right before the closing bracket
+            ++_i;
+            a_rClass.vRanges.push_back(std::make_pair(uint32_t('-'), uint32_t('-')));
+            if(']' != _peek()) {
+                return false;
+            }
+            continue;
+        }
+        uint32_t iLow = 0;
+        if(!fnChar(iLow)) {
+            return false;
+        }
+        uint32_t iHigh = iLow;
+        if('-' == _peek() && _i + 1 < _vPattern.size() && ']' != _vPattern[_i + 1]) {
+            ++_i;
+            if(!fnChar(iHigh) || iHigh < iLow) {
+                return false;
+            }
+        }
+        a_rClass.vRanges.push_back(std::make_pair(iLow, iHigh));
+    }
+    return false;
+}
+//-----------------------------------------------------------------
+// After '\': the escaped character
+bool _QueryRegex::_escape(uint32_t& a_rCode) {
+    if(!_more()) {
+        return false;
+    }
+    a_rCode = _vPattern[_i++];
+    switch(a_rCode) {
+        case 'n': { a_rCode = '\n'; return true; }
+        case 'r': { a_rCode = '\r'; return true; }
+        case 't': { a_rCode = '\t'; return true; }
+        case '(': case ')': case '*': case '+': case '-': case '.': case '?': case '[':
+        case '\\': case ']': case '^': case '{': case '|': case '}': {
+            return true;
+        }
+        default: {
+            return false;
+        }
+    }
+}
+//-----------------------------------------------------------------
+size_t _QueryRegex::_newNode(Node::Kind aeKind) {
+    _vNodes.emplace_back();
+    _vNodes.back().eKind = aeKind;
+    return _vNodes.size() - 1;
+}
+//-----------------------------------------------------------------
+size_t _QueryRegex::_newClass(uint32_t a_iLow, uint32_t a_iHigh, bool a_bNegated) {
+    _vClasses.emplace_back();
+    _vClasses.back().vRanges.push_back(std::make_pair(a_iLow, a_iHigh));
+    _vClasses.back().bNegated = a_bNegated;
+    return _vClasses.size() - 1;
+}
+//-----------------------------------------------------------------
+// Recurses only as deep as the groups nest, which _alternation() limits
+bool _QueryRegex::_emit(size_t a_iNode) {
+    if(_vStates.size() > kMaxStates || ++_iEmitted > 4 * kMaxStates) {
+        return false;
+    }
+    const Node& rNode = _vNodes[a_iNode];
+    switch(rNode.eKind) {
+        case Node::nodeClass: {
+            uint32_t iState = _push(State::opClass);
+            _vStates[iState].iClass = rNode.iClass;
+            return true;
+        }
+        case Node::nodeConcat: {
+            for(size_t iChild : rNode.vChildren) {
+                if(!_emit(iChild)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+        case Node::nodeAlternate: {
+            std::vector<uint32_t> vJumps;
+            for(size_t i = 0; i < rNode.vChildren.size(); ++i) {
+                bool bLast = (i + 1 == rNode.vChildren.size());
+                uint32_t iSplit = bLast ? 0 : _push(State::opSplit);
+                if(!_emit(rNode.vChildren[i])) {
+                    return false;
+                }
+                if(!bLast) {
+                    vJumps.push_back(_push(State::opJump));
+                    _vStates[iSplit].iAlt = static_cast<uint32_t>(_vStates.size());
+                }
+            }
+            for(uint32_t iJump : vJumps) {
+                _vStates[iJump].iNext = static_cast<uint32_t>(_vStates.size());
+            }
+            return true;
+        }
+        case Node::nodeRepeat: {
+            const size_t iChild = rNode.vChildren[0];
+            const uint32_t iMin = rNode.iMin;
+            const uint32_t iMax = rNode.iMax;
+            for(uint32_t i = 0; i < iMin; ++i) {
+                if(!_emit(iChild)) {
+                    return false;
+                }
+            }
+            if(kUnbounded == iMax) {
+                uint32_t iLoop = _push(State::opSplit);
+                if(!_emit(iChild)) {
+                    return false;
+                }
+                _vStates[_push(State::opJump)].iNext = iLoop;
+                _vStates[iLoop].iAlt = static_cast<uint32_t>(_vStates.size());
+                return true;
+            }
+            // Each optional copy may end the repeat
+            std::vector<uint32_t> vSplits;
+            for(uint32_t i = iMin; i < iMax; ++i) {
+                vSplits.push_back(_push(State::opSplit));
+                if(!_emit(iChild)) {
+                    return false;
+                }
+            }
+            for(uint32_t iSplit : vSplits) {
+                _vStates[iSplit].iAlt = static_cast<uint32_t>(_vStates.size());
+            }
+            return true;
+        }
+    }
+    return false;
+}
+//-----------------------------------------------------------------
+// A new state that goes on to the one after it
+uint32_t _QueryRegex::_push(State::Op aeOp) {
+    State oState;
+    oState.eOp = aeOp;
+    oState.iNext = static_cast<uint32_t>(_vStates.size() + 1);
+    oState.iAlt = 0;
+    oState.iClass = 0;
+    _vStates.push_back(oState);
+    return static_cast<uint32_t>(_vStates.size() - 1);
+}
+//-----------------------------------------------------------------
+// Adds a_iState and every state reachable from it without reading a code
+// point, each at most once per step
+void _QueryRegex::_add(uint32_t a_iState, std::vector<uint32_t>& a_rList, Threads& a_rThreads) const {
+    a_rThreads.vStack.push_back(a_iState);
+    while(!a_rThreads.vStack.empty()) {
+        uint32_t iState = a_rThreads.vStack.back();
+        a_rThreads.vStack.pop_back();
+        if(a_rThreads.iStep == a_rThreads.vSeen[iState]) {
+            continue;
+        }
+        a_rThreads.vSeen[iState] = a_rThreads.iStep;
+        const State& rState = _vStates[iState];
+        if(State::opSplit == rState.eOp) {
+            a_rThreads.vStack.push_back(rState.iAlt);
+            a_rThreads.vStack.push_back(rState.iNext);
+        } else if(State::opJump == rState.eOp) {
+            a_rThreads.vStack.push_back(rState.iNext);
+        } else {
+            a_rList.push_back(iState);
+        }
+    }
+}
+//-----------------------------------------------------------------
+bool _QueryRegex::matches(const std::string& aText, bool a_bWhole, Threads& a_rThreads) const {
+    if(a_rThreads.vSeen.size() < _vStates.size()) {
+        a_rThreads.vSeen.resize(_vStates.size(), 0);
+    }
+    a_rThreads.vCurrent.clear();
+    ++a_rThreads.iStep;
+    _add(0, a_rThreads.vCurrent, a_rThreads);
+    size_t iAt = 0;
+    while(true) {
+        if(!a_bWhole || iAt == aText.size()) {
+            for(uint32_t iState : a_rThreads.vCurrent) {
+                if(State::opMatch == _vStates[iState].eOp) {
+                    return true;
+                }
+            }
+        }
+        if(iAt == aText.size() || (a_bWhole && a_rThreads.vCurrent.empty())) {
+            return false;
+        }
+        const uint32_t iCode = _NextCodePoint(aText, iAt);
+        a_rThreads.vNext.clear();
+        ++a_rThreads.iStep;
+        for(uint32_t iState : a_rThreads.vCurrent) {
+            const State& rState = _vStates[iState];
+            if(State::opClass == rState.eOp && _vClasses[rState.iClass].has(iCode)) {
+                _add(rState.iNext, a_rThreads.vNext, a_rThreads);
+            }
+        }
+        if(!a_bWhole) {
+            _add(0, a_rThreads.vNext, a_rThreads); // a match may also start after this code point
+        }
+        a_rThreads.vCurrent.swap(a_rThreads.vNext);
+    }
+}
+
+//==[Parser]===============================================================
+// Recursive descent over the RFC 9535 grammar, including its well-typedness
+// rules for filters and function arguments
+class pjson::Query::Parser {
+public:
+    Parser(const std::string& aText, Program& a_rProgram) : _rText(aText), _rProgram(a_rProgram) {}
+
+    bool parse(std::string& a_rError) {
+        if('$' != _peek()) {
+            _fail("expected '$'");
+        } else if(_path(_rProgram.oPath, false) && _i < _rText.size()) {
+            _fail("unexpected character");
+        }
+        a_rError = _sError;
+        return _sError.empty();
+    }
+
+private:
+    char _peek(size_t a_iAhead = 0) const {
+        return (_i + a_iAhead < _rText.size()) ? _rText[_i + a_iAhead] : '\0';
+    }
+    bool _fail(const char* aWhat) {
+        if(_sError.empty()) {
+            _sError = std::string(aWhat) + " at " + std::to_string(_i);
+        }
+        return false;
+    }
+    void _skipSpace() {
+        while(' ' == _peek() || '\t' == _peek() || '\n' == _peek() || '\r' == _peek()) {
+            ++_i;
+        }
+    }
+    static bool _IsNameFirst(char c) {
+        return ('a' <= c && 'z' >= c) || ('A' <= c && 'Z' >= c) || '_' == c || (static_cast<unsigned char>(c) >= 0x80);
+    }
+    static bool _IsDigit(char c) {
+        return '0' <= c && '9' >= c;
+    }
+    _QueryExpr* _newExpr(_QueryExpr::Kind aeKind) {
+        _rProgram.vExprs.emplace_back();
+        _rProgram.vExprs.back().eKind = aeKind;
+        return &_rProgram.vExprs.back();
+    }
+
+    //-----------------------------------------------------------------
+    // '$' or '@' followed by segments
+    bool _path(_QueryPath& a_rPath, bool a_bRelative) {
+        a_rPath.bRelative = a_bRelative;
+        ++_i;
+        while(true) {
+            size_t iSave = _i;
+            _skipSpace();
+            if('[' != _peek() && '.' != _peek()) {
+                _i = iSave;
+                return true;
+            }
+            a_rPath.vSegments.emplace_back();
+            if(!_segment(a_rPath.vSegments.back())) {
+                return false;
+            }
+        }
+    }
+    bool _segment(_QuerySegment& a_rSegment) {
+        if('[' == _peek()) {
+            return _bracketed(a_rSegment);
+        }
+        ++_i; // '.'
+        if('.' == _peek()) {
+            ++_i;
+            a_rSegment.bDescendant = true;
+            if('[' == _peek()) {
+                return _bracketed(a_rSegment);
+            }
+        }
+        _QuerySelector oSelector;
+        if('*' == _peek()) {
+            ++_i;
+            oSelector.eKind = _QuerySelector::selWildcard;
+        } else if(_IsNameFirst(_peek())) {
+            size_t iBegin = _i;
+            while(_IsNameFirst(_peek()) || _IsDigit(_peek())) {
+                ++_i;
+            }
+            oSelector.sName = _rText.substr(iBegin, _i - iBegin); // nothing to escape
+        } else {
+            return _fail("expected a member name or '*'");
+        }
+        a_rSegment.vSelectors.push_back(oSelector);
+        return true;
+    }
+    bool _bracketed(_QuerySegment& a_rSegment) {
+        ++_i; // '['
+        _skipSpace();
+        while(true) {
+            a_rSegment.vSelectors.emplace_back();
+            if(!_selector(a_rSegment.vSelectors.back())) {
+                return false;
+            }
+            _skipSpace();
+            if(',' == _peek()) {
+                ++_i;
+                _skipSpace();
+            } else if(']' == _peek()) {
+                ++_i;
+                return true;
+            } else {
+                return _fail("expected ',' or ']'");
+            }
+        }
+    }
+    bool _selector(_QuerySelector& a_rSelector) {
+        char c = _peek();
+        if('\'' == c || '\"' == c) {
+            std::string sName;
+            if(!_string(sName)) {
+                return false;
+            }
+            a_rSelector.sName = _EscapeName(sName);
+            return true;
+        }
+        if('*' == c) {
+            ++_i;
+            a_rSelector.eKind = _QuerySelector::selWildcard;
+            return true;
+        }
+        if('?' == c) {
+            ++_i;
+            _skipSpace();
+            a_rSelector.eKind = _QuerySelector::selFilter;
+            a_rSelector.pFilter = _logicalOr();
+            return nullptr != a_rSelector.pFilter;
+        }
+        // index or slice
+        a_rSelector.bHasStart = ('-' == c || _IsDigit(c));
+        if(a_rSelector.bHasStart && !_integer(a_rSelector.iIndex)) {
+            return false;
+        }
+        size_t iSave = _i;
+        _skipSpace();
+        if(':' != _peek()) {
+            _i = iSave;
+            a_rSelector.eKind = _QuerySelector::selIndex;
+            return a_rSelector.bHasStart || _fail("expected a selector");
+        }
+        a_rSelector.eKind = _QuerySelector::selSlice;
+        ++_i;
+        _skipSpace();
+        if('-' == _peek() || _IsDigit(_peek())) {
+            a_rSelector.bHasEnd = true;
+            if(!_integer(a_rSelector.iEnd)) {
+                return false;
+            }
+            _skipSpace();
+        }
+        if(':' == _peek()) {
+            ++_i;
+            _skipSpace();
+            if(('-' == _peek() || _IsDigit(_peek())) && !_integer(a_rSelector.iStep)) {
+                return false;
+            }
+        }
+        return true;
+    }
+    // I-JSON integer, no leading zeros and no "-0"
+    bool _integer(int64_t& a_rValue) {
+        bool bNegative = ('-' == _peek());
+        if(bNegative) {
+            ++_i;
+        }
+        if(!_IsDigit(_peek()) || ('0' == _peek() && (bNegative || _IsDigit(_peek(1))))) {
+            return _fail("malformed integer");
+        }
+        const int64_t iMax = (int64_t(1) << 53) - 1;
+        int64_t iValue = 0;
+        while(_IsDigit(_peek())) {
+            iValue = iValue * 10 + (_peek() - '0');
+            ++_i;
+            if(iValue > iMax) {
+                return _fail("integer out of range");
+            }
+        }
+        a_rValue = bNegative ? -iValue : iValue;
+        return true;
+    }
+    bool _string(std::string& a_rOut) {
+        const char aQuote = _peek();
+        ++_i;
+        a_rOut.clear();
+        while(_i < _rText.size()) {
+            char c = _rText[_i++];
+            if(aQuote == c) {
+                return true;
+            }
+            if(static_cast<unsigned char>(c) < 0x20) {
+                --_i;
+                return _fail("control character in string");
+            }
+            if('\\' != c) {
+                a_rOut += c;
+                continue;
+            }
+            char e = _peek();
+            ++_i;
+            switch(e) {
+                case 'b': { a_rOut += '\b'; break; }
+                case 'f': { a_rOut += '\f'; break; }
+                case 'n': { a_rOut += '\n'; break; }
+                case 'r': { a_rOut += '\r'; break; }
+                case 't': { a_rOut += '\t'; break; }
+                case '/':
+                case '\\': { a_rOut += e; break; }
+                case '\'':
+                case '\"': {
+                    if(e != aQuote) {
+                        --_i;
+                        return _fail("bad escape");
+                    }
+                    a_rOut += e;
+                    break;
+                }
+                case 'u': {
+                    uint32_t iCode = 0;
+                    if(!_ReadHex4(_rText.data(), _rText.size(), _i, iCode)) {
+                        return _fail("bad \\u escape");
+                    }
+                    _i += 4;
+                    if(iCode >= 0xDC00 && iCode <= 0xDFFF) {
+                        return _fail("unpaired surrogate");
+                    }
+                    if(iCode >= 0xD800 && iCode <= 0xDBFF) {
+                        uint32_t iLow = 0;
+                        if('\\' != _peek() || 'u' != _peek(1) || !_ReadHex4(_rText.data(), _rText.size(), _i + 2, iLow)
+                           || iLow < 0xDC00 || iLow > 0xDFFF) {
+                            return _fail("unpaired surrogate");
+                        }
+                        _i += 6;
+                        iCode = 0x10000 + ((iCode - 0xD800) << 10) + (iLow - 0xDC00);
+                    }
+                    _AppendUtf8(a_rOut, iCode);
+                    break;
+                }
+                default: {
+                    --_i;
+                    return _fail("bad escape");
+                }
+            }
+        }
+        return _fail("unterminated string");
+    }
+    bool _number(double& a_rValue) {
+        size_t iBegin = _i;
+        if('-' == _peek()) {
+            ++_i;
+        }
+        if(!_IsDigit(_peek()) || ('0' == _peek() && _IsDigit(_peek(1)))) {
+            return _fail("malformed number");
+        }
+        while(_IsDigit(_peek())) {
+            ++_i;
+        }
+        if('.' == _peek()) {
+            ++_i;
+            if(!_IsDigit(_peek())) {
+                return _fail("malformed number");
+            }
+            while(_IsDigit(_peek())) {
+                ++_i;
+            }
+        }
+        if('e' == _peek() || 'E' == _peek()) {
+            ++_i;
+            if('+' == _peek() || '-' == _peek()) {
+                ++_i;
+            }
+            if(!_IsDigit(_peek())) {
+                return _fail("malformed number");
+            }
+            while(_IsDigit(_peek())) {
+                ++_i;
+            }
+        }
+        a_rValue = strtod(_rText.substr(iBegin, _i - iBegin).c_str(), nullptr);
+        return true;
+    }
+
+    //-----------------------------------------------------------------
+    _QueryExpr* _logicalOr() {
+        if(++_iDepth > pjson::GetMaxParseDepth()) {
+            _fail("filter nested too deeply");
+            return nullptr;
+        }
+        _QueryExpr* pLeft = _logicalAnd();
+        while(pLeft) {
+            size_t iSave = _i;
+            _skipSpace();
+            if('|' != _peek() || '|' != _peek(1)) {
+                _i = iSave;
+                break;
+            }
+            _i += 2;
+            _skipSpace();
+            _QueryExpr* pRight = _logicalAnd();
+            if(nullptr == pRight) {
+                return nullptr;
+            }
+            if(_QueryExpr::exprOr != pLeft->eKind) {
+                _QueryExpr* pOr = _newExpr(_QueryExpr::exprOr);
+                pOr->vArgs.push_back(pLeft);
+                pLeft = pOr;
+            }
+            pLeft->vArgs.push_back(pRight);
+        }
+        --_iDepth;
+        return pLeft;
+    }
+    _QueryExpr* _logicalAnd() {
+        _QueryExpr* pLeft = _basic();
+        while(pLeft) {
+            size_t iSave = _i;
+            _skipSpace();
+            if('&' != _peek() || '&' != _peek(1)) {
+                _i = iSave;
+                break;
+            }
+            _i += 2;
+            _skipSpace();
+            _QueryExpr* pRight = _basic();
+            if(nullptr == pRight) {
+                return nullptr;
+            }
+            if(_QueryExpr::exprAnd != pLeft->eKind) {
+                _QueryExpr* pAnd = _newExpr(_QueryExpr::exprAnd);
+                pAnd->vArgs.push_back(pLeft);
+                pLeft = pAnd;
+            }
+            pLeft->vArgs.push_back(pRight);
+        }
+        return pLeft;
+    }
+    _QueryExpr* _paren() {
+        ++_i; // '('
+        _skipSpace();
+        _QueryExpr* pInner = _logicalOr();
+        if(nullptr == pInner) {
+            return nullptr;
+        }
+        _skipSpace();
+        if(')' != _peek()) {
+            _fail("expected ')'");
+            return nullptr;
+        }
+        ++_i;
+        return pInner;
+    }
+    _QueryExpr* _basic() {
+        if('!' == _peek()) {
+            ++_i;
+            _skipSpace();
+            _QueryExpr* pInner = ('(' == _peek()) ? _paren() : _test(_operand());
+            if(nullptr == pInner) {
+                return nullptr;
+            }
+            _QueryExpr* pNot = _newExpr(_QueryExpr::exprNot);
+            pNot->vArgs.push_back(pInner);
+            return pNot;
+        }
+        if('(' == _peek()) {
+            return _paren();
+        }
+        _QueryExpr* pLeft = _operand();
+        if(nullptr == pLeft) {
+            return nullptr;
+        }
+        size_t iSave = _i;
+        _skipSpace();
+        _QueryExpr::Op eOp;
+        if(!_compareOp(eOp)) {
+            _i = iSave;
+            return _test(pLeft);
+        }
+        _skipSpace();
+        _QueryExpr* pRight = _operand();
+        if(nullptr == pRight || !_comparable(pLeft) || !_comparable(pRight)) {
+            return nullptr;
+        }
+        _QueryExpr* pCompare = _newExpr(_QueryExpr::exprCompare);
+        pCompare->eOp = eOp;
+        pCompare->vArgs.push_back(pLeft);
+        pCompare->vArgs.push_back(pRight);
+        return pCompare;
+    }
+    bool _compareOp(_QueryExpr::Op& a_rOp) {
+        char c = _peek();
+        char n = _peek(1);
+        if('=' == c && '=' == n)      { a_rOp = _QueryExpr::opEq; _i += 2; }
+        else if('!' == c && '=' == n) { a_rOp = _QueryExpr::opNe; _i += 2; }
+        else if('<' == c && '=' == n) { a_rOp = _QueryExpr::opLe; _i += 2; }
+        else if('>' == c && '=' == n) { a_rOp = _QueryExpr::opGe; _i += 2; }
+        else if('<' == c)             { a_rOp = _QueryExpr::opLt; _i += 1; }
+        else if('>' == c)             { a_rOp = _QueryExpr::opGt; _i += 1; }
+        else { return false; }
+        return true;
+    }
+    // A value on its own in a filter: a query tests for existence
+    _QueryExpr* _test(_QueryExpr* a_pExpr) {
+        if(nullptr == a_pExpr) {
+            return nullptr;
+        }
+        if(_QueryExpr::exprPath == a_pExpr->eKind) {
+            a_pExpr->eKind = _QueryExpr::exprExists;
+            return a_pExpr;
+        }
+        if(_QueryExpr::exprFunction == a_pExpr->eKind && a_pExpr->returnsLogical()) {
+            return a_pExpr;
+        }
+        _fail("expected a query, a comparison or a logical function");
+        return nullptr;
+    }
+    // A literal, a singular query or a function returning a value
+    bool _comparable(const _QueryExpr* a_pExpr) {
+        switch(a_pExpr->eKind) {
+            case _QueryExpr::exprLiteral:  { return true; }
+            case _QueryExpr::exprPath:     { return a_pExpr->oPath.isSingular() || _fail("query in a comparison is not singular"); }
+            case _QueryExpr::exprFunction: { return !a_pExpr->returnsLogical() || _fail("match() / search() cannot be compared"); }
+            default:                       { return _fail("not comparable"); }
+        }
+    }
+    // Literal, query or function call
+    _QueryExpr* _operand() {
+        char c = _peek();
+        if('@' == c || '$' == c) {
+            _QueryExpr* pPath = _newExpr(_QueryExpr::exprPath);
+            return _path(pPath->oPath, '@' == c) ? pPath : nullptr;
+        }
+        if('\'' == c || '\"' == c) {
+            _QueryExpr* pLiteral = _newExpr(_QueryExpr::exprLiteral);
+            pLiteral->eLiteral = _QueryExpr::litString;
+            return _string(pLiteral->sValue) ? pLiteral : nullptr;
+        }
+        if('-' == c || _IsDigit(c)) {
+            _QueryExpr* pLiteral = _newExpr(_QueryExpr::exprLiteral);
+            pLiteral->eLiteral = _QueryExpr::litNumber;
+            return _number(pLiteral->dValue) ? pLiteral : nullptr;
+        }
+        if(!('a' <= c && 'z' >= c)) {
+            _fail("expected a value");
+            return nullptr;
+        }
+        size_t iBegin = _i;
+        while(('a' <= _peek() && 'z' >= _peek()) || _IsDigit(_peek()) || '_' == _peek()) {
+            ++_i;
+        }
+        std::string sName = _rText.substr(iBegin, _i - iBegin);
+        if('(' == _peek()) {
+            return _function(sName, iBegin);
+        }
+        _QueryExpr* pLiteral = _newExpr(_QueryExpr::exprLiteral);
+        if("true" == sName || "false" == sName) {
+            pLiteral->eLiteral = _QueryExpr::litBool;
+            pLiteral->bValue = ("true" == sName);
+        } else if("null" == sName) {
+            pLiteral->eLiteral = _QueryExpr::litNull;
+        } else {
+            _i = iBegin;
+            _fail("expected a value");
+            return nullptr;
+        }
+        return pLiteral;
+    }
+    _QueryExpr* _function(const std::string& aName, size_t a_iBegin) {
+        _QueryExpr* pCall = _newExpr(_QueryExpr::exprFunction);
+        bool bNodesArgument = false; // count() / value() take a query
+        size_t iArgs = 1;
+        if("length" == aName)      { pCall->eFunction = _QueryExpr::fnLength; }
+        else if("count" == aName)  { pCall->eFunction = _QueryExpr::fnCount; bNodesArgument = true; }
+        else if("value" == aName)  { pCall->eFunction = _QueryExpr::fnValue; bNodesArgument = true; }
+        else if("match" == aName)  { pCall->eFunction = _QueryExpr::fnMatch; iArgs = 2; }
+        else if("search" == aName) { pCall->eFunction = _QueryExpr::fnSearch; iArgs = 2; }
+        else {
+            _i = a_iBegin;
+            _fail("unknown function");
+            return nullptr;
+        }
+        ++_i; // '('
+        _skipSpace();
+        for(size_t i = 0; i < iArgs; ++i) {
+            if(i > 0) {
+                _skipSpace();
+                if(',' != _peek()) {
+                    _fail("expected ','");
+                    return nullptr;
+                }
+                ++_i;
+                _skipSpace();
+            }
+            _QueryExpr* pArg = _operand();
+            if(nullptr == pArg) {
+                return nullptr;
+            }
+            if(bNodesArgument ? (_QueryExpr::exprPath != pArg->eKind) : !_comparable(pArg)) {
+                _fail(bNodesArgument ? "expected a query" : "expected a value");
+                return nullptr;
+            }
+            pCall->vArgs.push_back(pArg);
+        }
+        _skipSpace();
+        if(')' != _peek()) {
+            _fail("expected ')'");
+            return nullptr;
+        }
+        ++_i;
+        const _QueryExpr* pPattern = (2 == iArgs) ? pCall->vArgs[1] : nullptr;
+        if(pPattern && _QueryExpr::exprLiteral == pPattern->eKind && _QueryExpr::litString == pPattern->eLiteral) {
+            std::shared_ptr<_QueryRegex> pRegex = std::make_shared<_QueryRegex>();
+            if(pRegex->compile(pPattern->sValue)) {
+                pCall->pRegex = pRegex;
+            } else {
+                pCall->bBadRegex = true; // never matches, as RFC 9535 asks
+            }
+        }
+        return pCall;
+    }
+
+private:
+    const std::string& _rText;
+    Program& _rProgram;
+    size_t _i = 0;
+    size_t _iDepth = 0; // filters and parentheses
+    std::string _sError;
+};
+
+//==[Sources]==============================================================
+template<typename Node>
+struct _QueryValue {
+    enum Kind { valNothing, valNull, valBool, valNumber, valString, valArray, valObject };
+    Kind eKind = valNothing;
+    bool bValue = false;
+    double dValue = 0.0;
+    std::string sValue; // decoded
+    Node oNode = Node(); // arrays / objects, for deep equality
+};
+
+// Values of a pjson tree
+class pjson::Query::TreeSource {
+public:
+    typedef const pjson* Node;
+
+    explicit TreeSource(const pjson& aRoot) : _pRoot(&aRoot) {}
+
+    bool root(Node& a_rNode) { a_rNode = _pRoot; return true; }
+    void fail() {}
+    bool failed() const { return false; }
+    jsonType type(Node aNode) const { return aNode->getType(); }
+
+    template<typename F>
+    void members(Node aNode, F& a_rEach) {
+        for(const auto& rMember : *aNode->getMap()) {
+            a_rEach(static_cast<Node>(rMember.second));
+        }
+    }
+    template<typename F>
+    void elements(Node aNode, F& a_rEach) {
+        for(const pjson* pItem : *aNode->getArray()) {
+            a_rEach(pItem);
+        }
+    }
+    bool member(Node aNode, const std::string& aName, Node& a_rOut) {
+        auto it = aNode->getMap()->find(aName);
+        if(it == aNode->getMap()->end()) {
+            return false;
+        }
+        a_rOut = it->second;
+        return true;
+    }
+    bool element(Node aNode, size_t a_iIndex, Node& a_rOut) {
+        if(a_iIndex >= aNode->getArray()->size()) {
+            return false;
+        }
+        a_rOut = (*aNode->getArray())[a_iIndex];
+        return true;
+    }
+    size_t size(Node aNode) {
+        switch(aNode->getType()) {
+            case jsonArray: { return aNode->getArray()->size(); }
+            case jsonMap:   { return aNode->getMap()->size(); }
+            default:        { return 0; }
+        }
+    }
+    void value(Node aNode, _QueryValue<Node>& a_rValue) {
+        a_rValue.oNode = aNode;
+        switch(aNode->getType()) {
+            case jsonNull:        { a_rValue.eKind = _QueryValue<Node>::valNull; break; }
+            case jsonBoolean:     { a_rValue.eKind = _QueryValue<Node>::valBool; a_rValue.bValue = aNode->getBool(); break; }
+            case jsonNumberInt:   { a_rValue.eKind = _QueryValue<Node>::valNumber; a_rValue.dValue = aNode->getDouble(); break; }
+            case jsonNumberFloat: {
+                a_rValue.eKind = _QueryValue<Node>::valNumber;
+                a_rValue.dValue = aNode->isRawNumber() ? aNode->getDouble() : _WidenFloat(aNode->getFloat());
+                break;
+            }
+            case jsonString: {
+                a_rValue.eKind = _QueryValue<Node>::valString;
+                const std::string& rText = *aNode->_pValueString;
+                _Unescape(rText.data(), rText.length(), a_rValue.sValue);
+                break;
+            }
+            case jsonArray:       { a_rValue.eKind = _QueryValue<Node>::valArray; break; }
+            case jsonMap:         { a_rValue.eKind = _QueryValue<Node>::valObject; break; }
+        }
+    }
+    bool equal(Node aLeft, Node aRight) { return aLeft->equals(*aRight, true); }
+
+private:
+    const pjson* _pRoot;
+};
+
+// Values read in place from JSON text; a node is the offset its value starts at
+class pjson::Query::TextSource {
+public:
+    typedef size_t Node;
+
+    TextSource(const char* aSrc, size_t a_iSize) : _pSrc(aSrc), _iEnd(a_iSize) {}
+
+    bool root(Node& a_rNode) {
+        size_t i = 0;
+        char aChar;
+        if(!_ScanToNext(_pSrc, i, _iEnd, aChar)) {
+            fail();
+            return false;
+        }
+        a_rNode = i;
+        return true;
+    }
+    void fail() { _bFailed = true; }
+    bool failed() const { return _bFailed; }
+
+    jsonType type(Node aNode) const {
+        switch(tolower(_pSrc[aNode])) {
+            case '{':  { return jsonMap; }
+            case '[':  { return jsonArray; }
+            case '\"': { return jsonString; }
+            case 't':
+            case 'f':  { return jsonBoolean; }
+            case 'n':  { return jsonNull; }
+            default:   { return jsonNumberFloat; }
+        }
+    }
+    // Calls a_rEach with the value of every member; nothing else is read
+    template<typename F>
+    void members(Node aNode, F& a_rEach) {
+        size_t i = aNode + 1;
+        size_t iKey = 0;
+        size_t iKeyLength = 0;
+        while(_nextMember(i, iKey, iKeyLength)) {
+            size_t iValue = i;
+            a_rEach(iValue);
+            if(_bFailed || !_skip(i)) {
+                return;
+            }
+        }
+    }
+    template<typename F>
+    void elements(Node aNode, F& a_rEach) {
+        size_t i = aNode + 1;
+        while(_nextElement(i)) {
+            size_t iValue = i;
+            a_rEach(iValue);
+            if(_bFailed || !_skip(i)) {
+                return;
+            }
+        }
+    }
+    bool member(Node aNode, const std::string& aName, Node& a_rOut) {
+        size_t i = aNode + 1;
+        size_t iKey = 0;
+        size_t iKeyLength = 0;
+        while(_nextMember(i, iKey, iKeyLength)) {
+            if(iKeyLength == aName.length() && 0 == memcmp(_pSrc + iKey, aName.data(), iKeyLength)) {
+                a_rOut = i;
+                return true;
+            }
+            if(!_skip(i)) {
+                return false;
+            }
+        }
+        return false;
+    }
+    bool element(Node aNode, size_t a_iIndex, Node& a_rOut) {
+        size_t i = aNode + 1;
+        for(size_t iIndex = 0; _nextElement(i); ++iIndex) {
+            if(iIndex == a_iIndex) {
+                a_rOut = i;
+                return true;
+            }
+            if(!_skip(i)) {
+                return false;
+            }
+        }
+        return false;
+    }
+    size_t size(Node aNode) {
+        size_t iCount = 0;
+        auto fnCount = [&iCount](Node) { ++iCount; };
+        if(jsonMap == type(aNode)) {
+            members(aNode, fnCount);
+        } else if(jsonArray == type(aNode)) {
+            elements(aNode, fnCount);
+        }
+        return iCount;
+    }
+    void value(Node aNode, _QueryValue<Node>& a_rValue) {
+        a_rValue.oNode = aNode;
+        switch(type(aNode)) {
+            case jsonNull:    { a_rValue.eKind = _QueryValue<Node>::valNull; break; }
+            case jsonBoolean: { a_rValue.eKind = _QueryValue<Node>::valBool; a_rValue.bValue = ('t' == tolower(_pSrc[aNode])); break; }
+            case jsonArray:   { a_rValue.eKind = _QueryValue<Node>::valArray; break; }
+            case jsonMap:     { a_rValue.eKind = _QueryValue<Node>::valObject; break; }
+            case jsonString: {
+                size_t i = aNode;
+                size_t iBegin = 0;
+                size_t iLength = 0;
+                if(!_ExtractStringSpan(_pSrc, i, _iEnd, iBegin, iLength)) {
+                    fail();
+                    break;
+                }
+                a_rValue.eKind = _QueryValue<Node>::valString;
+                _Unescape(_pSrc + iBegin, iLength, a_rValue.sValue);
+                break;
+            }
+            default: {
+                size_t iLength = 0;
+                bool bFloat = false;
+                if(!_ScanNumberSpan(_pSrc, aNode, _iEnd, iLength, bFloat) || 0 == iLength) {
+                    fail();
+                    break;
+                }
+                a_rValue.eKind = _QueryValue<Node>::valNumber;
+                a_rValue.dValue = strtod(std::string(_pSrc + aNode, iLength).c_str(), nullptr);
+                break;
+            }
+        }
+    }
+    // Structured values are only ever built to compare them
+    bool equal(Node aLeft, Node aRight) {
+        pjson* pLeft = copy(aLeft);
+        pjson* pRight = pLeft ? copy(aRight) : nullptr;
+        bool bEqual = pLeft && pRight && pLeft->equals(*pRight, true);
+        delete pLeft;
+        delete pRight;
+        return bEqual;
+    }
+    bool span(Node aNode, size_t& a_rLength) {
+        size_t i = aNode;
+        if(!_skip(i)) {
+            return false;
+        }
+        a_rLength = i - aNode;
+        return true;
+    }
+    pjson* copy(Node aNode) {
+        size_t iLength = 0;
+        if(!span(aNode, iLength)) {
+            return nullptr;
+        }
+        size_t i = aNode;
+        pjson* pResult = nullptr;
+        if(!_CreateFromString(_pSrc, i, aNode + iLength, pResult)) {
+            fail();
+            return nullptr;
+        }
+        return pResult;
+    }
+
+private:
+    bool _skip(size_t& a_iAt) {
+        if(!_SkipValue(_pSrc, a_iAt, _iEnd)) {
+            fail();
+            return false;
+        }
+        return true;
+    }
+    // Moves a_iAt to the next member value; false at '}' or on malformed text
+    bool _nextMember(size_t& a_iAt, size_t& a_rKey, size_t& a_rKeyLength) {
+        char aChar;
+        while(_ScanToNext(_pSrc, a_iAt, _iEnd, aChar)) {
+            if('}' == aChar) {
+                return false;
+            } else if(',' == aChar) {
+                ++a_iAt;
+            } else if(_ExtractStringSpan(_pSrc, a_iAt, _iEnd, a_rKey, a_rKeyLength)
+                      && _ScanPastColon(_pSrc, a_iAt, _iEnd) && _ScanToNext(_pSrc, a_iAt, _iEnd, aChar)) {
+                return true;
+            } else {
+                break;
+            }
+        }
+        fail();
+        return false;
+    }
+    bool _nextElement(size_t& a_iAt) {
+        char aChar;
+        while(_ScanToNext(_pSrc, a_iAt, _iEnd, aChar)) {
+            if(']' == aChar) {
+                return false;
+            } else if(',' == aChar) {
+                ++a_iAt;
+            } else {
+                return true;
+            }
+        }
+        fail();
+        return false;
+    }
+
+private:
+    const char* _pSrc;
+    const size_t _iEnd;
+    bool _bFailed = false;
+};
+
+//==[Evaluation]===========================================================
+template<typename Source>
+class _QueryRun {
+public:
+    typedef typename Source::Node Node;
+    typedef _QueryValue<Node> Value;
+
+    _QueryRun(Source& a_rSource, Node aRoot) : _rSource(a_rSource), _oRoot(aRoot) {}
+
+    template<typename Emit>
+    void path(const _QueryPath& aPath, Node aStart, Emit& a_rEmit) {
+        _segments(aPath, 0, aStart, a_rEmit);
+    }
+
+private:
+    template<typename Emit>
+    void _segments(const _QueryPath& aPath, size_t a_iSegment, Node aNode, Emit& a_rEmit) {
+        if(_rSource.failed()) {
+            return;
+        }
+        if(a_iSegment == aPath.vSegments.size()) {
+            a_rEmit(aNode);
+            return;
+        }
+        const _QuerySegment& rSegment = aPath.vSegments[a_iSegment];
+        auto fnNext = [&](Node aChild) { _segments(aPath, a_iSegment + 1, aChild, a_rEmit); };
+        if(rSegment.bDescendant) {
+            _descend(rSegment, aNode, fnNext, 0);
+        } else {
+            _select(rSegment, aNode, fnNext);
+        }
+    }
+    // The node first, then its descendants in order
+    template<typename F>
+    void _descend(const _QuerySegment& aSegment, Node aNode, F& a_rNext, size_t a_iDepth) {
+        if(a_iDepth > pjson::GetMaxParseDepth()) {
+            _rSource.fail();
+            return;
+        }
+        _select(aSegment, aNode, a_rNext);
+        auto fnChild = [&](Node aChild) { _descend(aSegment, aChild, a_rNext, a_iDepth + 1); };
+        switch(_rSource.type(aNode)) {
+            case pjson::jsonMap:   { _rSource.members(aNode, fnChild); break; }
+            case pjson::jsonArray: { _rSource.elements(aNode, fnChild); break; }
+            default:               { break; }
+        }
+    }
+    // Each selector in turn, as RFC 9535 orders the results
+    template<typename F>
+    void _select(const _QuerySegment& aSegment, Node aNode, F& a_rNext) {
+        const pjson::jsonType eType = _rSource.type(aNode);
+        if(pjson::jsonArray != eType && pjson::jsonMap != eType) {
+            return;
+        }
+        const bool bArray = (pjson::jsonArray == eType);
+        std::vector<Node> vElements; // for slices, listed on first use
+        bool bListed = false;
+        for(const _QuerySelector& rSelector : aSegment.vSelectors) {
+            if(_rSource.failed()) {
+                return;
+            }
+            switch(rSelector.eKind) {
+                case _QuerySelector::selName: {
+                    Node oChild;
+                    if(!bArray && _rSource.member(aNode, rSelector.sName, oChild)) {
+                        a_rNext(oChild);
+                    }
+                    break;
+                }
+                case _QuerySelector::selWildcard: {
+                    if(bArray) {
+                        _rSource.elements(aNode, a_rNext);
+                    } else {
+                        _rSource.members(aNode, a_rNext);
+                    }
+                    break;
+                }
+                case _QuerySelector::selIndex: {
+                    int64_t iIndex = rSelector.iIndex;
+                    if(bArray && iIndex < 0) {
+                        iIndex += static_cast<int64_t>(bListed ? vElements.size() : _rSource.size(aNode));
+                    }
+                    Node oChild;
+                    if(bArray && iIndex >= 0 && _rSource.element(aNode, static_cast<size_t>(iIndex), oChild)) {
+                        a_rNext(oChild);
+                    }
+                    break;
+                }
+                case _QuerySelector::selSlice: {
+                    if(!bArray) {
+                        break;
+                    }
+                    if(!bListed) {
+                        auto fnList = [&vElements](Node aChild) { vElements.push_back(aChild); };
+                        _rSource.elements(aNode, fnList);
+                        bListed = true;
+                    }
+                    _slice(rSelector, vElements, a_rNext);
+                    break;
+                }
+                case _QuerySelector::selFilter: {
+                    auto fnTest = [&](Node aChild) {
+                        if(_test(*rSelector.pFilter, aChild)) {
+                            a_rNext(aChild);
+                        }
+                    };
+                    if(bArray) {
+                        _rSource.elements(aNode, fnTest);
+                    } else {
+                        _rSource.members(aNode, fnTest);
+                    }
+                    break;
+                }
+            }
+        }
+    }
+    template<typename F>
+    void _slice(const _QuerySelector& aSlice, const std::vector<Node>& aElements, F& a_rNext) {
+        const int64_t iLength = static_cast<int64_t>(aElements.size());
+        const int64_t iStep = aSlice.iStep;
+        if(0 == iStep) {
+            return;
+        }
+        auto fnBound = [iLength](int64_t iValue, int64_t iLow, int64_t iHigh) {
+            iValue = (iValue >= 0) ? iValue : iLength + iValue;
+            return (iValue < iLow) ? iLow : (iValue > iHigh) ? iHigh : iValue;
+        };
+        if(iStep > 0) {
+            int64_t iLower = fnBound(aSlice.bHasStart ? aSlice.iIndex : 0, 0, iLength);
+            int64_t iUpper = fnBound(aSlice.bHasEnd ? aSlice.iEnd : iLength, 0, iLength);
+            for(int64_t i = iLower; i < iUpper && !_rSource.failed(); i += iStep) {
+                a_rNext(aElements[static_cast<size_t>(i)]);
+            }
+        } else {
+            int64_t iUpper = fnBound(aSlice.bHasStart ? aSlice.iIndex : iLength - 1, -1, iLength - 1);
+            int64_t iLower = fnBound(aSlice.bHasEnd ? aSlice.iEnd : -iLength - 1, -1, iLength - 1);
+            for(int64_t i = iUpper; iLower < i && !_rSource.failed(); i += iStep) {
+                a_rNext(aElements[static_cast<size_t>(i)]);
+            }
+        }
+    }
+
+    //-----------------------------------------------------------------
+    Node _start(const _QueryPath& aPath, Node aCurrent) const {
+        return aPath.bRelative ? aCurrent : _oRoot;
+    }
+    bool _test(const _QueryExpr& aExpr, Node aCurrent) {
+        switch(aExpr.eKind) {
+            case _QueryExpr::exprOr: {
+                for(const _QueryExpr* pArg : aExpr.vArgs) {
+                    if(_test(*pArg, aCurrent)) {
+                        return true;
+                    }
+                }
+                return false;
+            }
+            case _QueryExpr::exprAnd: {
+                for(const _QueryExpr* pArg : aExpr.vArgs) {
+                    if(!_test(*pArg, aCurrent)) {
+                        return false;
+                    }
+                }
+                return true;
+            }
+            case _QueryExpr::exprNot: {
+                return !_test(*aExpr.vArgs[0], aCurrent);
+            }
+            case _QueryExpr::exprExists: {
+                bool bFound = false;
+                auto fnFound = [&bFound](Node) { bFound = true; };
+                path(aExpr.oPath, _start(aExpr.oPath, aCurrent), fnFound);
+                return bFound;
+            }
+            case _QueryExpr::exprFunction: {
+                return _regex(aExpr, aCurrent);
+            }
+            case _QueryExpr::exprCompare: {
+                Value oLeft = _value(*aExpr.vArgs[0], aCurrent);
+                Value oRight = _value(*aExpr.vArgs[1], aCurrent);
+                switch(aExpr.eOp) {
+                    case _QueryExpr::opEq: { return _equal(oLeft, oRight); }
+                    case _QueryExpr::opNe: { return !_equal(oLeft, oRight); }
+                    case _QueryExpr::opLt: { return _less(oLeft, oRight); }
+                    case _QueryExpr::opLe: { return _less(oLeft, oRight) || _equal(oLeft, oRight); }
+                    case _QueryExpr::opGt: { return _less(oRight, oLeft); }
+                    case _QueryExpr::opGe: { return _less(oRight, oLeft) || _equal(oLeft, oRight); }
+                }
+                return false;
+            }
+            default: {
+                return false;
+            }
+        }
+    }
+    bool _regex(const _QueryExpr& aCall, Node aCurrent) {
+        Value oText = _value(*aCall.vArgs[0], aCurrent);
+        if(Value::valString != oText.eKind || aCall.bBadRegex) {
+            return false;
+        }
+        const _QueryRegex* pRegex = aCall.pRegex.get();
+        if(nullptr == pRegex) {
+            Value oPattern = _value(*aCall.vArgs[1], aCurrent);
+            if(Value::valString != oPattern.eKind) {
+                return false;
+            }
+            pRegex = _compiled(oPattern.sValue);
+            if(nullptr == pRegex) {
+                return false;
+            }
+        }
+        return pRegex->matches(oText.sValue, _QueryExpr::fnMatch == aCall.eFunction, _oThreads);
+    }
+    // A pattern read from the document, compiled once per run; nullptr if invalid
+    const _QueryRegex* _compiled(const std::string& aPattern) {
+        auto it = _mPatterns.find(aPattern);
+        if(it == _mPatterns.end()) {
+            if(_mPatterns.size() >= 64) {
+                _mPatterns.clear(); // patterns that differ value by value
+            }
+            std::unique_ptr<_QueryRegex> pRegex(new _QueryRegex());
+            if(!pRegex->compile(aPattern)) {
+                pRegex.reset();
+            }
+            it = _mPatterns.emplace(aPattern, std::move(pRegex)).first;
+        }
+        return it->second.get();
+    }
+    Value _value(const _QueryExpr& aExpr, Node aCurrent) {
+        Value oValue;
+        switch(aExpr.eKind) {
+            case _QueryExpr::exprLiteral: {
+                switch(aExpr.eLiteral) {
+                    case _QueryExpr::litNull:   { oValue.eKind = Value::valNull; break; }
+                    case _QueryExpr::litBool:   { oValue.eKind = Value::valBool; oValue.bValue = aExpr.bValue; break; }
+                    case _QueryExpr::litNumber: { oValue.eKind = Value::valNumber; oValue.dValue = aExpr.dValue; break; }
+                    case _QueryExpr::litString: { oValue.eKind = Value::valString; oValue.sValue = aExpr.sValue; break; }
+                }
+                break;
+            }
+            case _QueryExpr::exprPath: {
+                size_t iCount = 0;
+                auto fnValue = [&](Node aNode) {
+                    if(0 == iCount++) {
+                        _rSource.value(aNode, oValue);
+                    }
+                };
+                path(aExpr.oPath, _start(aExpr.oPath, aCurrent), fnValue);
+                if(1 != iCount) {
+                    oValue = Value(); // value() of several nodes is Nothing
+                }
+                break;
+            }
+            case _QueryExpr::exprFunction: {
+                if(_QueryExpr::fnLength == aExpr.eFunction) {
+                    Value oArg = _value(*aExpr.vArgs[0], aCurrent);
+                    if(Value::valString == oArg.eKind) {
+                        oValue.eKind = Value::valNumber;
+                        oValue.dValue = static_cast<double>(_CodePoints(oArg.sValue));
+                    } else if(Value::valArray == oArg.eKind || Value::valObject == oArg.eKind) {
+                        oValue.eKind = Value::valNumber;
+                        oValue.dValue = static_cast<double>(_rSource.size(oArg.oNode));
+                    }
+                } else if(_QueryExpr::fnCount == aExpr.eFunction) {
+                    size_t iCount = 0;
+                    auto fnCount = [&iCount](Node) { ++iCount; };
+                    const _QueryPath& rPath = aExpr.vArgs[0]->oPath;
+                    path(rPath, _start(rPath, aCurrent), fnCount);
+                    oValue.eKind = Value::valNumber;
+                    oValue.dValue = static_cast<double>(iCount);
+                } else if(_QueryExpr::fnValue == aExpr.eFunction) {
+                    oValue = _value(*aExpr.vArgs[0], aCurrent);
+                }
+                break;
+            }
+            default: {
+                break;
+            }
+        }
+        return oValue;
+    }
+    bool _equal(const Value& aLeft, const Value& aRight) {
+        if(aLeft.eKind != aRight.eKind) {
+            return false;
+        }
+        switch(aLeft.eKind) {
+            case Value::valNothing:
+            case Value::valNull:   { return true; }
+            case Value::valBool:   { return aLeft.bValue == aRight.bValue; }
+            case Value::valNumber: { return aLeft.dValue == aRight.dValue; }
+            case Value::valString: { return aLeft.sValue == aRight.sValue; }
+            default:               { return _rSource.equal(aLeft.oNode, aRight.oNode); }
+        }
+    }
+    bool _less(const Value& aLeft, const Value& aRight) const {
+        if(Value::valNumber == aLeft.eKind && Value::valNumber == aRight.eKind) {
+            return aLeft.dValue < aRight.dValue;
+        }
+        if(Value::valString == aLeft.eKind && Value::valString == aRight.eKind) {
+            return aLeft.sValue < aRight.sValue; // UTF-8 byte order is code point order
+        }
+        return false;
+    }
+
+private:
+    Source& _rSource;
+    const Node _oRoot;
+    std::unordered_map<std::string, std::unique_ptr<_QueryRegex> > _mPatterns;
+    _QueryRegex::Threads _oThreads;
+};
+
+//==[Query]================================================================
+pjson::Query::Query() {
+
+}
+//-----------------------------------------------------------------
+pjson::Query::Query(const std::string& aPath) {
+    compile(aPath);
+}
+//-----------------------------------------------------------------
+pjson::Query::Query(const Query& aFrom) {
+    *this = aFrom;
+}
+//-----------------------------------------------------------------
+pjson::Query& pjson::Query::operator=(const Query& aFrom) {
+    if(this != &aFrom) {
+        if(aFrom.valid()) {
+            compile(aFrom._sPath);
+        } else {
+            delete _pProgram;
+            _pProgram = nullptr;
+            _sPath = aFrom._sPath;
+            _sError = aFrom._sError;
+        }
+    }
+    return *this;
+}
+//-----------------------------------------------------------------
+pjson::Query::~Query() {
+    delete _pProgram;
+}
+//-----------------------------------------------------------------
+bool pjson::Query::compile(const std::string& aPath) {
+    delete _pProgram;
+    _pProgram = nullptr;
+    _sPath = aPath;
+    Program* pProgram = new Program();
+    Parser oParser(aPath, *pProgram);
+    if(!oParser.parse(_sError)) {
+        delete pProgram;
+        return false;
+    }
+    _pProgram = pProgram;
+    return true;
+}
+//-----------------------------------------------------------------
+bool pjson::Query::valid() const {
+    return nullptr != _pProgram;
+}
+//-----------------------------------------------------------------
+const std::string& pjson::Query::path() const {
+    return _sPath;
+}
+//-----------------------------------------------------------------
+const std::string& pjson::Query::error() const {
+    return _sError;
+}
+//-----------------------------------------------------------------
+template<typename Source, typename Emit>
+bool pjson::Query::_run(Source& a_rSource, Emit& a_rEmit) const {
+    typename Source::Node oRoot;
+    if(nullptr == _pProgram || !a_rSource.root(oRoot)) {
+        return false;
+    }
+    _QueryRun<Source> oRun(a_rSource, oRoot);
+    oRun.path(_pProgram->oPath, oRoot, a_rEmit);
+    return !a_rSource.failed();
+}
+//-----------------------------------------------------------------
+void pjson::Query::select(const pjson& aRoot, std::vector<const pjson*>& a_rResults) const {
+    TreeSource oSource(aRoot);
+    auto fnEmit = [&a_rResults](const pjson* aNode) { a_rResults.push_back(aNode); };
+    _run(oSource, fnEmit);
+}
+//-----------------------------------------------------------------
+pjson* pjson::Query::selectCopy(const pjson& aRoot) const {
+    pjson* pResult = new pjson();
+    pResult->resetTo(jsonArray);
+    TreeSource oSource(aRoot);
+    auto fnEmit = [pResult](const pjson* aNode) {
+        pjson* pCopy = new pjson();
+        pCopy->copyFrom(*aNode);
+        pResult->_pValueArray->push_back(pCopy);
+    };
+    _run(oSource, fnEmit);
+    return pResult;
+}
+//-----------------------------------------------------------------
+bool pjson::Query::select(const char* aSrc, size_t a_iSize, std::vector<pjson*>& a_rResults) const {
+    TextSource oSource(aSrc, a_iSize);
+    auto fnEmit = [&](size_t a_iAt) {
+        if(pjson* pCopy = oSource.copy(a_iAt)) {
+            a_rResults.push_back(pCopy);
+        }
+    };
+    return _run(oSource, fnEmit);
+}
+//-----------------------------------------------------------------
+bool pjson::Query::selectSpans(const char* aSrc, size_t a_iSize, std::vector<Span>& a_rResults) const {
+    TextSource oSource(aSrc, a_iSize);
+    auto fnEmit = [&](size_t a_iAt) {
+        size_t iLength = 0;
+        if(oSource.span(a_iAt, iLength)) {
+            a_rResults.push_back(Span(a_iAt, iLength));
+        }
+    };
+    return _run(oSource, fnEmit);
+}
+//-----------------------------------------------------------------
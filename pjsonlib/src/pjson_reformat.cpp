@@ -0,0 +1,237 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#include "pjson_reformat.h"
+#include "pjson_simd.h"
+using namespace ByteDance;
+
+//-----------------------------------------------------------------
+static inline bool _IsSpace(char aChar) {
+    return ' ' == aChar || '\t' == aChar || '\r' == aChar || '\n' == aChar;
+}
+//-----------------------------------------------------------------
+// Ends a number or literal
+static inline bool _IsDelimiter(char aChar) {
+    switch(aChar) {
+        case ' ': case '\t': case '\r': case '\n':
+        case ',': case ':': case '[': case ']': case '{': case '}': case '\"':
+            return true;
+        default:
+            return false;
+    }
+}
+//-----------------------------------------------------------------
+pjson::Reformatter::Reformatter(std::string& a_rOut, const SerializeOptions& aOptions /*= SerializeOptions()*/)
+        : _oOptions(aOptions)
+        , _rOut(a_rOut)
+{
+
+}
+//-----------------------------------------------------------------
+// Same layout rules as pjson::Writer
+void pjson::Reformatter::_beforeValue() {
+    if(_bAfterKey) {
+        _bAfterKey = false;
+        return;
+    }
+    if(_vFrames.empty()) {
+        if(_bComplete) {
+            _rOut += '\n'; // next top level value
+        }
+        return;
+    }
+    unsigned char& rFrame = _vFrames.back();
+    switch(_oOptions.eStyle) {
+        case SerializeOptions::styleCompact: {
+            if(rFrame & FrameHasItems) {
+                _rOut += ',';
+            }
+            break;
+        }
+        case SerializeOptions::stylePretty: {
+            if(rFrame & FrameHasItems) {
+                _rOut += ',';
+            }
+            pjson::_AppendNewline(_rOut, _oOptions, _vFrames.size());
+            break;
+        }
+        default: {
+            _rOut += (rFrame & FrameHasItems) ? " , " : " ";
+            break;
+        }
+    }
+    rFrame |= FrameHasItems;
+}
+//-----------------------------------------------------------------
+void pjson::Reformatter::_afterValue() {
+    if(_vFrames.empty()) {
+        _bComplete = true;
+    }
+}
+//-----------------------------------------------------------------
+bool pjson::Reformatter::_close(char aBracket) {
+    if(_vFrames.empty() || ('}' == aBracket) != (0 != (_vFrames.back() & FrameObject))) {
+        return false;
+    }
+    bool bHasItems = (_vFrames.back() & FrameHasItems);
+    _vFrames.pop_back();
+    switch(_oOptions.eStyle) {
+        case SerializeOptions::styleCompact: {
+            break;
+        }
+        case SerializeOptions::stylePretty: {
+            if(bHasItems) {
+                pjson::_AppendNewline(_rOut, _oOptions, _vFrames.size());
+            }
+            break;
+        }
+        default: {
+            _rOut += ' ';
+            break;
+        }
+    }
+    _rOut += aBracket;
+    _afterValue();
+    return true;
+}
+//-----------------------------------------------------------------
+bool pjson::Reformatter::feed(const char* aSrc, size_t a_iSize) {
+    if(_bFailed) {
+        return false;
+    }
+    const pjsonKernels& rKernels = pjsonKernels::Active();
+    size_t i = 0;
+    while(i < a_iSize) {
+        switch(_eState) {
+            case stateString: {
+                // copy the run up to the next quote or backslash in one go
+                size_t iFrom = i;
+                i += rKernels.fnFindQuote(aSrc + i, a_iSize - i);
+                _rOut.append(aSrc + iFrom, i - iFrom);
+                if(i < a_iSize) {
+                    _rOut += aSrc[i];
+                    if('\"' == aSrc[i]) {
+                        _eState = stateNone;
+                        _afterValue();
+                    } else {
+                        _eState = stateEscape;
+                    }
+                    ++i;
+                }
+                continue;
+            }
+            case stateEscape: {
+                _rOut += aSrc[i++];
+                _eState = stateString;
+                continue;
+            }
+            case stateScalar: {
+                size_t iFrom = i;
+                while(i < a_iSize && !_IsDelimiter(aSrc[i])) {
+                    ++i;
+                }
+                _rOut.append(aSrc + iFrom, i - iFrom);
+                if(i < a_iSize) {
+                    _eState = stateNone;
+                    _afterValue();
+                }
+                continue;
+            }
+            default: {
+                break;
+            }
+        }
+        char aChar = aSrc[i++];
+        switch(aChar) {
+            case ' ': case '\t': case '\r': case '\n': {
+                // whitespace is rewritten; only long indentation goes to the kernel
+                if(i + 2 < a_iSize && _IsSpace(aSrc[i]) && _IsSpace(aSrc[i + 1]) && _IsSpace(aSrc[i + 2])) {
+                    i += rKernels.fnSkipSpace(aSrc + i, a_iSize - i);
+                }
+                break;
+            }
+            case ',': {
+                break; // commas are regenerated
+            }
+            case '{':
+            case '[': {
+                _beforeValue();
+                _rOut += aChar;
+                _vFrames.push_back('{' == aChar ? FrameObject : 0);
+                break;
+            }
+            case '}':
+            case ']': {
+                if(!_close(aChar)) {
+                    _bFailed = true;
+                    return false;
+                }
+                break;
+            }
+            case ':': {
+                switch(_oOptions.eStyle) {
+                    case SerializeOptions::styleCompact: { _rOut += ':'; break; }
+                    case SerializeOptions::stylePretty:  { _rOut += ": "; break; }
+                    default:                             { _rOut += " : "; break; }
+                }
+                _bAfterKey = true;
+                break;
+            }
+            case '\"': {
+                _beforeValue();
+                _rOut += aChar;
+                _eState = stateString;
+                break;
+            }
+            default: {
+                _beforeValue();
+                _rOut += aChar;
+                _eState = stateScalar;
+                break;
+            }
+        }
+    }
+    return true;
+}
+//-----------------------------------------------------------------
+bool pjson::Reformatter::finish() {
+    if(stateScalar == _eState) {
+        _eState = stateNone;
+        _afterValue();
+    }
+    return !_bFailed && stateNone == _eState && _vFrames.empty() && _bComplete;
+}
+//-----------------------------------------------------------------
+void pjson::Reformatter::reset() {
+    _vFrames.clear();
+    _eState = stateNone;
+    _bAfterKey = false;
+    _bComplete = false;
+    _bFailed = false;
+}
+//-----------------------------------------------------------------
+size_t pjson::Reformatter::depth() const {
+    return _vFrames.size();
+}
+//-----------------------------------------------------------------
+/*static*/
+bool pjson::Reformatter::Reformat(const char* aSrc, size_t a_iSize, std::string& a_rOut, const SerializeOptions& aOptions) {
+    Reformatter oReformatter(a_rOut, aOptions);
+    return oReformatter.feed(aSrc, a_iSize) && oReformatter.finish();
+}
+//-----------------------------------------------------------------
@@ -0,0 +1,75 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#include "pjson_shared.h"
+using namespace ByteDance;
+
+//-----------------------------------------------------------------
+pjson::SharedDocument::SharedDocument()
+        : _iVersion(0)
+{
+
+}
+//-----------------------------------------------------------------
+pjson::SharedDocument::SharedDocument(pjson* aDoc)
+        : _pDoc(aDoc)
+        , _iVersion(1)
+{
+
+}
+//-----------------------------------------------------------------
+void pjson::SharedDocument::publish(pjson* aDoc) {
+    publish(Ptr(aDoc));
+}
+//-----------------------------------------------------------------
+void pjson::SharedDocument::publish(const Ptr& aDoc) {
+    std::atomic_store(&_pDoc, aDoc);
+    // Readers that see the new version are guaranteed to load the new pointer
+    _iVersion.fetch_add(1, std::memory_order_release);
+}
+//-----------------------------------------------------------------
+pjson::SharedDocument::Ptr pjson::SharedDocument::load() const {
+    return std::atomic_load(&_pDoc);
+}
+//-----------------------------------------------------------------
+uint64_t pjson::SharedDocument::version() const {
+    return _iVersion.load(std::memory_order_acquire);
+}
+//-----------------------------------------------------------------
+pjson::SharedDocument::Reader::Reader(const SharedDocument& aDoc)
+        : _rDoc(aDoc)
+{
+    // Version first, so a concurrent publish() is picked up by the next get()
+    _iVersion = aDoc.version();
+    _pCurrent = aDoc.load();
+}
+//-----------------------------------------------------------------
+const pjson::SharedDocument::Ptr& pjson::SharedDocument::Reader::ptr() {
+    uint64_t iVersion = _rDoc.version();
+    if(iVersion != _iVersion) {
+        _pCurrent = _rDoc.load();
+        _iVersion = iVersion;
+    }
+    return _pCurrent;
+}
+//-----------------------------------------------------------------
+const pjson& pjson::SharedDocument::Reader::get() {
+    const Ptr& pDoc = ptr();
+    return pDoc ? *pDoc : pjson::_NullValue();
+}
+//-----------------------------------------------------------------
@@ -0,0 +1,64 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#ifndef PRAVEENJSON_SIMD_H
+#define PRAVEENJSON_SIMD_H
+
+#include <atomic>
+#include <cstddef>
+#include "pjson_cpu.h"
+
+//
+// Internal to the library: one table of byte scanning kernels per
+// pjson::Cpu level, implemented in pjson_cpu.cpp.
+//
+//   const pjsonKernels& rKernels = pjsonKernels::Active();
+//   i += rKernels.fnFindQuote(aSrc + i, a_iEnd - i);
+//
+// The find kernels return the offset of the first byte of interest, or
+// a_iLength when there is none.
+//
+namespace ByteDance {
+//==[Interface]============================================================
+    struct pjsonKernels {
+        size_t (*fnFindQuote)(const char* aSrc, size_t a_iLength);         // '"' or '\\'
+        size_t (*fnFindStringEnd)(const char* aSrc, size_t a_iLength);     // '"', '\\' or a control byte
+        size_t (*fnFindStringSpecial)(const char* aSrc, size_t a_iLength); // as above, or a byte >= 0x80
+        size_t (*fnFindEscape)(const char* aSrc, size_t a_iLength);        // any byte EncodeForJSON rewrites
+        size_t (*fnSkipSpace)(const char* aSrc, size_t a_iLength);         // first byte not ' ', '\t', '\r', '\n'
+        bool (*fnValidUtf8)(const char* aSrc, size_t a_iLength);           // complete, RFC 3629 sequences only
+        // Whole 3 byte groups; returns the input bytes used (a_iLength / 3 * 3)
+        size_t (*fnBase64Encode)(const unsigned char* aSrc, size_t a_iLength, char* aDest);
+        // Leading whole 4 character groups of alphabet characters only (no '=');
+        // returns the characters used, a multiple of 4
+        size_t (*fnBase64Decode)(const char* aSrc, size_t a_iLength, unsigned char* aDest);
+        pjson::Cpu::Level eLevel;
+
+        static const pjsonKernels& Active() {
+            const pjsonKernels* pKernels = _pActive.load(std::memory_order_acquire);
+            return pKernels ? *pKernels : _Select();
+        }
+
+    private:
+        friend struct pjson::Cpu;
+        static const pjsonKernels& _Select();
+        static std::atomic<const pjsonKernels*> _pActive;
+    };
+//========================================================================
+};// end namespace ByteDance
+#endif /* !PRAVEENJSON_SIMD_H */
@@ -0,0 +1,43 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#include "pjson_stats.h"
+#include <cstring>
+using namespace ByteDance;
+
+//-----------------------------------------------------------------
+/*static*/
+pjson::Stats& pjson::Stats::Current() {
+    static thread_local Stats oStats = Stats();
+    return oStats;
+}
+//-----------------------------------------------------------------
+/*static*/
+void pjson::Stats::Reset() {
+    memset(&Current(), 0, sizeof(Stats));
+}
+//-----------------------------------------------------------------
+/*static*/
+bool pjson::Stats::Enabled() {
+#ifdef PJSON_ENABLE_STATS
+    return true;
+#else
+    return false;
+#endif
+}
+//-----------------------------------------------------------------
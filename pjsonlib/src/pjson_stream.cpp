@@ -0,0 +1,622 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#include "pjson_stream.h"
+#include "pjson_context.h"
+#include <chrono>
+#include <cstring>
+#ifndef _WIN32
+#include <fcntl.h>
+#endif
+#ifdef PJSON_HAVE_ZLIB
+#include <zlib.h>
+#endif
+#ifdef PJSON_HAVE_ZSTD
+#include <zstd.h>
+#endif
+using namespace ByteDance;
+
+static const size_t _CompressedChunkSize = 64 * 1024;
+static const size_t _PageSize = 4096; // PrefetchStream buffer alignment
+
+//-----------------------------------------------------------------
+static uint64_t _NowNanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(
+        std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+//-----------------------------------------------------------------
+// Plain file (or stdin)
+class _FileStream : public pjson::InputStream {
+public:
+    _FileStream(FILE* a_pFile, bool a_bOwned) : _pFile(a_pFile), _bOwned(a_bOwned) {}
+    ~_FileStream() override {
+        if(_bOwned) {
+            fclose(_pFile);
+        }
+    }
+    size_t read(char* aBuffer, size_t a_iSize) override {
+        return fread(aBuffer, 1, a_iSize, _pFile);
+    }
+    bool failed() const override {
+        return 0 != ferror(_pFile);
+    }
+
+private:
+    FILE* _pFile;
+    bool _bOwned;
+};
+
+//-----------------------------------------------------------------
+class _MemoryStream : public pjson::InputStream {
+public:
+    _MemoryStream(const char* aData, size_t a_iSize) : _pData(aData), _iSize(a_iSize) {}
+    size_t read(char* aBuffer, size_t a_iSize) override {
+        size_t iCopy = _iSize - _iPos;
+        if(iCopy > a_iSize) {
+            iCopy = a_iSize;
+        }
+        memcpy(aBuffer, _pData + _iPos, iCopy);
+        _iPos += iCopy;
+        return iCopy;
+    }
+    bool failed() const override {
+        return false;
+    }
+
+private:
+    const char* _pData;
+    size_t _iSize;
+    size_t _iPos = 0;
+};
+
+#ifdef PJSON_HAVE_ZLIB
+//-----------------------------------------------------------------
+// gzip (including concatenated members) or zlib
+class _GzipStream : public pjson::InputStream {
+public:
+    explicit _GzipStream(pjson::InputStream* a_pSource) : _pSource(a_pSource), _vIn(_CompressedChunkSize) {
+        memset(&_oStream, 0, sizeof(_oStream));
+        _bFailed = (Z_OK != inflateInit2(&_oStream, 15 + 32)); // 32: detect the gzip / zlib header
+    }
+    ~_GzipStream() override {
+        inflateEnd(&_oStream);
+        delete _pSource;
+    }
+    size_t read(char* aBuffer, size_t a_iSize) override {
+        if(_bEnd || _bFailed || 0 == a_iSize) {
+            return 0;
+        }
+        _oStream.next_out = reinterpret_cast<Bytef*>(aBuffer);
+        _oStream.avail_out = static_cast<uInt>(a_iSize < UINT32_MAX ? a_iSize : UINT32_MAX);
+        const uInt iOutSize = _oStream.avail_out;
+        while(iOutSize == _oStream.avail_out) {
+            if(0 == _oStream.avail_in && !_bSourceEnd) {
+                size_t iRead = _pSource->read(_vIn.data(), _vIn.size());
+                if(0 == iRead) {
+                    _bSourceEnd = true;
+                    _bFailed = _pSource->failed();
+                }
+                _oStream.next_in = reinterpret_cast<Bytef*>(_vIn.data());
+                _oStream.avail_in = static_cast<uInt>(iRead);
+            }
+            int iResult = inflate(&_oStream, Z_NO_FLUSH);
+            if(Z_STREAM_END == iResult) {
+                _bInMember = false;
+                inflateReset(&_oStream); // another member may follow
+            } else if(Z_OK == iResult) {
+                _bInMember = true;
+            } else if(Z_BUF_ERROR == iResult && _bSourceEnd) {
+                _bFailed = _bFailed || _bInMember; // truncated
+                _bEnd = true;
+                break;
+            } else if(Z_BUF_ERROR != iResult) {
+                _bFailed = true;
+                break;
+            }
+        }
+        return iOutSize - _oStream.avail_out;
+    }
+    bool failed() const override {
+        return _bFailed;
+    }
+
+private:
+    pjson::InputStream* _pSource;
+    std::vector<char> _vIn;
+    z_stream _oStream;
+    bool _bInMember = false;
+    bool _bSourceEnd = false;
+    bool _bEnd = false;
+    bool _bFailed = false;
+};
+#endif
+
+#ifdef PJSON_HAVE_ZSTD
+//-----------------------------------------------------------------
+class _ZstdStream : public pjson::InputStream {
+public:
+    explicit _ZstdStream(pjson::InputStream* a_pSource)
+            : _pSource(a_pSource), _vIn(ZSTD_DStreamInSize()), _pContext(ZSTD_createDCtx()) {
+        _bFailed = (nullptr == _pContext);
+    }
+    ~_ZstdStream() override {
+        ZSTD_freeDCtx(_pContext);
+        delete _pSource;
+    }
+    size_t read(char* aBuffer, size_t a_iSize) override {
+        if(_bEnd || _bFailed || 0 == a_iSize) {
+            return 0;
+        }
+        ZSTD_outBuffer oOut = { aBuffer, a_iSize, 0 };
+        while(0 == oOut.pos) {
+            if(_oIn.pos == _oIn.size && !_bSourceEnd) {
+                size_t iRead = _pSource->read(_vIn.data(), _vIn.size());
+                if(0 == iRead) {
+                    _bSourceEnd = true;
+                    _bFailed = _pSource->failed();
+                }
+                _oIn.src = _vIn.data();
+                _oIn.size = iRead;
+                _oIn.pos = 0;
+            }
+            size_t iInPos = _oIn.pos;
+            size_t iResult = ZSTD_decompressStream(_pContext, &oOut, &_oIn);
+            if(ZSTD_isError(iResult)) {
+                _bFailed = true;
+                break;
+            }
+            if(iInPos != _oIn.pos || 0 != oOut.pos) {
+                _iPending = iResult; // 0 once a frame is complete and flushed
+            }
+            if(0 == oOut.pos && _bSourceEnd && _oIn.pos == _oIn.size) {
+                _bFailed = _bFailed || (0 != _iPending); // truncated
+                _bEnd = true;
+                break;
+            }
+        }
+        return oOut.pos;
+    }
+    bool failed() const override {
+        return _bFailed;
+    }
+
+private:
+    pjson::InputStream* _pSource;
+    std::vector<char> _vIn;
+    ZSTD_DCtx* _pContext;
+    ZSTD_inBuffer _oIn = { nullptr, 0, 0 };
+    size_t _iPending = 0;
+    bool _bSourceEnd = false;
+    bool _bEnd = false;
+    bool _bFailed = false;
+};
+#endif
+
+//-----------------------------------------------------------------
+/*static*/
+bool pjson::InputStream::Supports(Compression aeCompression) {
+    switch(aeCompression) {
+        case compressionNone: return true;
+#ifdef PJSON_HAVE_ZLIB
+        case compressionGzip: return true;
+#endif
+#ifdef PJSON_HAVE_ZSTD
+        case compressionZstd: return true;
+#endif
+        default: return false;
+    }
+}
+//-----------------------------------------------------------------
+/*static*/
+pjson::InputStream* pjson::InputStream::FromFile(FILE* a_pFile) {
+    return new _FileStream(a_pFile, false);
+}
+//-----------------------------------------------------------------
+/*static*/
+pjson::InputStream* pjson::InputStream::FromMemory(const char* aData, size_t a_iSize) {
+    return new _MemoryStream(aData, a_iSize);
+}
+//-----------------------------------------------------------------
+/*static*/
+pjson::InputStream* pjson::InputStream::Decompress(InputStream* a_pSource, Compression aeCompression) {
+    switch(aeCompression) {
+        case compressionNone: return a_pSource;
+#ifdef PJSON_HAVE_ZLIB
+        case compressionGzip: return new _GzipStream(a_pSource);
+#endif
+#ifdef PJSON_HAVE_ZSTD
+        case compressionZstd: return new _ZstdStream(a_pSource);
+#endif
+        default: {
+            delete a_pSource;
+            return nullptr;
+        }
+    }
+}
+//-----------------------------------------------------------------
+/*static*/
+pjson::InputStream* pjson::InputStream::Open(const char* aPath) {
+    FILE* pFile = fopen(aPath, "rb");
+    if(nullptr == pFile) {
+        return nullptr;
+    }
+#ifdef POSIX_FADV_SEQUENTIAL
+    posix_fadvise(fileno(pFile), 0, 0, POSIX_FADV_SEQUENTIAL); // larger kernel read-ahead
+#endif
+    unsigned char aMagic[4] = { 0, 0, 0, 0 };
+    size_t iMagic = fread(aMagic, 1, sizeof(aMagic), pFile);
+    rewind(pFile);
+    Compression eCompression = compressionNone;
+    if(iMagic >= 2 && 0x1F == aMagic[0] && 0x8B == aMagic[1]) {
+        eCompression = compressionGzip;
+    } else if(iMagic >= 4 && 0x28 == aMagic[0] && 0xB5 == aMagic[1] && 0x2F == aMagic[2] && 0xFD == aMagic[3]) {
+        eCompression = compressionZstd;
+    }
+    return Decompress(new _FileStream(pFile, true), eCompression);
+}
+//-----------------------------------------------------------------
+pjson::PrefetchStream::PrefetchStream(InputStream& a_rSource, size_t a_iChunkSize /*= 256 * 1024*/, size_t a_iChunks /*= 4*/)
+        : _rSource(a_rSource)
+        , _iChunkSize(((a_iChunkSize ? a_iChunkSize : 1) + _PageSize - 1) & ~(_PageSize - 1))
+        , _vSizes(a_iChunks < 2 ? 2 : a_iChunks, 0)
+{
+    _vStorage.resize(_vSizes.size() * _iChunkSize + _PageSize - 1);
+    _pChunks = reinterpret_cast<char*>((reinterpret_cast<uintptr_t>(_vStorage.data()) + _PageSize - 1) & ~uintptr_t(_PageSize - 1));
+    _oThread = std::thread(&PrefetchStream::_produce, this);
+}
+//-----------------------------------------------------------------
+pjson::PrefetchStream::~PrefetchStream() {
+    {
+        std::lock_guard<std::mutex> oLock(_oMutex);
+        _bStop = true;
+    }
+    _oCondition.notify_all();
+    _oThread.join();
+}
+//-----------------------------------------------------------------
+void pjson::PrefetchStream::_produce() {
+    const size_t iChunks = _vSizes.size();
+    for(;;) {
+        size_t iChunk = 0;
+        {
+            std::unique_lock<std::mutex> oLock(_oMutex);
+            if(!_bStop && iChunks == _iFilled) {
+                uint64_t iWaitStart = _NowNanos();
+                _oCondition.wait(oLock, [this, iChunks]() { return _bStop || _iFilled < iChunks; });
+                _oReaderStats.iReaderWaitNanos += _NowNanos() - iWaitStart;
+            }
+            if(_bStop) {
+                return;
+            }
+            iChunk = _iHead;
+        }
+        uint64_t iReadStart = _NowNanos();
+        size_t iSize = _rSource.read(_pChunks + iChunk * _iChunkSize, _iChunkSize);
+        uint64_t iReadNanos = _NowNanos() - iReadStart;
+        {
+            std::lock_guard<std::mutex> oLock(_oMutex);
+            _oReaderStats.iReadNanos += iReadNanos;
+            if(0 == iSize) {
+                _bEnd = true;
+                _bFailed = _rSource.failed();
+            } else {
+                _vSizes[iChunk] = iSize;
+                _iHead = (_iHead + 1) % iChunks;
+                ++_iFilled;
+                ++_oReaderStats.iChunks;
+            }
+        }
+        _oCondition.notify_all();
+        if(0 == iSize) {
+            return;
+        }
+    }
+}
+//-----------------------------------------------------------------
+size_t pjson::PrefetchStream::read(char* aBuffer, size_t a_iSize) {
+    uint64_t iEnter = _NowNanos();
+    if(0 != _iLastReturn) {
+        _oConsumerStats.iConsumeNanos += iEnter - _iLastReturn;
+    }
+    size_t iCopied = 0;
+    while(iCopied < a_iSize) {
+        if(!_bReading) {
+            std::unique_lock<std::mutex> oLock(_oMutex);
+            if(0 == _iFilled) {
+                if(0 != iCopied || _bEnd) {
+                    break; // hand over what we have rather than wait
+                }
+                uint64_t iWaitStart = _NowNanos();
+                _oCondition.wait(oLock, [this]() { return _bEnd || 0 != _iFilled; });
+                ++_oConsumerStats.iWaits;
+                _oConsumerStats.iWaitNanos += _NowNanos() - iWaitStart;
+                if(0 == _iFilled) {
+                    break;
+                }
+            }
+            _bReading = true;
+            _iTailPos = 0;
+        }
+        const size_t iChunkBytes = _vSizes[_iTail];
+        size_t iCopy = iChunkBytes - _iTailPos;
+        if(iCopy > a_iSize - iCopied) {
+            iCopy = a_iSize - iCopied;
+        }
+        memcpy(aBuffer + iCopied, _pChunks + _iTail * _iChunkSize + _iTailPos, iCopy);
+        iCopied += iCopy;
+        _iTailPos += iCopy;
+        if(_iTailPos == iChunkBytes) {
+            {
+                std::lock_guard<std::mutex> oLock(_oMutex);
+                _iTail = (_iTail + 1) % _vSizes.size();
+                --_iFilled;
+            }
+            _oCondition.notify_all();
+            _bReading = false;
+        }
+    }
+    _oConsumerStats.iBytes += iCopied;
+    _iLastReturn = _NowNanos();
+    return iCopied;
+}
+//-----------------------------------------------------------------
+bool pjson::PrefetchStream::failed() const {
+    std::lock_guard<std::mutex> oLock(_oMutex);
+    return _bFailed;
+}
+//-----------------------------------------------------------------
+pjson::PrefetchStream::Stats pjson::PrefetchStream::stats() const {
+    Stats oStats = _oConsumerStats;
+    std::lock_guard<std::mutex> oLock(_oMutex);
+    oStats.iChunks = _oReaderStats.iChunks;
+    oStats.iReadNanos = _oReaderStats.iReadNanos;
+    oStats.iReaderWaitNanos = _oReaderStats.iReaderWaitNanos;
+    return oStats;
+}
+//-----------------------------------------------------------------
+pjson::RecordReader::RecordReader(InputStream& a_rSource, Mode aeMode /*= modeAuto*/, size_t a_iChunkSize /*= 64 * 1024*/)
+        : _rSource(a_rSource)
+        , _eMode(aeMode)
+        , _iChunkSize(a_iChunkSize ? a_iChunkSize : 1)
+        , _iMaxRecordSize(256 * 1024 * 1024)
+{
+
+}
+//-----------------------------------------------------------------
+// Appends the next chunk; drops consumed bytes first so the buffer holds at
+// most the current partial record plus one chunk
+bool pjson::RecordReader::_fill() {
+    if(_iBegin > 0) {
+        size_t iKeep = _vBuffer.size() - _iBegin;
+        memmove(_vBuffer.data(), _vBuffer.data() + _iBegin, iKeep);
+        _vBuffer.resize(iKeep);
+        _iDiscarded += _iBegin;
+        _iScan -= _iBegin;
+        _iBegin = 0;
+    }
+    size_t iOld = _vBuffer.size();
+    _vBuffer.resize(iOld + _iChunkSize);
+    size_t iRead = _rSource.read(_vBuffer.data() + iOld, _iChunkSize);
+    _vBuffer.resize(iOld + iRead);
+    if(0 == iRead) {
+        _bEof = true;
+        _bFailed = _bFailed || _rSource.failed();
+    }
+    return 0 != iRead;
+}
+//-----------------------------------------------------------------
+// Advances the scanner over the buffered bytes; true with the record's end
+// in a_rEnd (its start is _iBegin) once a complete record has been seen
+bool pjson::RecordReader::_scanRecord(size_t& a_rEnd) {
+    const char* pData = _vBuffer.data();
+    const size_t iSize = _vBuffer.size();
+    while(_iScan < iSize) {
+        char aChar = pData[_iScan];
+        if(!_bInRecord) {
+            if(' ' == aChar || '\n' == aChar || '\r' == aChar || '\t' == aChar) {
+                _iBegin = ++_iScan;
+                continue;
+            }
+            if(modeAuto == _eMode) {
+                _eMode = ('[' == aChar) ? modeArray : modeValues;
+            }
+            if(modeArray == _eMode) {
+                if(_bClosed || (!_bStarted && '[' != aChar)) {
+                    _bFailed = true;
+                    return false;
+                }
+                if(!_bStarted || ',' == aChar || ']' == aChar) {
+                    _bClosed = (']' == aChar);
+                    _bStarted = true;
+                    _iBegin = ++_iScan;
+                    continue;
+                }
+            }
+            _bInRecord = true;
+            _iBegin = _iScan++;
+            if('{' == aChar || '[' == aChar) {
+                _iDepth = 1;
+            } else if('\"' == aChar) {
+                _bInString = true;
+            } else {
+                _bScalar = true;
+            }
+            continue;
+        }
+        if(_bScalar) {
+            switch(aChar) {
+                case ' ': case '\t': case '\r': case '\n':
+                case ',': case ':': case '[': case ']': case '{': case '}': case '\"': {
+                    _bScalar = false;
+                    _bInRecord = false;
+                    a_rEnd = _iScan;
+                    return true;
+                }
+                default: {
+                    ++_iScan;
+                    continue;
+                }
+            }
+        }
+        if(_bInString) {
+            if(_bEscape) {
+                _bEscape = false;
+                ++_iScan;
+                continue;
+            }
+            while(_iScan < iSize && '\"' != pData[_iScan] && '\\' != pData[_iScan]) {
+                ++_iScan;
+            }
+            if(_iScan == iSize) {
+                break;
+            }
+            if('\\' == pData[_iScan++]) {
+                _bEscape = true;
+                continue;
+            }
+            _bInString = false;
+        } else {
+            ++_iScan;
+            if('\"' == aChar) {
+                _bInString = true;
+                continue;
+            } else if('{' == aChar || '[' == aChar) {
+                ++_iDepth;
+                continue;
+            } else if('}' == aChar || ']' == aChar) {
+                --_iDepth;
+            } else {
+                continue;
+            }
+        }
+        if(0 == _iDepth) {
+            _bInRecord = false;
+            a_rEnd = _iScan;
+            return true;
+        }
+    }
+    return false;
+}
+//-----------------------------------------------------------------
+bool pjson::RecordReader::nextText(const char*& a_rText, size_t& a_rLength) {
+    while(!_bFailed) {
+        size_t iEnd = 0;
+        bool bRecord = _scanRecord(iEnd);
+        if(!bRecord && _bEof && _bScalar) {
+            // a number or literal ends with the input
+            _bScalar = false;
+            _bInRecord = false;
+            iEnd = _iScan;
+            bRecord = true;
+        }
+        if(bRecord) {
+            a_rText = _vBuffer.data() + _iBegin;
+            a_rLength = iEnd - _iBegin;
+            _iOffset = _iDiscarded + _iBegin;
+            _iBegin = iEnd;
+            ++_iRecords;
+            return true;
+        }
+        if(_bFailed) {
+            break;
+        }
+        if(_bEof) {
+            // truncated record or array
+            _bFailed = _bInRecord || (modeArray == _eMode && _bStarted && !_bClosed);
+            break;
+        }
+        if(_vBuffer.size() - _iBegin > _iMaxRecordSize) {
+            _bFailed = true;
+            break;
+        }
+        _fill();
+    }
+    return false;
+}
+//-----------------------------------------------------------------
+pjson* pjson::RecordReader::_parseNext(ParseContext* a_pContext) {
+    const char* pText = nullptr;
+    size_t iLength = 0;
+    if(!nextText(pText, iLength)) {
+        return nullptr;
+    }
+    pjson* pResult = nullptr;
+    if(_pProjection) {
+        pResult = a_pContext ? pjson::CreateFromString(pText, iLength, *_pProjection, *a_pContext)
+                             : pjson::CreateFromString(pText, iLength, *_pProjection);
+    } else {
+        pResult = a_pContext ? pjson::CreateFromString(pText, iLength, *a_pContext)
+                             : pjson::CreateFromString(pText, iLength);
+    }
+    if(nullptr == pResult) {
+        _bFailed = true;
+    }
+    return pResult;
+}
+//-----------------------------------------------------------------
+pjson* pjson::RecordReader::next() {
+    return _parseNext(nullptr);
+}
+//-----------------------------------------------------------------
+pjson* pjson::RecordReader::next(ParseContext& a_rContext) {
+    return _parseNext(&a_rContext);
+}
+//-----------------------------------------------------------------
+bool pjson::RecordReader::failed() const {
+    return _bFailed;
+}
+//-----------------------------------------------------------------
+size_t pjson::RecordReader::records() const {
+    return _iRecords;
+}
+//-----------------------------------------------------------------
+size_t pjson::RecordReader::offset() const {
+    return _iOffset;
+}
+//-----------------------------------------------------------------
+void pjson::RecordReader::setMaxRecordSize(size_t a_iBytes) {
+    _iMaxRecordSize = a_iBytes;
+}
+//-----------------------------------------------------------------
+void pjson::RecordReader::setProjection(const Projection* aFields) {
+    _pProjection = aFields;
+}
+//-----------------------------------------------------------------
+/*static*/
+pjson* pjson::CreateFromStream(InputStream& a_rSource) {
+    std::string sText;
+    size_t iChunk = 64 * 1024;
+    for(;;) {
+        size_t iOld = sText.size();
+        sText.resize(iOld + iChunk);
+        size_t iRead = a_rSource.read(&sText[iOld], iChunk);
+        sText.resize(iOld + iRead);
+        if(0 == iRead) {
+            break;
+        }
+        if(sText.size() >= 4 * iChunk) {
+            iChunk *= 2;
+        }
+    }
+    if(a_rSource.failed()) {
+        return nullptr;
+    }
+    return CreateFromString(sText.c_str(), sText.length());
+}
+//-----------------------------------------------------------------
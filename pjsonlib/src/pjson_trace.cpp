@@ -0,0 +1,175 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#include "pjson_trace.h"
+#include <atomic>
+using namespace ByteDance;
+
+#if defined(PJSON_ENABLE_TRACE) && defined(PJSON_HAVE_SDT)
+// Semaphores let a probe report whether a tracer is attached, so spans are
+// only timed while someone looks (see Active())
+#define _SDT_HAS_SEMAPHORES 1
+#include <sys/sdt.h>
+#define PJSON_PROBE_SEMAPHORE(NAME) \
+    __extension__ unsigned short pjson_##NAME##_semaphore __attribute__((unused)) __attribute__((section(".probes")))
+PJSON_PROBE_SEMAPHORE(parse__start);
+PJSON_PROBE_SEMAPHORE(parse__done);
+PJSON_PROBE_SEMAPHORE(serialize__done);
+PJSON_PROBE_SEMAPHORE(copy__done);
+PJSON_PROBE_SEMAPHORE(destroy__done);
+#define PJSON_PROBE_ATTACHED(NAME) (0 != *static_cast<volatile unsigned short*>(&pjson_##NAME##_semaphore))
+#endif
+
+//-----------------------------------------------------------------
+static std::atomic<pjson::Trace::Listener*>& _Listener() {
+    static std::atomic<pjson::Trace::Listener*> pListener(nullptr);
+    return pListener;
+}
+//-----------------------------------------------------------------
+static std::atomic<size_t>& _DestroyThreshold() {
+    static std::atomic<size_t> iThreshold(1024);
+    return iThreshold;
+}
+//-----------------------------------------------------------------
+/*static*/
+void pjson::Trace::SetListener(Listener* a_pListener) {
+    _Listener().store(a_pListener, std::memory_order_release);
+}
+//-----------------------------------------------------------------
+/*static*/
+pjson::Trace::Listener* pjson::Trace::GetListener() {
+    return _Listener().load(std::memory_order_acquire);
+}
+//-----------------------------------------------------------------
+/*static*/
+void pjson::Trace::SetDestroyThreshold(size_t a_iChildren) {
+    _DestroyThreshold().store(a_iChildren, std::memory_order_relaxed);
+}
+//-----------------------------------------------------------------
+/*static*/
+size_t pjson::Trace::DestroyThreshold() {
+    return _DestroyThreshold().load(std::memory_order_relaxed);
+}
+//-----------------------------------------------------------------
+/*static*/
+bool pjson::Trace::Enabled() {
+#ifdef PJSON_ENABLE_TRACE
+    return true;
+#else
+    return false;
+#endif
+}
+//-----------------------------------------------------------------
+/*static*/
+bool pjson::Trace::Probes() {
+#if defined(PJSON_ENABLE_TRACE) && defined(PJSON_HAVE_SDT)
+    return true;
+#else
+    return false;
+#endif
+}
+//-----------------------------------------------------------------
+/*static*/
+bool pjson::Trace::Active() {
+#ifdef PJSON_ENABLE_TRACE
+    if(nullptr != _Listener().load(std::memory_order_relaxed)) {
+        return true;
+    }
+#ifdef PJSON_HAVE_SDT
+    return PJSON_PROBE_ATTACHED(parse__start) || PJSON_PROBE_ATTACHED(parse__done)
+        || PJSON_PROBE_ATTACHED(serialize__done) || PJSON_PROBE_ATTACHED(copy__done)
+        || PJSON_PROBE_ATTACHED(destroy__done);
+#endif
+#endif
+    return false;
+}
+//-----------------------------------------------------------------
+/*static*/
+const char* pjson::Trace::Name(Event aeEvent) {
+    switch(aeEvent) {
+        case eventParse:     { return "parse"; }
+        case eventSerialize: { return "serialize"; }
+        case eventCopy:      { return "copy"; }
+        case eventDestroy:   { return "destroy"; }
+        default:             { return "unknown"; }
+    }
+}
+//-----------------------------------------------------------------
+/*static*/
+void pjson::Trace::_Begin(const Span& aSpan) {
+#if defined(PJSON_ENABLE_TRACE) && defined(PJSON_HAVE_SDT)
+    if(eventParse == aSpan.eEvent) {
+        STAP_PROBE1(pjson, parse__start, aSpan.iBytes);
+    }
+#endif
+    if(Listener* pListener = GetListener()) {
+        pListener->onBegin(aSpan);
+    }
+}
+//-----------------------------------------------------------------
+/*static*/
+void pjson::Trace::_End(const Span& aSpan) {
+#if defined(PJSON_ENABLE_TRACE) && defined(PJSON_HAVE_SDT)
+    switch(aSpan.eEvent) {
+        case eventParse:     { STAP_PROBE4(pjson, parse__done, aSpan.iBytes, aSpan.iNodes, aSpan.iNanos, aSpan.bSuccess ? 1 : 0); break; }
+        case eventSerialize: { STAP_PROBE3(pjson, serialize__done, aSpan.iBytes, aSpan.iNodes, aSpan.iNanos); break; }
+        case eventCopy:      { STAP_PROBE2(pjson, copy__done, aSpan.iNodes, aSpan.iNanos); break; }
+        case eventDestroy:   { STAP_PROBE2(pjson, destroy__done, aSpan.iNodes, aSpan.iNanos); break; }
+    }
+#endif
+    if(Listener* pListener = GetListener()) {
+        pListener->onEnd(aSpan);
+    }
+}
+#ifdef PJSON_ENABLE_TRACE
+//-----------------------------------------------------------------
+/*static*/
+uint64_t pjsonTraceSpan::CountNodes(const pjson* a_pNode) {
+    if(nullptr == a_pNode) {
+        return 0;
+    }
+    uint64_t iNodes = 1;
+    if(pjson::jsonArray == a_pNode->getType()) {
+        for(const pjson* pItem : *a_pNode->getArray()) {
+            iNodes += CountNodes(pItem);
+        }
+    } else if(pjson::jsonMap == a_pNode->getType()) {
+        for(const auto& rMember : *a_pNode->getMap()) {
+            iNodes += CountNodes(rMember.second);
+        }
+    }
+    return iNodes;
+}
+//-----------------------------------------------------------------
+static thread_local bool _bInDestroy = false;
+//-----------------------------------------------------------------
+/*static*/
+bool pjsonTraceDestroy::_Claim(size_t a_iChildren) {
+    if(a_iChildren < pjson::Trace::DestroyThreshold() || _bInDestroy || !pjson::Trace::Active()) {
+        return false;
+    }
+    _bInDestroy = true;
+    return true;
+}
+//-----------------------------------------------------------------
+/*static*/
+void pjsonTraceDestroy::_Release() {
+    _bInDestroy = false;
+}
+#endif // PJSON_ENABLE_TRACE
+//-----------------------------------------------------------------
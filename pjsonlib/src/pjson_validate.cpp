@@ -0,0 +1,372 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#include "pjson_validate.h"
+#include "pjson_simd.h"
+#include <cstdint>
+#include <cstring>
+using namespace ByteDance;
+
+typedef pjson::ValidateResult::Error ValidateError;
+
+//-----------------------------------------------------------------
+static inline bool _IsSpace(char aChar) {
+    return ' ' == aChar || '\n' == aChar || '\r' == aChar || '\t' == aChar;
+}
+//-----------------------------------------------------------------
+static inline void _SkipWhitespace(const char* aSrc, size_t& a_iPos, const size_t a_iEnd) {
+    // Most gaps are empty or a single space; only runs (indentation) go to the kernel
+    if(a_iPos < a_iEnd && _IsSpace(aSrc[a_iPos])) {
+        ++a_iPos;
+        if(a_iPos < a_iEnd && _IsSpace(aSrc[a_iPos])) {
+            a_iPos += pjsonKernels::Active().fnSkipSpace(aSrc + a_iPos, a_iEnd - a_iPos);
+        }
+    }
+}
+//-----------------------------------------------------------------
+static inline bool _IsHex(unsigned char aChar) {
+    return ('0' <= aChar && '9' >= aChar) || ('a' <= aChar && 'f' >= aChar) || ('A' <= aChar && 'F' >= aChar);
+}
+//-----------------------------------------------------------------
+// One multi-byte UTF-8 sequence starting at a_iPos (RFC 3629: no overlongs,
+// no surrogates, nothing above U+10FFFF)
+static ValidateError _ValidateUtf8(const unsigned char* aSrc, size_t& a_iPos, const size_t a_iEnd) {
+    unsigned char cLead = aSrc[a_iPos];
+    size_t iFollow = 0;
+    unsigned char cMin = 0x80;
+    unsigned char cMax = 0xBF;
+    if(cLead >= 0xC2 && cLead <= 0xDF) {
+        iFollow = 1;
+    } else if(cLead >= 0xE0 && cLead <= 0xEF) {
+        iFollow = 2;
+        if(0xE0 == cLead) {
+            cMin = 0xA0;
+        } else if(0xED == cLead) {
+            cMax = 0x9F;
+        }
+    } else if(cLead >= 0xF0 && cLead <= 0xF4) {
+        iFollow = 3;
+        if(0xF0 == cLead) {
+            cMin = 0x90;
+        } else if(0xF4 == cLead) {
+            cMax = 0x8F;
+        }
+    } else {
+        return pjson::ValidateResult::errInvalidUtf8;
+    }
+    if(a_iPos + iFollow >= a_iEnd) {
+        return pjson::ValidateResult::errUnexpectedEnd;
+    }
+    for(size_t i = 1; i <= iFollow; ++i) {
+        unsigned char cNext = aSrc[a_iPos + i];
+        if(cNext < cMin || cNext > cMax) {
+            a_iPos += i;
+            return pjson::ValidateResult::errInvalidUtf8;
+        }
+        cMin = 0x80;
+        cMax = 0xBF;
+    }
+    a_iPos += iFollow + 1;
+    return pjson::ValidateResult::errNone;
+}
+//-----------------------------------------------------------------
+// a_iPos is on the opening quote; on success it is just past the closing one
+static ValidateError _ValidateString(const char* aSrc, size_t& a_iPos, const size_t a_iEnd) {
+    const unsigned char* pSrc = reinterpret_cast<const unsigned char*>(aSrc);
+    const pjsonKernels& rKernels = pjsonKernels::Active();
+    ++a_iPos;
+    for(;;) {
+        // Skip bytes that need no attention ('"', '\\', control or non-ASCII)
+        a_iPos += rKernels.fnFindStringSpecial(aSrc + a_iPos, a_iEnd - a_iPos);
+        if(a_iPos >= a_iEnd) {
+            return pjson::ValidateResult::errUnexpectedEnd;
+        }
+        unsigned char cChar = pSrc[a_iPos];
+        if('\"' == cChar) {
+            ++a_iPos;
+            return pjson::ValidateResult::errNone;
+        } else if('\\' == cChar) {
+            if(a_iPos + 1 >= a_iEnd) {
+                return pjson::ValidateResult::errUnexpectedEnd;
+            }
+            switch(pSrc[a_iPos + 1]) {
+                case '\"': case '\\': case '/': case 'b': case 'f': case 'n': case 'r': case 't': {
+                    a_iPos += 2;
+                    break;
+                }
+                case 'u': {
+                    for(size_t i = 2; i < 6; ++i) {
+                        if(a_iPos + i >= a_iEnd) {
+                            return pjson::ValidateResult::errUnexpectedEnd;
+                        }
+                        if(!_IsHex(pSrc[a_iPos + i])) {
+                            a_iPos += i;
+                            return pjson::ValidateResult::errInvalidEscape;
+                        }
+                    }
+                    a_iPos += 6;
+                    break;
+                }
+                default: {
+                    ++a_iPos;
+                    return pjson::ValidateResult::errInvalidEscape;
+                }
+            }
+        } else if(cChar < 0x20) {
+            return pjson::ValidateResult::errControlChar;
+        } else if(cChar < 0x80) {
+            ++a_iPos;
+        } else {
+            // Check the run up to the next '"', '\\' or control byte in one go,
+            // and only walk it sequence by sequence to report an error
+            size_t iRunEnd = a_iPos + rKernels.fnFindStringEnd(aSrc + a_iPos, a_iEnd - a_iPos);
+            if(rKernels.fnValidUtf8(aSrc + a_iPos, iRunEnd - a_iPos)) {
+                a_iPos = iRunEnd;
+                continue;
+            }
+            while(a_iPos < iRunEnd) {
+                if(pSrc[a_iPos] < 0x80) {
+                    ++a_iPos;
+                    continue;
+                }
+                ValidateError eError = _ValidateUtf8(pSrc, a_iPos, a_iEnd);
+                if(pjson::ValidateResult::errNone != eError) {
+                    return eError;
+                }
+            }
+        }
+    }
+}
+//-----------------------------------------------------------------
+static ValidateError _ValidateNumber(const char* aSrc, size_t& a_iPos, const size_t a_iEnd) {
+    auto fnDigits = [&]() {
+        size_t iFrom = a_iPos;
+        while(a_iPos < a_iEnd && '0' <= aSrc[a_iPos] && '9' >= aSrc[a_iPos]) {
+            ++a_iPos;
+        }
+        return a_iPos - iFrom;
+    };
+    auto fnFail = [&]() {
+        return a_iPos >= a_iEnd ? pjson::ValidateResult::errUnexpectedEnd : pjson::ValidateResult::errInvalidNumber;
+    };
+    if('-' == aSrc[a_iPos]) {
+        ++a_iPos;
+    }
+    if(a_iPos < a_iEnd && '0' == aSrc[a_iPos]) {
+        ++a_iPos;
+    } else if(0 == fnDigits()) {
+        return fnFail();
+    }
+    if(a_iPos < a_iEnd && '.' == aSrc[a_iPos]) {
+        ++a_iPos;
+        if(0 == fnDigits()) {
+            return fnFail();
+        }
+    }
+    if(a_iPos < a_iEnd && ('e' == aSrc[a_iPos] || 'E' == aSrc[a_iPos])) {
+        ++a_iPos;
+        if(a_iPos < a_iEnd && ('+' == aSrc[a_iPos] || '-' == aSrc[a_iPos])) {
+            ++a_iPos;
+        }
+        if(0 == fnDigits()) {
+            return fnFail();
+        }
+    }
+    return pjson::ValidateResult::errNone;
+}
+//-----------------------------------------------------------------
+static ValidateError _ValidateLiteral(const char* aSrc, size_t& a_iPos, const size_t a_iEnd,
+                                      const char* aLiteral, size_t a_iLength) {
+    for(size_t i = 0; i < a_iLength; ++i, ++a_iPos) {
+        if(a_iPos >= a_iEnd) {
+            return pjson::ValidateResult::errUnexpectedEnd;
+        }
+        if(aLiteral[i] != aSrc[a_iPos]) {
+            return pjson::ValidateResult::errInvalidLiteral;
+        }
+    }
+    return pjson::ValidateResult::errNone;
+}
+//-----------------------------------------------------------------
+/*static*/
+const char* pjson::ValidateResult::ErrorName(Error aeError) {
+    switch(aeError) {
+        case errNone:           return "none";
+        case errEmpty:          return "empty input";
+        case errUnexpectedEnd:  return "unexpected end of input";
+        case errUnexpectedChar: return "unexpected character";
+        case errInvalidLiteral: return "invalid literal";
+        case errInvalidNumber:  return "invalid number";
+        case errInvalidEscape:  return "invalid escape sequence";
+        case errControlChar:    return "unescaped control character";
+        case errInvalidUtf8:    return "invalid UTF-8";
+        case errTooDeep:        return "nesting too deep";
+        case errTrailingData:   return "trailing data";
+    }
+    return "unknown";
+}
+//-----------------------------------------------------------------
+/*static*/
+pjson::ValidateResult pjson::Validate(const std::string& aStr) {
+    return Validate(aStr.data(), aStr.length());
+}
+//-----------------------------------------------------------------
+/*static*/
+pjson::ValidateResult pjson::Validate(const char* aSrc, size_t a_iSize) {
+    // One bit per open container, set for objects
+    uint64_t aStack[ValidateResult::MaxLevels / 64];
+    size_t iMaxDepth = GetMaxParseDepth();
+    if(iMaxDepth > ValidateResult::MaxLevels) {
+        iMaxDepth = ValidateResult::MaxLevels;
+    }
+    ValidateResult oResult;
+    size_t iDepth = 0;
+    size_t iPos = 0;
+    auto fnInObject = [&]() {
+        return 0 != (aStack[(iDepth - 1) / 64] & (uint64_t(1) << ((iDepth - 1) % 64)));
+    };
+    auto fnFail = [&](ValidateResult::Error aeError) {
+        oResult.eError = aeError;
+        oResult.iOffset = iPos;
+        oResult.iDepth = iDepth;
+        return oResult;
+    };
+    // Scans `"key" :` with a_iPos on the key's opening quote
+    auto fnKey = [&]() {
+        ValidateResult::Error eError = _ValidateString(aSrc, iPos, a_iSize);
+        if(ValidateResult::errNone != eError) {
+            return eError;
+        }
+        _SkipWhitespace(aSrc, iPos, a_iSize);
+        if(iPos >= a_iSize) {
+            return ValidateResult::errUnexpectedEnd;
+        }
+        if(':' != aSrc[iPos]) {
+            return ValidateResult::errUnexpectedChar;
+        }
+        ++iPos;
+        return ValidateResult::errNone;
+    };
+
+    _SkipWhitespace(aSrc, iPos, a_iSize);
+    if(iPos >= a_iSize) {
+        return fnFail(ValidateResult::errEmpty);
+    }
+    for(;;) {
+        // Expecting a value
+        _SkipWhitespace(aSrc, iPos, a_iSize);
+        if(iPos >= a_iSize) {
+            return fnFail(ValidateResult::errUnexpectedEnd);
+        }
+        ++oResult.iElements;
+        ValidateResult::Error eError = ValidateResult::errNone;
+        char aChar = aSrc[iPos];
+        switch(aChar) {
+            case '{':
+            case '[': {
+                if(iDepth >= iMaxDepth) {
+                    return fnFail(ValidateResult::errTooDeep);
+                }
+                uint64_t iBit = uint64_t(1) << (iDepth % 64);
+                if('{' == aChar) {
+                    aStack[iDepth / 64] |= iBit;
+                } else {
+                    aStack[iDepth / 64] &= ~iBit;
+                }
+                ++iDepth;
+                if(iDepth > oResult.iDepth) {
+                    oResult.iDepth = iDepth;
+                }
+                ++iPos;
+                _SkipWhitespace(aSrc, iPos, a_iSize);
+                if(iPos >= a_iSize) {
+                    return fnFail(ValidateResult::errUnexpectedEnd);
+                }
+                if(('{' == aChar ? '}' : ']') == aSrc[iPos]) {
+                    ++iPos;
+                    --iDepth;
+                    break; // empty container, go to the separator
+                }
+                if('{' == aChar) {
+                    if('\"' != aSrc[iPos]) {
+                        return fnFail(ValidateResult::errUnexpectedChar);
+                    }
+                    eError = fnKey();
+                    if(ValidateResult::errNone != eError) {
+                        return fnFail(eError);
+                    }
+                }
+                continue; // first member / element
+            }
+            case '\"': { eError = _ValidateString(aSrc, iPos, a_iSize); break; }
+            case 't':  { eError = _ValidateLiteral(aSrc, iPos, a_iSize, "true", 4); break; }
+            case 'f':  { eError = _ValidateLiteral(aSrc, iPos, a_iSize, "false", 5); break; }
+            case 'n':  { eError = _ValidateLiteral(aSrc, iPos, a_iSize, "null", 4); break; }
+            default: {
+                if('-' == aChar || ('0' <= aChar && '9' >= aChar)) {
+                    eError = _ValidateNumber(aSrc, iPos, a_iSize);
+                } else {
+                    eError = ValidateResult::errUnexpectedChar;
+                }
+                break;
+            }
+        }
+        if(ValidateResult::errNone != eError) {
+            return fnFail(eError);
+        }
+        // A value is complete: close containers until a separator or the end
+        for(;;) {
+            _SkipWhitespace(aSrc, iPos, a_iSize);
+            if(0 == iDepth) {
+                if(iPos < a_iSize) {
+                    return fnFail(ValidateResult::errTrailingData);
+                }
+                oResult.iOffset = iPos;
+                return oResult;
+            }
+            if(iPos >= a_iSize) {
+                return fnFail(ValidateResult::errUnexpectedEnd);
+            }
+            aChar = aSrc[iPos];
+            bool bObject = fnInObject();
+            if(',' == aChar) {
+                ++iPos;
+                if(bObject) {
+                    _SkipWhitespace(aSrc, iPos, a_iSize);
+                    if(iPos >= a_iSize) {
+                        return fnFail(ValidateResult::errUnexpectedEnd);
+                    }
+                    if('\"' != aSrc[iPos]) {
+                        return fnFail(ValidateResult::errUnexpectedChar);
+                    }
+                    eError = fnKey();
+                    if(ValidateResult::errNone != eError) {
+                        return fnFail(eError);
+                    }
+                }
+                break; // next value
+            } else if((bObject ? '}' : ']') == aChar) {
+                ++iPos;
+                --iDepth;
+            } else {
+                return fnFail(ValidateResult::errUnexpectedChar);
+            }
+        }
+    }
+}
+//-----------------------------------------------------------------
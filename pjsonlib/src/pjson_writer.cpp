@@ -0,0 +1,287 @@
+//
+// Copyright 2025 ByteDance Ltd. and/or its affiliates. All rights reserved.
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//    http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+//
+//===----------------------------------------------------------------------===//
+// Author: Praveen Babu J D
+// License: Apache 2.0
+//
+#include "pjson_writer.h"
+#include <cstring>
+using namespace ByteDance;
+
+//-----------------------------------------------------------------
+pjson::Writer::Writer(std::string& a_rBuffer, const SerializeOptions& aOptions /*= SerializeOptions()*/)
+        : _oOptions(aOptions)
+        , _pOut(&a_rBuffer)
+        , _pStream(nullptr)
+        , _iFlushSize(0)
+{
+
+}
+//-----------------------------------------------------------------
+pjson::Writer::Writer(std::ostream& a_rStream, size_t a_iFlushSize /*= 64 * 1024*/,
+                      const SerializeOptions& aOptions /*= SerializeOptions()*/)
+        : _oOptions(aOptions)
+        , _pOut(&_sOwned)
+        , _pStream(&a_rStream)
+        , _iFlushSize(a_iFlushSize)
+{
+    _sOwned.reserve(a_iFlushSize);
+}
+//-----------------------------------------------------------------
+pjson::Writer::~Writer() {
+    flush();
+}
+//-----------------------------------------------------------------
+void pjson::Writer::_beforeValue() {
+    if(_bAfterKey) {
+        _bAfterKey = false;
+        return;
+    }
+    if(!_vFrames.empty()) {
+        unsigned char& rFrame = _vFrames.back();
+        switch(_oOptions.eStyle) {
+            case SerializeOptions::styleCompact: {
+                if(rFrame & WriterFrameHasItems) {
+                    *_pOut += ',';
+                }
+                break;
+            }
+            case SerializeOptions::stylePretty: {
+                if(rFrame & WriterFrameHasItems) {
+                    *_pOut += ',';
+                }
+                pjson::_AppendNewline(*_pOut, _oOptions, _vFrames.size());
+                break;
+            }
+            default: {
+                *_pOut += (rFrame & WriterFrameHasItems) ? " , " : " ";
+                break;
+            }
+        }
+        rFrame |= WriterFrameHasItems;
+    }
+}
+//-----------------------------------------------------------------
+void pjson::Writer::_close(char aBracket) {
+    bool bHasItems = (_vFrames.back() & WriterFrameHasItems);
+    _vFrames.pop_back();
+    switch(_oOptions.eStyle) {
+        case SerializeOptions::styleCompact: {
+            break;
+        }
+        case SerializeOptions::stylePretty: {
+            if(bHasItems) {
+                pjson::_AppendNewline(*_pOut, _oOptions, _vFrames.size());
+            }
+            break;
+        }
+        default: {
+            *_pOut += ' ';
+            break;
+        }
+    }
+    *_pOut += aBracket;
+    _afterValue();
+}
+//-----------------------------------------------------------------
+void pjson::Writer::_afterValue() {
+    if(_vFrames.empty()) {
+        _bComplete = true;
+    }
+    if(_pStream && _pOut->size() >= _iFlushSize) {
+        flush();
+    }
+}
+//-----------------------------------------------------------------
+pjson::Writer& pjson::Writer::startObject() {
+    _beforeValue();
+    *_pOut += '{';
+    _vFrames.push_back(WriterFrameObject);
+    return *this;
+}
+//-----------------------------------------------------------------
+pjson::Writer& pjson::Writer::endObject() {
+    if(_vFrames.empty()) {
+        return *this;
+    }
+    _close('}');
+    return *this;
+}
+//-----------------------------------------------------------------
+pjson::Writer& pjson::Writer::startArray() {
+    _beforeValue();
+    *_pOut += '[';
+    _vFrames.push_back(0);
+    return *this;
+}
+//-----------------------------------------------------------------
+pjson::Writer& pjson::Writer::endArray() {
+    if(_vFrames.empty()) {
+        return *this;
+    }
+    _close(']');
+    return *this;
+}
+//-----------------------------------------------------------------
+pjson::Writer& pjson::Writer::key(const char* aKey) {
+    return key(aKey, strlen(aKey));
+}
+//-----------------------------------------------------------------
+pjson::Writer& pjson::Writer::key(const std::string& aKey) {
+    return key(aKey.data(), aKey.length());
+}
+//-----------------------------------------------------------------
+pjson::Writer& pjson::Writer::key(const char* aKey, size_t a_iLength) {
+    _bAfterKey = false;
+    _beforeValue();
+    pjson::_AppendString(*_pOut, aKey, a_iLength);
+    switch(_oOptions.eStyle) {
+        case SerializeOptions::styleCompact: { *_pOut += ':'; break; }
+        case SerializeOptions::stylePretty:  { *_pOut += ": "; break; }
+        default:                             { *_pOut += " : "; break; }
+    }
+    _bAfterKey = true;
+    return *this;
+}
+//-----------------------------------------------------------------
+pjson::Writer& pjson::Writer::value(const char* aValue) {
+    return value(aValue, strlen(aValue));
+}
+//-----------------------------------------------------------------
+pjson::Writer& pjson::Writer::value(const std::string& aValue) {
+    return value(aValue.data(), aValue.length());
+}
+//-----------------------------------------------------------------
+pjson::Writer& pjson::Writer::value(const char* aValue, size_t a_iLength) {
+    _beforeValue();
+    pjson::_AppendString(*_pOut, aValue, a_iLength);
+    _afterValue();
+    return *this;
+}
+//-----------------------------------------------------------------
+pjson::Writer& pjson::Writer::valueEscaped(const char* data, size_t length) {
+    _beforeValue();
+    *_pOut += '\"';
+    pjson::_AppendEscaped(*_pOut, data, length);
+    *_pOut += '\"';
+    _afterValue();
+    return *this;
+}
+//-----------------------------------------------------------------
+pjson::Writer& pjson::Writer::value(const int aValue) {
+    _beforeValue();
+    pjson::_AppendInt(*_pOut, aValue);
+    _afterValue();
+    return *this;
+}
+//-----------------------------------------------------------------
+pjson::Writer& pjson::Writer::value(const int64_t aValue) {
+    _beforeValue();
+    pjson::_AppendInt(*_pOut, aValue);
+    _afterValue();
+    return *this;
+}
+//-----------------------------------------------------------------
+pjson::Writer& pjson::Writer::value(const unsigned aValue) {
+    return value(static_cast<uint64_t>(aValue));
+}
+//-----------------------------------------------------------------
+pjson::Writer& pjson::Writer::value(const uint64_t aValue) {
+    _beforeValue();
+    char buf[24];
+    char* pEnd = buf + sizeof(buf);
+    char* p = pEnd;
+    uint64_t uValue = aValue;
+    do {
+        *--p = static_cast<char>('0' + (uValue % 10));
+        uValue /= 10;
+    } while(uValue);
+    _pOut->append(p, pEnd - p);
+    _afterValue();
+    return *this;
+}
+//-----------------------------------------------------------------
+pjson::Writer& pjson::Writer::value(const double aValue) {
+    _beforeValue();
+    pjson::_AppendDouble(*_pOut, aValue);
+    _afterValue();
+    return *this;
+}
+//-----------------------------------------------------------------
+pjson::Writer& pjson::Writer::value(const float aValue) {
+    _beforeValue();
+    pjson::_AppendFloat(*_pOut, aValue);
+    _afterValue();
+    return *this;
+}
+//-----------------------------------------------------------------
+pjson::Writer& pjson::Writer::value(const bool aValue) {
+    _beforeValue();
+    *_pOut += aValue ? "true" : "false";
+    _afterValue();
+    return *this;
+}
+//-----------------------------------------------------------------
+pjson::Writer& pjson::Writer::value(const pjson& aValue) {
+    _beforeValue();
+    if(SerializeOptions::styleCompact == _oOptions.eStyle || SerializeOptions::stylePretty == _oOptions.eStyle) {
+        aValue._toStringStyled(*_pOut, _oOptions, _vFrames.size());
+    } else {
+        aValue._toString(*_pOut, -1);
+    }
+    _afterValue();
+    return *this;
+}
+//-----------------------------------------------------------------
+pjson::Writer& pjson::Writer::nullValue() {
+    _beforeValue();
+    *_pOut += "null";
+    _afterValue();
+    return *this;
+}
+//-----------------------------------------------------------------
+pjson::Writer& pjson::Writer::rawValue(const char* aJson, size_t a_iLength) {
+    _beforeValue();
+    _pOut->append(aJson, a_iLength);
+    _afterValue();
+    return *this;
+}
+//-----------------------------------------------------------------
+void pjson::Writer::flush() {
+    if(_pStream && !_sOwned.empty()) {
+        _pStream->write(_sOwned.data(), _sOwned.size());
+        _sOwned.clear(); // keeps capacity
+    }
+}
+//-----------------------------------------------------------------
+void pjson::Writer::reset() {
+    _vFrames.clear();
+    _bAfterKey = false;
+    _bComplete = false;
+    _sOwned.clear();
+}
+//-----------------------------------------------------------------
+size_t pjson::Writer::depth() const {
+    return _vFrames.size();
+}
+//-----------------------------------------------------------------
+bool pjson::Writer::isComplete() const {
+    return _bComplete;
+}
+//-----------------------------------------------------------------
+const std::string& pjson::Writer::buffer() const {
+    return *_pOut;
+}
+//-----------------------------------------------------------------
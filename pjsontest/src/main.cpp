@@ -18,11 +18,50 @@
 //
 
 #include <iostream>
+#include <cstring>
 // Test Turorial :
 // 1. Include the header file
 #include "pjson.h"
+#include "pjson_bind.h"
+#include "pjson_cache.h"
+#include "pjson_columns.h"
+#include "pjson_context.h"
+#include "pjson_cpu.h"
+#include "pjson_image.h"
+#include "pjson_index.h"
+#include "pjson_projection.h"
+#include "pjson_query.h"
+#include "pjson_reformat.h"
+#include "pjson_shared.h"
+#include "pjson_stats.h"
+#include "pjson_stream.h"
+#include "pjson_trace.h"
+#include "pjson_validate.h"
+#include "pjson_writer.h"
 using namespace ByteDance;
 
+// Struct binding : maps members to JSON keys without building a pjson tree
+struct BindItem {
+  std::string name;
+  float price = 0.0f;
+};
+struct BindOrder {
+  int id = 0;
+  bool paid = false;
+  std::vector<int> qty;
+  std::vector<BindItem> items;
+};
+PJSON_BIND_BEGIN(BindItem)
+  PJSON_BIND(name)
+  PJSON_BIND(price)
+PJSON_BIND_END()
+PJSON_BIND_BEGIN(BindOrder)
+  PJSON_BIND_AS(id, "orderId")
+  PJSON_BIND(paid)
+  PJSON_BIND(qty)
+  PJSON_BIND(items)
+PJSON_BIND_END()
+
 int main() {
   // 2. Creating JSON
   pjson oJson;
@@ -366,7 +405,672 @@ int main() {
         std::cout<<std::endl<<"}";
       }
     }
-    
+
+  //Struct Binding Test
+  {
+    std::cout<<std::endl<<"----------------------------------";
+    std::cout<<std::endl<<"Struct Binding Test :"<<std::endl;
+    pjson oOrder;
+    oOrder["orderId"] = 42;
+    oOrder["paid"] = true;
+    oOrder["qty"] = std::vector<int>({1,2});
+    oOrder["items"][0]["name"] = "pen";
+    oOrder["items"][0]["price"] = 1.5f;
+    oOrder["items"][1]["name"] = "ink";
+    oOrder["items"][1]["price"] = 3.25f;
+    oOrder["ignored"]["deep"] = std::vector<const char*>({"x","y"});
+
+    BindOrder oBound;
+    bool bRead = pjsonBind<BindOrder>::FromString(oOrder.toString(), oBound);
+    if(bRead && oBound.id == 42 && oBound.items.size() == 2
+       && 0==pjsonBind<BindOrder>::ToString(oBound).compare(
+          "{ \"orderId\" : 42 , \"paid\" : true , \"qty\" : [ 1 , 2 ] , "
+          "\"items\" : [ { \"name\" : \"pen\" , \"price\" : 1.500000 } , "
+          "{ \"name\" : \"ink\" , \"price\" : 3.250000 } ] }")) {
+      std::cout<<"PASS";
+    } else {
+      std::cout<<"FAIL";
+    }
+  }
+
+  //Copy-On-Write Test
+  {
+    std::cout<<std::endl<<"----------------------------------";
+    std::cout<<std::endl<<"Copy-On-Write Test :"<<std::endl;
+    pjson oBase;
+    oBase.copyFrom(oB);
+    oBase.setCopyOnWrite(true);
+    std::string sBase = oBase.toString();
+
+    pjson oCopy = oBase; // O(1), shares the whole tree
+    oCopy["Cats"]["Cat3"] = 38;
+    oCopy["ints"] += 12;
+    if(0==oBase.toString().compare(sBase) && 38==oCopy["Cats"]["Cat3"].getInt()
+       && oBase["Cats"]["Cat1"].toString() == oCopy["Cats"]["Cat1"].toString()) {
+      std::cout<<"PASS";
+    } else {
+      std::cout<<"FAIL";
+    }
+  }
+
+  //Streaming Writer Test
+  {
+    std::cout<<std::endl<<"----------------------------------";
+    std::cout<<std::endl<<"Streaming Writer Test :"<<std::endl;
+    std::string sBuffer;
+    pjson::Writer oWriter(sBuffer);
+    oWriter.startObject()
+             .key("Cats").value(oB["Cats"])
+             .key("floats").startArray().value(1.1f).value(2.1f).endArray()
+             .key("meow2").value(true)
+           .endObject();
+
+    pjson oExpected;
+    oExpected["Cats"] = oB["Cats"];
+    oExpected["floats"] = std::vector<float>({1.1f, 2.1f});
+    oExpected["meow2"] = true;
+    std::string sCounts;
+    pjson::Writer oCounts(sCounts);
+    std::vector<int> vItems(3);
+    oCounts.startArray().value(vItems.size()).value(18446744073709551615ull).value(-5ll).value(7u).endArray();
+    bool bIntegers = "[ 3 , 18446744073709551615 , -5 , 7 ]" == sCounts;
+    if(oWriter.isComplete() && 0==sBuffer.compare(oExpected.toString()) && bIntegers) {
+      std::cout<<"PASS";
+    } else {
+      std::cout<<"FAIL";
+    }
+  }
+
+  //Diff and Patch Test
+  {
+    std::cout<<std::endl<<"----------------------------------";
+    std::cout<<std::endl<<"Diff and Patch Test :"<<std::endl;
+    pjson oOld;
+    oOld.copyFrom(oB);
+    pjson oNew;
+    oNew.copyFrom(oB);
+    oNew["Cats"]["Cat3"] = 38;
+    oNew["ints"] += 12;
+    oNew["Dogs"]["Dog1"] = "woof";
+    oNew["DogBool"] = false;
+
+    pjson* pPatch = pjson::CreatePatch(oOld, oNew);
+    pjson* pMerge = pjson::CreateMergePatch(oOld, oNew);
+    pjson oPatched = oOld;
+    pjson oMerged = oOld;
+    bool bApplied = oPatched.applyPatch(*pPatch);
+    oMerged.applyMergePatch(*pMerge);
+    // a patched document still deep-copies: edits through a held reference stay in it
+    pjson* pEdited = pjson::CreateFromString("{\"x\" : {\"in\" : {\"k\" : 1}}, \"y\" : {\"q\" : 2}}");
+    pjson* pReplace = pjson::CreateFromString("[{\"op\" : \"replace\", \"path\" : \"/y/q\", \"value\" : 3}]");
+    pEdited->applyPatch(*pReplace);
+    pjson& rInner = (*pEdited)["x"]["in"];
+    pjson oCopy = *pEdited;
+    rInner["k"] = 99;
+    bool bCopyKept = 1 == oCopy["x"]["in"]["k"].getInt() && !pEdited->isCopyOnWrite();
+    delete pReplace;
+    delete pEdited;
+    // a failing patch undoes the operations before it, with or without copy-on-write
+    pjson* pFailing = pjson::CreateFromString("[{\"op\" : \"add\", \"path\" : \"/meow3/-\", \"value\" : 1},"
+        " {\"op\" : \"remove\", \"path\" : \"/Cat2\"}, {\"op\" : \"move\", \"from\" : \"/Dog1\", \"path\" : \"/DogBool\"},"
+        " {\"op\" : \"replace\", \"path\" : \"/meow2\", \"value\" : 5}, {\"op\" : \"test\", \"path\" : \"/missing\", \"value\" : 1}]");
+    pjson oRolled = oOld;
+    pjson oRolledShared = oOld;
+    oRolledShared.setCopyOnWrite(true);
+    bool bRolledBack = !oRolled.applyPatch(*pFailing) && !oRolledShared.applyPatch(*pFailing)
+                       && oRolled == oOld && oRolledShared == oOld;
+    delete pFailing;
+    if(bApplied && bCopyKept && bRolledBack && 0==oPatched.toString().compare(oNew.toString())
+       && 0==oMerged.toString().compare(oNew.toString())) {
+      std::cout<<"PASS";
+    } else {
+      std::cout<<"FAIL";
+    }
+    delete pPatch;
+    delete pMerge;
+  }
+
+  //Parse Context Test
+  {
+    std::cout<<std::endl<<"----------------------------------";
+    std::cout<<std::endl<<"Parse Context Test :"<<std::endl;
+    std::string sSrc = oB.toString();
+    pjson::ParseContext oContext;
+    bool bSame = true;
+    for(int i = 0; i < 3; ++i) {
+      pjson* pDoc = pjson::CreateFromString(sSrc.c_str(), sSrc.length(), oContext);
+      bSame = bSame && pDoc && 0==pDoc->toString().compare(sSrc);
+      oContext.recycle(pDoc);
+    }
+    if(bSame && oContext.pooledNodes() > 0) {
+      std::cout<<"PASS";
+    } else {
+      std::cout<<"FAIL";
+    }
+  }
+
+  //Shared Document Test
+  {
+    std::cout<<std::endl<<"----------------------------------";
+    std::cout<<std::endl<<"Shared Document Test :"<<std::endl;
+    pjson::SharedDocument oShared(new pjson(oB));
+    pjson::SharedDocument::Reader oReader(oShared);
+    const pjson& rOld = oReader.get();
+    bool bReadOnly = rOld["NoSuchKey"]["x"].getType()==pjson::jsonNull
+                     && !rOld.hasKey("NoSuchKey")
+                     && rOld["Cats"]["Cat3"].getInt()==oB["Cats"]["Cat3"].getInt();
+
+    pjson* pNext = new pjson(*oShared.load());
+    (*pNext)["Cats"]["Cat3"] = 99;
+    oShared.publish(pNext);
+    if(bReadOnly && oReader.get()["Cats"]["Cat3"].getInt()==99) {
+      std::cout<<"PASS";
+    } else {
+      std::cout<<"FAIL";
+    }
+  }
+
+  //Stats Test
+  {
+    std::cout<<std::endl<<"----------------------------------";
+    std::cout<<std::endl<<"Stats Test :"<<std::endl;
+    std::string sSrc = oB.toString();
+    pjson::Stats::Reset();
+    pjson* pDoc = pjson::CreateFromString(sSrc);
+    const pjson::Stats& rStats = pjson::Stats::Current();
+    bool bCounted = rStats.iParseCalls==1 && rStats.iMaxDepth > 0
+                    && rStats.iNodes[pjson::jsonMap] > 0 && rStats.iAllocations > 0;
+    if(pDoc && (bCounted || !pjson::Stats::Enabled())) {
+      std::cout<<"PASS";
+    } else {
+      std::cout<<"FAIL";
+    }
+    delete pDoc;
+  }
+
+  //Max Depth Test
+  {
+    std::cout<<std::endl<<"----------------------------------";
+    std::cout<<std::endl<<"Max Depth Test :"<<std::endl;
+    std::string sHostile(100000, '[');
+    std::string sNested = "[[[[1]]]]";
+    pjson::ParseContext oContext;
+    oContext.setMaxDepth(3);
+    pjson* pHostile = pjson::CreateFromString(sHostile);
+    pjson* pNested = pjson::CreateFromString(sNested);
+    pjson* pLimited = pjson::CreateFromString(sNested.c_str(), sNested.length(), oContext);
+    if(nullptr == pHostile && pNested && nullptr == pLimited) {
+      std::cout<<"PASS";
+    } else {
+      std::cout<<"FAIL";
+    }
+    delete pNested;
+  }
+
+  //Serialize Options Test
+  {
+    std::cout<<std::endl<<"----------------------------------";
+    std::cout<<std::endl<<"Serialize Options Test :"<<std::endl;
+    std::string sCompact = oB.toString(pjson::SerializeOptions::Compact());
+    std::string sPretty = oB.toString(pjson::SerializeOptions::Pretty(4));
+    pjson* pFromCompact = pjson::CreateFromString(sCompact);
+    pjson* pFromPretty = pjson::CreateFromString(sPretty);
+    std::string sWriter;
+    pjson::Writer oWriter(sWriter, pjson::SerializeOptions::Compact());
+    oWriter.startObject().key("Cats").value(oB["Cats"]).endObject();
+    if(pFromCompact && pFromPretty && sCompact.length() < oB.toString().length()
+       && 0==pFromCompact->toString().compare(oB.toString())
+       && 0==pFromPretty->toString().compare(oB.toString())
+       && std::string::npos == sWriter.find(' ')) {
+      std::cout<<"PASS";
+    } else {
+      std::cout<<"FAIL";
+    }
+    delete pFromCompact;
+    delete pFromPretty;
+  }
+
+  //Lazy Numbers Test
+  {
+    std::cout<<std::endl<<"----------------------------------";
+    std::cout<<std::endl<<"Lazy Numbers Test :"<<std::endl;
+    std::string sSrc = "{\"id\":12345678901234567,\"price\":19.990000000000002}";
+    pjson::ParseContext oContext;
+    oContext.setLazyNumbers(true);
+    pjson* pDoc = pjson::CreateFromString(sSrc.c_str(), sSrc.length(), oContext);
+    if(pDoc && 0==pDoc->toString(pjson::SerializeOptions::Compact()).compare(sSrc)
+       && 12345678901234567LL == (*pDoc)["id"].getInt64()
+       && 19.990000000000002 == (*pDoc)["price"].getDouble()) {
+      std::cout<<"PASS";
+    } else {
+      std::cout<<"FAIL";
+    }
+    oContext.recycle(pDoc);
+  }
+
+  //Validate Test
+  {
+    std::cout<<std::endl<<"----------------------------------";
+    std::cout<<std::endl<<"Validate Test :"<<std::endl;
+    pjson::ValidateResult oGood = pjson::Validate(oB.toString(true));
+    pjson::ValidateResult oBad = pjson::Validate(std::string("{\"a\":[1,2,]}"));
+    if(oGood && oGood.iElements > 1 && !oBad
+       && pjson::ValidateResult::errUnexpectedChar == oBad.eError && 10 == oBad.iOffset && 2 == oBad.iDepth) {
+      std::cout<<"PASS";
+    } else {
+      std::cout<<"FAIL";
+    }
+  }
+
+  //Reformat Test
+  {
+    std::cout<<std::endl<<"----------------------------------";
+    std::cout<<std::endl<<"Reformat Test :"<<std::endl;
+    std::string sPretty = oB.toString(true);
+    std::string sMinified;
+    pjson::Reformatter oMinify(sMinified, pjson::SerializeOptions::Compact());
+    size_t iHalf = sPretty.length() / 2;
+    bool bFed = oMinify.feed(sPretty.data(), iHalf) && oMinify.feed(sPretty.data() + iHalf, sPretty.length() - iHalf);
+    if(bFed && oMinify.finish() && 0==sMinified.compare(oB.toString(pjson::SerializeOptions::Compact()))) {
+      std::cout<<"PASS";
+    } else {
+      std::cout<<"FAIL";
+    }
+  }
+
+  //Record Reader Test
+  {
+    std::cout<<std::endl<<"----------------------------------";
+    std::cout<<std::endl<<"Record Reader Test :"<<std::endl;
+    std::string sLines = oB.toString(pjson::SerializeOptions::Compact()) + "\n{\"id\":2}\n[3]\n";
+    pjson::InputStream* pSource = pjson::InputStream::FromMemory(sLines.data(), sLines.size());
+    pjson::PrefetchStream oPrefetch(*pSource, 16, 2);
+    pjson::RecordReader oReader(oPrefetch, pjson::RecordReader::modeAuto, 8);
+    size_t iRecords = 0;
+    bool bSame = true;
+    while(pjson* pRecord = oReader.next()) {
+      bSame = bSame && (0 != iRecords || 0==pRecord->toString().compare(oB.toString()));
+      ++iRecords;
+      delete pRecord;
+    }
+    if(bSame && 3 == iRecords && !oReader.failed()) {
+      std::cout<<"PASS";
+    } else {
+      std::cout<<"FAIL";
+    }
+    delete pSource;
+  }
+
+  //Equality and Hash Test
+  {
+    std::cout<<std::endl<<"----------------------------------";
+    std::cout<<std::endl<<"Equality and Hash Test :"<<std::endl;
+    pjson oCopy;
+    oCopy.copyFrom(oB);
+    bool bSame = (oCopy == oB) && (oCopy.hash() == oB.hash());
+    oCopy["Cats"] = "changed";
+    bool bChanged = (oCopy != oB) && (oCopy.hash() != oB.hash());
+    pjson oInt, oFloat;
+    oInt = 1;
+    oFloat = 1.0f;
+    // A HashCache follows edits through the path and through a kept reference
+    pjson oE, oF;
+    oE.copyFrom(oB);
+    oF.copyFrom(oB);
+    oE["state"]["count"] = 1;
+    oF["state"]["count"] = 7;
+    pjson::HashCache oHashes(1);
+    uint64_t iBefore = oHashes.hash(oE);
+    bool bKept = (iBefore == oE.hash()) && oHashes.entries() > 0;
+    oE["Cats"] = "changed";
+    oF["Cats"] = "changed";
+    bKept = bKept && (oHashes.hash(oE) == oE.hash());
+    pjson& rState = oE["state"];
+    oHashes.hash(oE);
+    rState["count"] = 7;
+    bKept = bKept && (oE == oF) && (oHashes.hash(oE) == oF.hash()) && (oE.hash() != iBefore);
+    if(bSame && bChanged && bKept && oInt != oFloat && oInt.equals(oFloat, true) && oInt.hash() == oFloat.hash()) {
+      std::cout<<"PASS";
+    } else {
+      std::cout<<"FAIL";
+    }
+  }
+
+  //Serialize Cache Test
+  {
+    std::cout<<std::endl<<"----------------------------------";
+    std::cout<<std::endl<<"Serialize Cache Test :"<<std::endl;
+    pjson oDoc;
+    oDoc.copyFrom(oB);
+    pjson::SerializeCache oCache(pjson::SerializeOptions::Pretty(), 0);
+    bool bSame = (oCache.toString(oDoc) == oDoc.toString(pjson::SerializeOptions::Pretty()));
+    size_t iEntries = oCache.entries();
+    oDoc["Cats"] = "changed";
+    oDoc["Animals"]["Count"] = 1.5f;
+    bSame = bSame && (oCache.toString(oDoc) == oDoc.toString(pjson::SerializeOptions::Pretty()));
+    // An edit through a reference kept across toString() is not missed either
+    pjson& rAnimals = oDoc["Animals"];
+    oCache.toString(oDoc);
+    rAnimals["Count"] = 2.5f;
+    bSame = bSame && (oCache.toString(oDoc) == oDoc.toString(pjson::SerializeOptions::Pretty()));
+    if(bSame && iEntries > 0) {
+      std::cout<<"PASS";
+    } else {
+      std::cout<<"FAIL";
+    }
+  }
+
+  //Projection Test
+  {
+    std::cout<<std::endl<<"----------------------------------";
+    std::cout<<std::endl<<"Projection Test :"<<std::endl;
+    const std::string sEvent = "{\"user\":{\"id\":7,\"name\":\"x\"},\"items\":[{\"price\":1,\"qty\":2},{\"price\":3}],\"blob\":[1,2,3]}";
+    pjson::Projection oFields({"user.id", "items[*].price"});
+    pjson* pEvent = pjson::CreateFromString(sEvent.c_str(), sEvent.length(), oFields);
+    if(pEvent && 0==pEvent->toString(pjson::SerializeOptions::Compact()).compare("{\"items\":[{\"price\":1},{\"price\":3}],\"user\":{\"id\":7}}")) {
+      std::cout<<"PASS";
+    } else {
+      std::cout<<"FAIL";
+    }
+    delete pEvent;
+  }
+
+  //Array Index Test
+  {
+    std::cout<<std::endl<<"----------------------------------";
+    std::cout<<std::endl<<"Array Index Test :"<<std::endl;
+    const char* aPath = "pjsontest_array.json";
+    FILE* pFile = fopen(aPath, "wb");
+    if(pFile) {
+      fputs("[ {\"id\":0}, \"one\", [2,2], {\"id\":3} ]", pFile);
+      fclose(pFile);
+    }
+    const char* aSidecar = "pjsontest_array.json.pjidx";
+    pjson::ArrayIndex* pData = pjson::ArrayIndex::Open(aPath, aSidecar);
+    pjson::ArrayIndex::Ptr pLast = pData ? pData->get(3) : pjson::ArrayIndex::Ptr();
+    bool bOk = pData && 4 == pData->size() && pLast && 3 == (*pLast)["id"].getInt();
+    delete pData;
+    // same size, rewritten right away: the sidecar no longer matches
+    pFile = fopen(aPath, "wb");
+    if(pFile) {
+      fputs("[ {\"id\":5}, 1, 2, 3, 4, {\"id\":7}   ]", pFile);
+      fclose(pFile);
+    }
+    pData = pjson::ArrayIndex::Open(aPath, aSidecar);
+    pLast = pData ? pData->get(5) : pjson::ArrayIndex::Ptr();
+    if(bOk && pData && 6 == pData->size() && pLast && 7 == (*pLast)["id"].getInt()) {
+      std::cout<<"PASS";
+    } else {
+      std::cout<<"FAIL";
+    }
+    delete pData;
+    remove(aPath);
+    remove(aSidecar);
+  }
+
+  //Prefetch Stats Test
+  {
+    std::cout<<std::endl<<"----------------------------------";
+    std::cout<<std::endl<<"Prefetch Stats Test :"<<std::endl;
+    std::string sLines;
+    for(int i = 0; i < 1000; ++i) {
+      sLines += "{\"i\":" + std::to_string(i) + "}\n";
+    }
+    pjson::InputStream* pSource = pjson::InputStream::FromMemory(sLines.data(), sLines.size());
+    size_t iRecords = 0;
+    pjson::PrefetchStream::Stats oStats;
+    {
+      pjson::PrefetchStream oPrefetch(*pSource, 1024, 3);
+      pjson::RecordReader oReader(oPrefetch);
+      while(pjson* pRecord = oReader.next()) {
+        ++iRecords;
+        delete pRecord;
+      }
+      oStats = oPrefetch.stats();
+    }
+    if(1000 == iRecords && sLines.size() == oStats.iBytes && oStats.iChunks >= sLines.size() / 4096) {
+      std::cout<<"PASS";
+    } else {
+      std::cout<<"FAIL";
+    }
+    delete pSource;
+  }
+
+  //Inline Accessors Test
+  {
+    std::cout<<std::endl<<"----------------------------------";
+    std::cout<<std::endl<<"Inline Accessors Test :"<<std::endl;
+#ifdef PJSON_INLINE
+    std::cout<<"(accessors defined in pjson_inline.h)"<<std::endl;
+#endif
+    pjson* pDoc = pjson::CreateFromString("[1, 2.5, true, \"x\", null, [3]]");
+    const pjson& rDoc = *pDoc;
+    double dSum = 0;
+    for(const pjson* pItem : *rDoc.getArray()) {
+      dSum += pItem->getDouble() + pItem->getInt() + pItem->getBool();
+    }
+    // 1+1+1, 2.5+2+1, 0+0+1, 0+0+1, 0, 0
+    if(10.5 == dSum && 3 == rDoc[5][0].getInt() && pjson::jsonNull == rDoc[9].getType()) {
+      std::cout<<"PASS";
+    } else {
+      std::cout<<"FAIL";
+    }
+    delete pDoc;
+  }
+
+  //CPU Dispatch Test
+  {
+    std::cout<<std::endl<<"----------------------------------";
+    std::cout<<std::endl<<"CPU Dispatch Test :"<<std::endl;
+    std::string sText;
+    for(int i = 0; i < 20; ++i) {
+      sText += "plain text long enough for the wide kernels / \"quoted\"\t\xC3\xA9\xE2\x82\xAC ";
+    }
+    const std::string sDoc = "{\"text\" : \"" + pjson::EncodeForJSON(sText.data(), sText.size()) + "\",\n    \"utf8\" : \"\xE2\x82\xAC\xF0\x9F\x98\x80\"}";
+    const std::string sBroken = "[\"0123456789012345678901234567890123456789\xED\xA0\x80\"]"; // surrogate
+    std::string sExpected;
+    bool bSame = true;
+    const pjson::Cpu::Level eBefore = pjson::Cpu::Active();
+    for(int i = pjson::Cpu::levelScalar; i <= pjson::Cpu::levelNEON; ++i) {
+      pjson::Cpu::Level eLevel = static_cast<pjson::Cpu::Level>(i);
+      if(!pjson::Cpu::IsSupported(eLevel)) {
+        continue;
+      }
+      pjson::Cpu::SetLevel(eLevel);
+      std::cout<<pjson::Cpu::Name(eLevel)<<" ";
+      pjson* pDoc = pjson::CreateFromString(sDoc);
+      std::string sResult = pjson::EncodeForJSON(sText.data(), sText.size())
+                          + pjson::EncodeBase64ForJSON(sText.data(), sText.size())
+                          + (pDoc ? pDoc->toString() : "")
+                          + (pjson::Validate(sDoc) ? "valid" : "invalid")
+                          + pjson::ValidateResult::ErrorName(pjson::Validate(sBroken).eError);
+      bSame = bSame && (sExpected.empty() || sExpected == sResult)
+                    && sText == pjson::DecodeBase64FromJSON(pjson::EncodeBase64ForJSON(sText.data(), sText.size()));
+      sExpected = sResult;
+      delete pDoc;
+    }
+    pjson::Cpu::SetLevel(eBefore);
+    std::cout<<"(active: "<<pjson::Cpu::Name(pjson::Cpu::Active())<<")"<<std::endl;
+    if(bSame && pjson::Validate(sDoc) && pjson::ValidateResult::errInvalidUtf8 == pjson::Validate(sBroken).eError) {
+      std::cout<<"PASS";
+    } else {
+      std::cout<<"FAIL";
+    }
+  }
+
+  //Trace Test
+  {
+    std::cout<<std::endl<<"----------------------------------";
+    std::cout<<std::endl<<"Trace Test :"<<std::endl;
+    struct SpanLog : public pjson::Trace::Listener {
+      std::vector<pjson::Trace::Span> vSpans;
+      void onEnd(const pjson::Trace::Span& aSpan) override { vSpans.push_back(aSpan); }
+    } oLog;
+    pjson::Trace::SetListener(&oLog);
+    const std::string sSrc = "{\"id\" : 7, \"tags\" : [\"a\", \"b\"]}";
+    pjson* pDoc = pjson::CreateFromString(sSrc);
+    std::string sOut = pDoc ? pDoc->toString() : "";
+    delete pDoc;
+    pjson::Trace::SetListener(nullptr);
+    for(const pjson::Trace::Span& rSpan : oLog.vSpans) {
+      std::cout<<pjson::Trace::Name(rSpan.eEvent)<<" "<<rSpan.iBytes<<" bytes, "<<rSpan.iNodes<<" nodes, "<<rSpan.iNanos<<" ns"<<std::endl;
+    }
+    bool bTraced = 2 == oLog.vSpans.size()
+                   && pjson::Trace::eventParse == oLog.vSpans[0].eEvent && sSrc.size() == oLog.vSpans[0].iBytes && 5 == oLog.vSpans[0].iNodes
+                   && pjson::Trace::eventSerialize == oLog.vSpans[1].eEvent && sOut.size() == oLog.vSpans[1].iBytes;
+    if(!pjson::Trace::Enabled()) {
+      std::cout<<"(built without PJSON_ENABLE_TRACE)"<<std::endl;
+    }
+    if(pjson::Trace::Enabled() ? bTraced : oLog.vSpans.empty()) {
+      std::cout<<"PASS";
+    } else {
+      std::cout<<"FAIL";
+    }
+  }
+
+  //Image Test
+  {
+    std::cout<<std::endl<<"----------------------------------";
+    std::cout<<std::endl<<"Image Test :"<<std::endl;
+    const std::string sSrc = "{\"items\" : [{\"id\" : 1, \"name\" : \"pen\", \"price\" : 1.5}, {\"id\" : 2, \"name\" : \"ink\", \"tags\" : [\"a\", \"b\"]}], \"version\" : 3}";
+    pjson* pDoc = pjson::CreateFromString(sSrc);
+    std::string sImage;
+    pjson::Image::Create(*pDoc, sImage);
+    pjson::Image* pImage = pjson::Image::FromBuffer(sImage.data(), sImage.size());
+    pjson::Image::View oRoot = pImage->root();
+    pjson::Image::View oItem = oRoot["items"][1];
+    std::cout<<"image "<<pImage->size()<<" bytes, items[1].name = "<<oItem["name"].getString()<<std::endl;
+    pjson* pCopy = oRoot.toPjson();
+    bool bRead = 3 == oRoot["version"].getInt() && 1.5f == oRoot["items"][0]["price"].getFloat()
+                 && "b" == oItem["tags"][1].getString() && 2 == oRoot["items"].size()
+                 && oRoot["missing"].isNull() && oRoot["items"][5].isNull();
+    // Corrupt the elements of [1,2,3,4] to point back at their own array
+    pjson* pFour = pjson::CreateFromString("[1,2,3,4]");
+    std::string sLoop;
+    pjson::Image::Create(*pFour, sLoop);
+    uint32_t iArrayType = 0;
+    uint64_t iRecord = 0;
+    memcpy(&iArrayType, &sLoop[24], sizeof(iArrayType)); // the root slot follows magic, version, byte order and size
+    memcpy(&iRecord, &sLoop[32], sizeof(iRecord));
+    for(size_t i = 0; i < 4; ++i) {
+      memcpy(&sLoop[iRecord + 8 + i * 16], &iArrayType, sizeof(iArrayType));
+      memcpy(&sLoop[iRecord + 8 + i * 16 + 8], &iRecord, sizeof(iRecord));
+    }
+    pjson::Image* pLoop = pjson::Image::FromBuffer(sLoop.data(), sLoop.size());
+    pjson* pLooped = pLoop ? pLoop->root().toPjson() : nullptr;
+    bool bStopped = pLooped && pjson::jsonNull == pLooped->getType();
+    delete pLooped;
+    delete pLoop;
+    delete pFour;
+    if(bRead && bStopped && pCopy->toString() == pDoc->toString()) {
+      std::cout<<"PASS";
+    } else {
+      std::cout<<"FAIL";
+    }
+    delete pCopy;
+    delete pImage;
+    delete pDoc;
+  }
+
+  //Query Test
+  {
+    std::cout<<std::endl<<"----------------------------------";
+    std::cout<<std::endl<<"Query Test :"<<std::endl;
+    const std::string sSrc = "{\"items\" : [{\"id\" : 1, \"price\" : 8.5, \"tags\" : [\"sale\"]}, {\"id\" : 2, \"price\" : 20}, {\"id\" : 3, \"price\" : 4, \"tags\" : [\"sale\", \"new\"]}]}";
+    pjson* pDoc = pjson::CreateFromString(sSrc);
+    pjson::Query oCheap("$.items[?@.price < 10 && @.tags[0] == 'sale'].id");
+    std::vector<const pjson*> vTree;
+    oCheap.select(*pDoc, vTree);
+    std::vector<pjson*> vText;
+    bool bText = oCheap.select(sSrc.data(), sSrc.size(), vText);
+    std::cout<<oCheap.path()<<" -> "<<vTree.size()<<" results"<<std::endl;
+    pjson::Query oBad("$.items[?@.price <]");
+    bool bFound = 2 == vTree.size() && 1 == vTree[0]->getInt() && 3 == vTree[1]->getInt()
+                  && bText && 2 == vText.size() && 1 == vText[0]->getInt() && 3 == vText[1]->getInt();
+    // match() / search() on a 100 KB string
+    std::string sLong = "[{\"s\" : \"";
+    for(int i = 0; i < 50000; ++i) {
+      sLong += "ab";
+    }
+    sLong += "\"}]";
+    pjson* pLong = pjson::CreateFromString(sLong);
+    pjson::Query oMatch("$[?match(@.s, '(a|b)*')]");
+    pjson::Query oSearch("$[?search(@.s, 'a*c')]");
+    std::vector<const pjson*> vMatched, vSearched;
+    oMatch.select(*pLong, vMatched);
+    oSearch.select(*pLong, vSearched);
+    std::vector<pjson::Query::Span> vSpans;
+    bool bLong = 1 == vMatched.size() && vSearched.empty()
+                 && oMatch.selectSpans(sLong.data(), sLong.size(), vSpans) && 1 == vSpans.size();
+    delete pLong;
+    if(bFound && bLong && !oBad.valid() && !oBad.error().empty()) {
+      std::cout<<"PASS";
+    } else {
+      std::cout<<"FAIL";
+    }
+    for(pjson* pResult : vText) {
+      delete pResult;
+    }
+    delete pDoc;
+  }
+
+  //Columns Test
+  {
+    std::cout<<std::endl<<"----------------------------------";
+    std::cout<<std::endl<<"Columns Test :"<<std::endl;
+    const std::string sSrc = "{\"id\" : 1, \"user\" : {\"name\" : \"ann\"}, \"score\" : 0.5, \"ok\" : true}\n"
+                             "{\"id\" : 2, \"score\" : \"n/a\", \"ok\" : tx}\n"
+                             "{\"id\" : 3, \"user\" : {\"name\" : \"bob\"}, \"score\" : 2, \"ok\" : False}\n";
+    pjson::ColumnReader oColumns;
+    oColumns.add("id", pjson::ColumnReader::typeInt32);
+    oColumns.add("user.name", pjson::ColumnReader::typeString);
+    oColumns.add("score", pjson::ColumnReader::typeFloat);
+    oColumns.add("ok", pjson::ColumnReader::typeBool);
+    pjson::InputStream* pInput = pjson::InputStream::FromMemory(sSrc.data(), sSrc.size());
+    pjson::RecordReader oReader(*pInput);
+    bool bRead = oColumns.read(oReader);
+    const pjson::ColumnReader::Column& rScore = oColumns.column(2);
+    std::cout<<oColumns.rows()<<" rows, "<<rScore.nulls()<<" null score"<<std::endl;
+    bool bValues = 3 == oColumns.rows() && 3 == oColumns.column(0).int32s()[2] && "bob" == oColumns.column(1).getString(2)
+                   && oColumns.column(1).isNull(1) && 0.5f == rScore.floats()[0] && rScore.isNull(1) && 2.0f == rScore.floats()[2];
+    const pjson::ColumnReader::Column& rOk = oColumns.column(3);
+    bValues = bValues && 1 == rOk.bools()[0] && rOk.isNull(1) && 0 == rOk.bools()[2];
+    // several workers must give the same columns as one
+    std::string sMany;
+    for(int i = 0; i < 5000; ++i) {
+      sMany += "{\"id\" : " + std::to_string(i);
+      if(i % 7) {
+        sMany += ", \"user\" : {\"name\" : \"user" + std::to_string(i * 31) + "\"}";
+      }
+      sMany += ", \"ok\" : " + std::string((i % 3) ? "true" : "false") + "}\n";
+    }
+    pjson::ColumnReader oOne, oFour;
+    for(pjson::ColumnReader* pColumns : {&oOne, &oFour}) {
+      pColumns->add("id", pjson::ColumnReader::typeInt64);
+      pColumns->add("user.name", pjson::ColumnReader::typeString);
+      pColumns->add("ok", pjson::ColumnReader::typeBool);
+      pjson::InputStream* pMany = pjson::InputStream::FromMemory(sMany.data(), sMany.size());
+      pjson::RecordReader oManyReader(*pMany);
+      bRead = pColumns->read(oManyReader, (&oOne == pColumns) ? 1 : 4) && bRead;
+      delete pMany;
+    }
+    bool bSame = 5000 == oOne.rows() && oOne.rows() == oFour.rows();
+    for(size_t i = 0; bSame && i < oOne.rows(); ++i) {
+      bSame = oOne.column(0).int64s()[i] == oFour.column(0).int64s()[i]
+              && oOne.column(1).isNull(i) == oFour.column(1).isNull(i)
+              && oOne.column(1).getString(i) == oFour.column(1).getString(i)
+              && oOne.column(2).bools()[i] == oFour.column(2).bools()[i];
+    }
+    bSame = bSame && "user62" == oFour.column(1).getString(2) && oFour.column(1).isNull(4998);
+    std::cout<<oFour.rows()<<" rows with 4 threads, "<<oFour.column(1).nulls()<<" null names"<<std::endl;
+    if(bRead && bValues && bSame) {
+      std::cout<<"PASS";
+    } else {
+      std::cout<<"FAIL";
+    }
+    delete pInput;
+  }
+
   std::cout<<std::endl;
   return 0;
 }
\ No newline at end of file